@@ -353,7 +353,7 @@ TEST_P(
     GivenMultipleImmediateCommandListsThatHaveDependenciesThenAllTheCommandListsExecuteSuccessfully) {
 
   // create 2 images
-  lzt::ImagePNG32Bit input("test_input.png");
+  lzt::ImagePNG32Bit input = *lzt::read_png_image_cached("test_input.png");
   int width = input.width();
   int height = input.height();
   lzt::ImagePNG32Bit output(width, height);
@@ -161,7 +161,7 @@ TEST_F(
     GivenImageCopyThatSignalsEventWhenCompleteWhenExecutingCommandListThenHostAndGpuReadEventCorrectly) {
 
   // create 2 images
-  lzt::ImagePNG32Bit input("test_input.png");
+  lzt::ImagePNG32Bit input = *lzt::read_png_image_cached("test_input.png");
   int width = input.width();
   int height = input.height();
   lzt::ImagePNG32Bit output(width, height);
@@ -10,36 +10,95 @@ typedef unsigned long uint64_t;
 typedef unsigned uint32_t;
 typedef unsigned short uint16_t;
 
+/*
+ * The pattern for element i is ((uint32_t)i << 16) + pattern_base, computed
+ * in 32 bits to match the host side checks. Both kernels walk the buffer with
+ * a grid-stride loop over ulong4 vectors, so the host can size the dispatch
+ * to the device instead of to the buffer, followed by a scalar loop for the
+ * elements that do not fill a whole vector.
+ */
+inline uint4 pattern_vector(size_t v, const uint16_t pattern_base) {
+  uint4 index = (uint4)((uint32_t)(v * 4)) + (uint4)(0, 1, 2, 3);
+  return (index << (sizeof(uint16_t) * 8)) + (uint4)(pattern_base);
+}
+
+inline uint64_t pattern_value(size_t i, const uint16_t pattern_base) {
+  return (uint32_t)(((uint32_t)i << (sizeof(uint16_t) * 8)) + pattern_base);
+}
+
 kernel void fill_device_memory(__global uint64_t *pattern_memory,
-                               const size_t pattern_memory_count,
+                               const uint64_t pattern_memory_count,
                                const uint16_t pattern_base) {
-  uint32_t i;
+  const size_t stride = get_global_size(0);
+  const size_t vector_count = pattern_memory_count / 4;
+  size_t i;
 
   /* fill memory with pattern */
-  for (i = 0; i < pattern_memory_count; i++)
-    pattern_memory[i] = (i << (sizeof(uint16_t) * 8)) + pattern_base;
+  for (i = get_global_id(0); i < vector_count; i += stride)
+    vstore4(convert_ulong4(pattern_vector(i, pattern_base)), i,
+            pattern_memory);
+
+  for (i = vector_count * 4 + get_global_id(0); i < pattern_memory_count;
+       i += stride)
+    pattern_memory[i] = pattern_value(i, pattern_base);
+}
+
+/*
+ * Record one difference: every mismatch bumps the counter, only the first
+ * output_count of them are logged to the output buffers.
+ */
+inline void record_mismatch(__global uint64_t *expected_output,
+                            __global uint64_t *found_output,
+                            const uint64_t output_count,
+                            volatile __global uint32_t *mismatch_count,
+                            uint64_t expected, uint64_t found) {
+  uint32_t slot = atomic_inc(mismatch_count);
+  if (slot < output_count) {
+    expected_output[slot] = expected;
+    found_output[slot] = found;
+  }
 }
 
 /*
  * Verify pattern buffer against expected pattern.
  * In case of unexpected differences, use output buffers to record
- * some of those differences.
+ * some of those differences and mismatch_count to count all of them.
  */
 kernel void test_device_memory(__global uint64_t *pattern_memory,
-                               const size_t pattern_memory_count,
+                               const uint64_t pattern_memory_count,
                                const uint16_t pattern_base,
                                __global uint64_t *expected_output,
                                __global uint64_t *found_output,
-                               const size_t output_count) {
-  uint32_t i, j;
-
-  j = 0;
-  for (i = 0; i < pattern_memory_count; i++) {
-    if (pattern_memory[i] != (i << (sizeof(uint16_t) * 8)) + pattern_base) {
-      if (j++ < output_count) {
-        expected_output[j] = (i << (sizeof(uint16_t) * 8)) + pattern_base;
-        found_output[j] = pattern_memory[i];
-      }
+                               const uint64_t output_count,
+                               volatile __global uint32_t *mismatch_count) {
+  const size_t stride = get_global_size(0);
+  const size_t vector_count = pattern_memory_count / 4;
+  size_t i;
+
+  for (i = get_global_id(0); i < vector_count; i += stride) {
+    ulong4 expected = convert_ulong4(pattern_vector(i, pattern_base));
+    ulong4 found = vload4(i, pattern_memory);
+    if (any(expected != found)) {
+      if (expected.s0 != found.s0)
+        record_mismatch(expected_output, found_output, output_count,
+                        mismatch_count, expected.s0, found.s0);
+      if (expected.s1 != found.s1)
+        record_mismatch(expected_output, found_output, output_count,
+                        mismatch_count, expected.s1, found.s1);
+      if (expected.s2 != found.s2)
+        record_mismatch(expected_output, found_output, output_count,
+                        mismatch_count, expected.s2, found.s2);
+      if (expected.s3 != found.s3)
+        record_mismatch(expected_output, found_output, output_count,
+                        mismatch_count, expected.s3, found.s3);
     }
   }
+
+  for (i = vector_count * 4 + get_global_id(0); i < pattern_memory_count;
+       i += stride) {
+    uint64_t expected = pattern_value(i, pattern_base);
+    if (pattern_memory[i] != expected)
+      record_mismatch(expected_output, found_output, output_count,
+                      mismatch_count, expected, pattern_memory[i]);
+  }
 }
@@ -17,6 +17,8 @@ namespace lzt = level_zero_tests;
 
 #include <level_zero/ze_api.h>
 
+#include <algorithm>
+
 namespace {
 
 class zeDriverMemoryOvercommitTests
@@ -44,6 +46,26 @@ protected:
     return module;
   }
 
+  /* Number of hardware threads the device can keep resident at once */
+  uint32_t device_hardware_threads(const ze_device_handle_t device) {
+    ze_device_properties_t properties = lzt::get_device_properties(device);
+    uint32_t threads = properties.numSlices * properties.numSubslicesPerSlice *
+                       properties.numEUsPerSubslice *
+                       properties.numThreadsPerEU;
+    return threads ? threads : 1;
+  }
+
+  /*
+   * Enough groups to cover work_items, capped at one group per hardware
+   * thread: the kernels loop over whatever the grid does not cover.
+   */
+  uint32_t occupancy_group_count(size_t work_items, uint32_t group_size,
+                                 uint32_t hardware_threads) {
+    size_t groups = (work_items + group_size - 1) / group_size;
+    groups = std::min<size_t>(groups, hardware_threads);
+    return groups ? static_cast<uint32_t>(groups) : 1;
+  }
+
   void run_functions(const ze_device_handle_t device, ze_module_handle_t module,
                      void *pattern_memory, size_t pattern_memory_count,
                      uint16_t sub_pattern,
@@ -62,7 +84,14 @@ protected:
         ZE_RESULT_SUCCESS,
         zeKernelCreate(module, &fill_function_description, &fill_function));
 
-    EXPECT_EQ(ZE_RESULT_SUCCESS, zeKernelSetGroupSize(fill_function, 1, 1, 1));
+    // size the dispatch to the device rather than to the buffer, the kernels
+    // grid-stride over the pattern memory
+    uint32_t group_size_x, group_size_y, group_size_z;
+    uint32_t hardware_threads = device_hardware_threads(device);
+    lzt::suggest_group_size(fill_function, hardware_threads, 1, 1,
+                            group_size_x, group_size_y, group_size_z);
+    EXPECT_EQ(ZE_RESULT_SUCCESS,
+              zeKernelSetGroupSize(fill_function, group_size_x, 1, 1));
 
     EXPECT_EQ(ZE_RESULT_SUCCESS,
               zeKernelSetArgumentValue(fill_function, 0, sizeof(pattern_memory),
@@ -87,7 +116,8 @@ protected:
         ZE_RESULT_SUCCESS,
         zeKernelCreate(module, &test_function_description, &test_function));
 
-    EXPECT_EQ(ZE_RESULT_SUCCESS, zeKernelSetGroupSize(test_function, 1, 1, 1));
+    EXPECT_EQ(ZE_RESULT_SUCCESS,
+              zeKernelSetGroupSize(test_function, group_size_x, 1, 1));
 
     EXPECT_EQ(ZE_RESULT_SUCCESS,
               zeKernelSetArgumentValue(test_function, 0, sizeof(pattern_memory),
@@ -112,6 +142,16 @@ protected:
               zeKernelSetArgumentValue(test_function, 5, sizeof(output_count),
                                        &output_count));
 
+    uint32_t *mismatch_count = static_cast<uint32_t *>(
+        lzt::allocate_shared_memory(sizeof(uint32_t), sizeof(uint32_t),
+                                    ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT,
+                                    ZE_HOST_MEM_ALLOC_FLAG_DEFAULT, device));
+    *mismatch_count = 0;
+    EXPECT_EQ(ZE_RESULT_SUCCESS,
+              zeKernelSetArgumentValue(test_function, 6,
+                                       sizeof(mismatch_count),
+                                       &mismatch_count));
+
     ze_command_list_desc_t command_list_description = {};
     command_list_description.version = ZE_COMMAND_LIST_DESC_VERSION_CURRENT;
 
@@ -120,7 +160,12 @@ protected:
         ZE_RESULT_SUCCESS,
         zeCommandListCreate(device, &command_list_description, &command_list));
 
-    ze_group_count_t thread_group_dimensions = {1, 1, 1};
+    ze_group_count_t thread_group_dimensions = {
+        occupancy_group_count(pattern_memory_count / 4, group_size_x,
+                              hardware_threads),
+        1, 1};
+    LOG_INFO << "group size " << group_size_x << " group count "
+             << thread_group_dimensions.groupCountX;
 
     lzt::append_memory_copy(command_list, gpu_expected_output_buffer,
                             host_expected_output_buffer,
@@ -175,6 +220,10 @@ protected:
     EXPECT_EQ(ZE_RESULT_SUCCESS,
               zeCommandQueueSynchronize(command_queue, UINT32_MAX));
 
+    LOG_INFO << "mismatch count " << *mismatch_count;
+    EXPECT_EQ(0u, *mismatch_count);
+    lzt::free_memory(mismatch_count);
+
     lzt::destroy_command_queue(command_queue);
     lzt::destroy_command_list(command_list);
     EXPECT_EQ(ZE_RESULT_SUCCESS, zeKernelDestroy(fill_function));
@@ -54,7 +54,7 @@ protected:
       return;
     }
 
-    input_png = lzt::ImagePNG32Bit("test_input.png");
+    input_png = *lzt::read_png_image_cached("test_input.png");
     img_width = input_png.width();
     img_height = input_png.height();
     output_png = lzt::ImagePNG32Bit(img_width, img_height);
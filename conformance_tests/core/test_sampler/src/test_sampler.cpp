@@ -76,8 +76,9 @@ TEST(zeSamplerTests,
   lzt::destroy_sampler(sampler);
 }
 
-static ze_image_handle_t create_sampler_image(lzt::ImagePNG32Bit png_image,
-                                              int height, int width) {
+static ze_image_handle_t
+create_sampler_image(const lzt::ImagePNG32Bit &png_image, int height,
+                     int width) {
   ze_image_desc_t image_description;
   image_description.format.layout = ZE_IMAGE_FORMAT_LAYOUT_32;
   image_description.version = ZE_IMAGE_DESC_VERSION_CURRENT;
@@ -98,7 +99,8 @@ static ze_image_handle_t create_sampler_image(lzt::ImagePNG32Bit png_image,
   return image;
 }
 
-static ze_image_handle_t create_sampler_image(lzt::ImagePNG32Bit png_image) {
+static ze_image_handle_t
+create_sampler_image(const lzt::ImagePNG32Bit &png_image) {
   return create_sampler_image(png_image, png_image.height(), png_image.width());
 }
 
@@ -107,11 +109,12 @@ TEST_P(
     zeDeviceExecuteSamplerTests,
     GivenSamplerWhenPassingAsFunctionArgumentThenOutputMatchesInKernelSampler) {
 
-  lzt::ImagePNG32Bit input("test_input.png");
+  auto input_png = lzt::read_png_image_cached("test_input.png");
+  const lzt::ImagePNG32Bit &input = *input_png;
   int output_width = input.width() / 2;
   int output_height = input.height() / 2;
-  lzt::ImagePNG32Bit output_inhost(output_width, output_height);
-  lzt::ImagePNG32Bit output_inkernel(output_width, output_height);
+  auto output_inhost = lzt::create_host_image(output_width, output_height);
+  auto output_inkernel = lzt::create_host_image(output_width, output_height);
   std::string module_name = "sampler.spv";
   ze_module_handle_t module = lzt::create_module(
       lzt::zeDevice::get_instance()->get_device(), module_name);
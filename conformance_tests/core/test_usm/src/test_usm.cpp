@@ -15,6 +15,8 @@
 namespace lzt = level_zero_tests;
 #include <level_zero/ze_api.h>
 
+#include <algorithm>
+
 namespace {
 
 class zeDriverMemoryMigrationPageFaultTestsMultiDevice
@@ -22,6 +24,26 @@ class zeDriverMemoryMigrationPageFaultTestsMultiDevice
       public ::testing::WithParamInterface<
           std::tuple<uint32_t, uint32_t, bool>> {
 protected:
+  /* Number of hardware threads the device can keep resident at once */
+  uint32_t device_hardware_threads(const ze_device_handle_t device) {
+    ze_device_properties_t properties = lzt::get_device_properties(device);
+    uint32_t threads = properties.numSlices * properties.numSubslicesPerSlice *
+                       properties.numEUsPerSubslice *
+                       properties.numThreadsPerEU;
+    return threads ? threads : 1;
+  }
+
+  /*
+   * Enough groups to cover work_items, capped at one group per hardware
+   * thread: the kernels loop over whatever the grid does not cover.
+   */
+  uint32_t occupancy_group_count(size_t work_items, uint32_t group_size,
+                                 uint32_t hardware_threads) {
+    size_t groups = (work_items + group_size - 1) / group_size;
+    groups = std::min<size_t>(groups, hardware_threads);
+    return groups ? static_cast<uint32_t>(groups) : 1;
+  }
+
   void run_functions(const ze_device_handle_t device, ze_module_handle_t module,
                      void *pattern_memory, size_t pattern_memory_count,
                      uint16_t sub_pattern,
@@ -35,11 +57,12 @@ protected:
         lzt::create_function(module, flag, "fill_device_memory");
 
     // set the thread group size to make sure all the device threads are
-    // occupied
+    // occupied, the kernels grid-stride over whatever the grid does not cover
     uint32_t groupSizeX, groupSizeY, groupSizeZ;
     size_t groupSize;
-    lzt::suggest_group_size(fill_function, pattern_memory_count, 1, 1,
-                            groupSizeX, groupSizeY, groupSizeZ);
+    uint32_t hardware_threads = device_hardware_threads(device);
+    lzt::suggest_group_size(fill_function, hardware_threads, 1, 1, groupSizeX,
+                            groupSizeY, groupSizeZ);
 
     groupSize = groupSizeX * groupSizeY * groupSizeZ;
     LOG_DEBUG << "thread group size X is ::" << groupSizeX;
@@ -81,13 +104,18 @@ protected:
     lzt::set_argument_value(test_function, 5, sizeof(output_count),
                             &output_count);
 
+    uint32_t *mismatch_count = static_cast<uint32_t *>(
+        lzt::allocate_shared_memory(sizeof(uint32_t), sizeof(uint32_t),
+                                    ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT,
+                                    ZE_HOST_MEM_ALLOC_FLAG_DEFAULT, device));
+    *mismatch_count = 0;
+    lzt::set_argument_value(test_function, 6, sizeof(mismatch_count),
+                            &mismatch_count);
+
     ze_command_list_handle_t command_list = lzt::create_command_list(device);
 
-    // if groupSize is greater then memory count, then at least one thread group
-    // should be dispatched
-    uint32_t threadGroup = pattern_memory_count / groupSize > 1
-                               ? pattern_memory_count / groupSize
-                               : 1;
+    uint32_t threadGroup = occupancy_group_count(
+        pattern_memory_count / 4, groupSizeX, hardware_threads);
     LOG_DEBUG << "thread group dimension is ::" << threadGroup;
     ze_group_count_t thread_group_dimensions = {threadGroup, 1, 1};
 
@@ -128,6 +156,10 @@ protected:
 
     lzt::synchronize(command_queue, UINT32_MAX);
 
+    LOG_DEBUG << "mismatch count is ::" << *mismatch_count;
+    EXPECT_EQ(0u, *mismatch_count);
+    lzt::free_memory(mismatch_count);
+
     lzt::destroy_command_queue(command_queue);
     lzt::destroy_command_list(command_list);
     lzt::destroy_function(fill_function);
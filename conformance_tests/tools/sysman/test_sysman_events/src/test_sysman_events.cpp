@@ -14,19 +14,11 @@
 
 namespace lzt = level_zero_tests;
 
-#include <thread>
 #include <level_zero/ze_api.h>
 #include <level_zero/zet_api.h>
 
 namespace {
 
-void child_thread_function(ze_device_handle_t device) {
-  // Ensure that before actually resetting the device, we have started to listen
-  // to events. so sleep for some time and then do reset
-  std::this_thread::sleep_for(std::chrono::milliseconds(30));
-  lzt::sysman_device_reset(device);
-}
-
 class EventsTest : public lzt::SysmanCtsClass {
 public:
   ze_driver_handle_t hDriver;
@@ -120,15 +112,16 @@ TEST_F(
     eventConfig.registered = ZET_SYSMAN_EVENT_TYPE_DEVICE_RESET;
     lzt::set_event_config(hEvent, eventConfig);
 
-    std::thread child_thread(child_thread_function, device);
-    // If we registered to receive events on any devices, start listening now
-    uint32_t events;
+    // The reset event is latched once registered, so the device can be reset
+    // as soon as the waiter has been started
     LOG_INFO << "Listening for Device Reset events ...";
-    ASSERT_EQ(ZE_RESULT_SUCCESS,
-              lzt::listen_event(hDriver, ZET_EVENT_WAIT_INFINITE, 1, &hEvent,
-                                &events));
+    auto reset_event =
+        lzt::wait_for_events_async(hDriver, hEvent,
+                                   ZET_SYSMAN_EVENT_TYPE_DEVICE_RESET,
+                                   ZET_EVENT_WAIT_INFINITE);
+    lzt::sysman_device_reset(device);
 
-    ASSERT_EQ(ZE_RESULT_SUCCESS, lzt::get_event_state(hEvent, true, events));
+    uint32_t events = reset_event.get();
     if (events & ZET_SYSMAN_EVENT_TYPE_DEVICE_RESET) {
       LOG_INFO << "Event received as device got reset";
     } else {
@@ -0,0 +1,66 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_POWER_MONITOR_HPP_
+#define _ZE_POWER_MONITOR_HPP_
+
+#include <level_zero/ze_api.h>
+#include <level_zero/zet_api.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Power and frequency state recorded over one measured interval.
+ * Energy is read from the first sysman power domain of the device, frequency
+ * and throttle information is gathered from every frequency domain.
+ */
+struct PowerSample {
+  bool power_available = false;
+  bool frequency_available = false;
+  long double elapsed_sec = 0;
+  long double energy_joules = 0;
+  long double average_power_watts = 0;
+  double start_frequency_mhz = 0;
+  double end_frequency_mhz = 0;
+  uint64_t throttle_time_usec = 0;
+  bool throttled = false;
+  bool clocks_dropped = false;
+
+  /* Results measured while clocks dropped are not trustworthy */
+  bool is_valid() const { return !clocks_dropped; }
+  void merge(const PowerSample &other);
+  std::string to_string(long double rate, const std::string &unit) const;
+};
+
+class ZePowerMonitor {
+public:
+  ZePowerMonitor(ze_device_handle_t device);
+
+  bool is_supported() const;
+  void start();
+  PowerSample stop();
+
+private:
+  struct FrequencySnapshot {
+    double actual;
+    uint32_t throttle_reasons;
+    uint64_t throttle_time;
+  };
+
+  std::vector<FrequencySnapshot> read_frequency_domains();
+
+  zet_sysman_handle_t sysman = nullptr;
+  std::vector<zet_sysman_pwr_handle_t> power_handles;
+  std::vector<zet_sysman_freq_handle_t> freq_handles;
+  zet_power_energy_counter_t start_energy = {};
+  std::vector<FrequencySnapshot> start_frequency;
+};
+
+#endif /* _ZE_POWER_MONITOR_HPP_ */
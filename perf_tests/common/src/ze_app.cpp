@@ -9,6 +9,7 @@
 #include "ze_app.hpp"
 
 #include "common.hpp"
+#include "usm_pool/usm_pool.hpp"
 
 #include <assert.h>
 
@@ -88,6 +89,16 @@ void ZeApp::memoryAlloc(size_t size, void **ptr) {
 
 void ZeApp::memoryAlloc(ze_driver_handle_t driver, ze_device_handle_t device,
                         size_t size, void **ptr) {
+  if (level_zero_tests::usm_pool_requested()) {
+    *ptr = level_zero_tests::get_usm_pool(
+               ZE_MEMORY_TYPE_DEVICE, driver, device, 0,
+               ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT, ZE_HOST_MEM_ALLOC_FLAG_DEFAULT)
+               .allocate(size, 1);
+    SUCCESS_OR_TERMINATE(*ptr ? ZE_RESULT_SUCCESS
+                              : ZE_RESULT_ERROR_OUT_OF_DEVICE_MEMORY);
+    return;
+  }
+
   ze_device_mem_alloc_desc_t device_desc;
   device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
   device_desc.ordinal = 0;
@@ -103,6 +114,16 @@ void ZeApp::memoryAllocHost(size_t size, void **ptr) {
 
 void ZeApp::memoryAllocHost(ze_driver_handle_t driver, size_t size,
                             void **ptr) {
+  if (level_zero_tests::usm_pool_requested()) {
+    *ptr = level_zero_tests::get_usm_pool(
+               ZE_MEMORY_TYPE_HOST, driver, nullptr, 0,
+               ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT, ZE_HOST_MEM_ALLOC_FLAG_DEFAULT)
+               .allocate(size, 1);
+    SUCCESS_OR_TERMINATE(*ptr ? ZE_RESULT_SUCCESS
+                              : ZE_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+    return;
+  }
+
   ze_host_mem_alloc_desc_t host_desc;
   host_desc.version = ZE_HOST_MEM_ALLOC_DESC_VERSION_CURRENT;
   host_desc.flags = ZE_HOST_MEM_ALLOC_FLAG_DEFAULT;
@@ -111,10 +132,13 @@ void ZeApp::memoryAllocHost(ze_driver_handle_t driver, size_t size,
 
 void ZeApp::memoryFree(const void *ptr) {
   assert(this->driver != nullptr);
-  SUCCESS_OR_TERMINATE(zeDriverFreeMem(this->driver, const_cast<void *>(ptr)));
+  memoryFree(this->driver, ptr);
 }
 
 void ZeApp::memoryFree(ze_driver_handle_t driver, const void *ptr) {
+  if (level_zero_tests::usm_pool_requested() &&
+      level_zero_tests::usm_pool_free(ptr))
+    return;
   SUCCESS_OR_TERMINATE(zeDriverFreeMem(driver, const_cast<void *>(ptr)));
 }
 
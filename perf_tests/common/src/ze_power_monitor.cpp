@@ -0,0 +1,172 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_power_monitor.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+/* Allowed drop of the actual frequency before a run is flagged invalid */
+static const double frequency_drop_tolerance = 0.05;
+
+void PowerSample::merge(const PowerSample &other) {
+  if (!other.power_available && !other.frequency_available)
+    return;
+  if (!power_available && !frequency_available) {
+    *this = other;
+    return;
+  }
+
+  elapsed_sec += other.elapsed_sec;
+  energy_joules += other.energy_joules;
+  average_power_watts =
+      (elapsed_sec > 0) ? (energy_joules / elapsed_sec) : average_power_watts;
+  end_frequency_mhz = other.end_frequency_mhz;
+  throttle_time_usec += other.throttle_time_usec;
+  throttled = throttled || other.throttled;
+  clocks_dropped = clocks_dropped || other.clocks_dropped;
+}
+
+std::string PowerSample::to_string(long double rate,
+                                   const std::string &unit) const {
+  std::stringstream out;
+
+  if (power_available) {
+    out << average_power_watts << " W";
+    if (average_power_watts > 0)
+      out << ", " << (rate / average_power_watts) << " " << unit << "/W";
+  }
+  if (frequency_available) {
+    if (power_available)
+      out << ", ";
+    out << start_frequency_mhz << "->" << end_frequency_mhz << " MHz";
+    out << (throttled ? ", throttled" : "");
+    if (throttle_time_usec)
+      out << " (" << throttle_time_usec << " us)";
+    out << (is_valid() ? "" : ", INVALID: clocks dropped");
+  }
+  return out.str();
+}
+
+ZePowerMonitor::ZePowerMonitor(ze_device_handle_t device) {
+  ze_result_t result = zetInit(ZE_INIT_FLAG_NONE);
+  if (result) {
+    std::cerr << "WARNING : zetInit failed, power monitoring disabled : "
+              << result << std::endl;
+    return;
+  }
+
+  result = zetSysmanGet(device, ZET_SYSMAN_VERSION_CURRENT, &sysman);
+  if (result) {
+    std::cerr << "WARNING : zetSysmanGet failed, power monitoring disabled : "
+              << result << std::endl;
+    sysman = nullptr;
+    return;
+  }
+
+  uint32_t count = 0;
+  if ((zetSysmanPowerGet(sysman, &count, nullptr) == ZE_RESULT_SUCCESS) &&
+      count) {
+    power_handles.resize(count);
+    if (zetSysmanPowerGet(sysman, &count, power_handles.data()))
+      power_handles.clear();
+  }
+
+  count = 0;
+  if ((zetSysmanFrequencyGet(sysman, &count, nullptr) == ZE_RESULT_SUCCESS) &&
+      count) {
+    freq_handles.resize(count);
+    if (zetSysmanFrequencyGet(sysman, &count, freq_handles.data()))
+      freq_handles.clear();
+  }
+
+  if (!is_supported()) {
+    std::cerr << "WARNING : no sysman power or frequency domains found, "
+                 "power monitoring disabled"
+              << std::endl;
+  }
+}
+
+bool ZePowerMonitor::is_supported() const {
+  return !power_handles.empty() || !freq_handles.empty();
+}
+
+std::vector<ZePowerMonitor::FrequencySnapshot>
+ZePowerMonitor::read_frequency_domains() {
+  std::vector<FrequencySnapshot> snapshots;
+
+  for (auto freq_handle : freq_handles) {
+    zet_freq_state_t state = {};
+    zet_freq_throttle_time_t throttle_time = {};
+    FrequencySnapshot snapshot = {};
+
+    if (zetSysmanFrequencyGetState(freq_handle, &state) == ZE_RESULT_SUCCESS) {
+      snapshot.actual = state.actual;
+      snapshot.throttle_reasons = state.throttleReasons;
+    }
+    if (zetSysmanFrequencyGetThrottleTime(freq_handle, &throttle_time) ==
+        ZE_RESULT_SUCCESS) {
+      snapshot.throttle_time = throttle_time.throttleTime;
+    }
+    snapshots.push_back(snapshot);
+  }
+  return snapshots;
+}
+
+void ZePowerMonitor::start() {
+  if (!power_handles.empty()) {
+    start_energy = {};
+    zetSysmanPowerGetEnergyCounter(power_handles[0], &start_energy);
+  }
+  start_frequency = read_frequency_domains();
+}
+
+PowerSample ZePowerMonitor::stop() {
+  PowerSample sample;
+  std::vector<FrequencySnapshot> end_frequency = read_frequency_domains();
+
+  if (!power_handles.empty()) {
+    zet_power_energy_counter_t end_energy = {};
+    if ((zetSysmanPowerGetEnergyCounter(power_handles[0], &end_energy) ==
+         ZE_RESULT_SUCCESS) &&
+        (end_energy.timestamp > start_energy.timestamp)) {
+      /* Energy counters are in microjoules, timestamps in microseconds */
+      sample.power_available = true;
+      sample.elapsed_sec =
+          (end_energy.timestamp - start_energy.timestamp) / 1e6L;
+      sample.energy_joules = (end_energy.energy - start_energy.energy) / 1e6L;
+      sample.average_power_watts = sample.energy_joules / sample.elapsed_sec;
+    }
+  }
+
+  if (!end_frequency.empty() &&
+      (end_frequency.size() == start_frequency.size())) {
+    sample.frequency_available = true;
+    sample.start_frequency_mhz = start_frequency[0].actual;
+    sample.end_frequency_mhz = end_frequency[0].actual;
+
+    for (size_t i = 0; i < end_frequency.size(); i++) {
+      const FrequencySnapshot &before = start_frequency[i];
+      const FrequencySnapshot &after = end_frequency[i];
+      uint64_t throttle_time =
+          (after.throttle_time > before.throttle_time)
+              ? (after.throttle_time - before.throttle_time)
+              : 0;
+
+      sample.throttle_time_usec += throttle_time;
+      sample.throttled = sample.throttled || throttle_time ||
+                         before.throttle_reasons || after.throttle_reasons;
+      sample.clocks_dropped =
+          sample.clocks_dropped || throttle_time ||
+          (after.actual < before.actual * (1.0 - frequency_drop_tolerance));
+    }
+  }
+
+  return sample;
+}
@@ -0,0 +1,86 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef IMAGE_COPY_COMPARE_HPP
+#define IMAGE_COPY_COMPARE_HPP
+
+#include "common.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Image parameters every backend runs with, images are RGBA with 8 bits
+ * per unsigned integer channel */
+struct ImageCopyParams {
+  uint32_t width = 2048;
+  uint32_t height = 2048;
+  uint32_t depth = 1;
+  uint32_t warm_up_iterations = 10;
+  uint32_t num_iterations = 50;
+  uint32_t num_image_copies = 100;
+
+  size_t image_size() const {
+    return static_cast<size_t>(4) * width * height * depth;
+  }
+};
+
+enum class ImageCopyCase {
+  host_to_device_to_host,
+  host_to_device,
+  device_to_host
+};
+
+std::string to_string(const ImageCopyCase copy_case);
+
+/*
+ * One API's implementation of the image copy measurements. The backend only
+ * queues and waits for the copies, warm up, timing, bandwidth arithmetic and
+ * validation are shared so both APIs are measured the same way.
+ */
+class ImageCopyBackend {
+public:
+  virtual ~ImageCopyBackend() = default;
+  virtual std::string name() const = 0;
+  virtual std::string device_name() const = 0;
+
+  /* Creates the image and binds the host buffers copies read and write */
+  virtual void create(const ImageCopyParams &params, uint8_t *src,
+                      uint8_t *dst) = 0;
+  virtual void destroy() = 0;
+
+  /* Blocking copy of src into the image, and of the image into dst */
+  virtual void upload() = 0;
+  virtual void download() = 0;
+
+  /* Records whatever one iteration of copy_case needs ahead of time */
+  virtual void prepare(const ImageCopyCase copy_case) = 0;
+  /* Submits one iteration of copy_case and waits for it to complete.
+   * Host2Device2Host is one round trip, the other cases are
+   * num_image_copies copies. */
+  virtual void run(const ImageCopyCase copy_case) = 0;
+};
+
+std::unique_ptr<ImageCopyBackend> create_ze_image_copy_backend();
+/* device_type is one of cpu/gpu/accelerator/default/all, the first matching
+ * device of any platform is used */
+std::unique_ptr<ImageCopyBackend>
+create_cl_image_copy_backend(const std::string &device_type);
+
+struct ImageCopyResult {
+  long double gbps = 0;
+  long double latency_usec = 0;
+  bool valid = false;
+};
+
+ImageCopyResult measure_image_copy(ImageCopyBackend &backend,
+                                   const ImageCopyParams &params,
+                                   const ImageCopyCase copy_case);
+
+#endif /* IMAGE_COPY_COMPARE_HPP */
@@ -0,0 +1,179 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "image_copy_compare.hpp"
+
+#include <CL/cl_ext.h>
+
+#include <stdexcept>
+
+static cl_device_type to_device_type(const std::string &device_type) {
+  if (device_type == "cpu")
+    return CL_DEVICE_TYPE_CPU;
+  if (device_type == "gpu")
+    return CL_DEVICE_TYPE_GPU;
+  if (device_type == "accelerator")
+    return CL_DEVICE_TYPE_ACCELERATOR;
+  if (device_type == "default")
+    return CL_DEVICE_TYPE_DEFAULT;
+  if (device_type == "all")
+    return CL_DEVICE_TYPE_ALL;
+  throw std::runtime_error("unknown OpenCL device type: " + device_type);
+}
+
+class ClImageCopyBackend : public ImageCopyBackend {
+public:
+  ClImageCopyBackend(const std::string &device_type) {
+    select_device(to_device_type(device_type));
+
+    cl_int ret;
+    context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &ret);
+    if (ret != CL_SUCCESS) {
+      throw std::runtime_error("clCreateContext failed: " +
+                               std::to_string(ret));
+    }
+
+    // Copies of one iteration may overlap like those of an L0 command list
+    // without barriers; fall back to in order for implementations without
+    // out of order queues
+    cl_queue_properties queue_properties[] = {
+        CL_QUEUE_PROPERTIES, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, 0};
+    queue = clCreateCommandQueueWithProperties(context, device,
+                                               queue_properties, &ret);
+    if (ret != CL_SUCCESS) {
+      queue = clCreateCommandQueueWithProperties(context, device, nullptr,
+                                                 &ret);
+    }
+    if (ret != CL_SUCCESS) {
+      throw std::runtime_error("clCreateCommandQueueWithProperties failed: " +
+                               std::to_string(ret));
+    }
+  }
+
+  ~ClImageCopyBackend() {
+    clReleaseCommandQueue(queue);
+    clReleaseContext(context);
+  }
+
+  std::string name() const override { return "OpenCL"; }
+
+  std::string device_name() const override {
+    char name[256] = {};
+    SUCCESS_OR_TERMINATE(
+        clGetDeviceInfo(device, CL_DEVICE_NAME, sizeof(name), name, nullptr));
+    return name;
+  }
+
+  void create(const ImageCopyParams &params, uint8_t *src,
+              uint8_t *dst) override {
+    this->params = params;
+    this->src = src;
+    this->dst = dst;
+    region[0] = params.width;
+    region[1] = params.height;
+    region[2] = params.depth;
+
+    cl_image_format format;
+    format.image_channel_order = CL_RGBA;
+    format.image_channel_data_type = CL_UNSIGNED_INT8;
+
+    cl_image_desc image_desc = {};
+    image_desc.image_type = (params.depth > 1) ? CL_MEM_OBJECT_IMAGE3D
+                                               : CL_MEM_OBJECT_IMAGE2D;
+    image_desc.image_width = params.width;
+    image_desc.image_height = params.height;
+    image_desc.image_depth = params.depth;
+
+    cl_int ret;
+    image = clCreateImage(context, CL_MEM_READ_WRITE, &format, &image_desc,
+                          nullptr, &ret);
+    if (ret != CL_SUCCESS) {
+      throw std::runtime_error("clCreateImage failed: " + std::to_string(ret));
+    }
+  }
+
+  void destroy() override {
+    clReleaseMemObject(image);
+    image = nullptr;
+  }
+
+  void upload() override {
+    SUCCESS_OR_TERMINATE(clEnqueueWriteImage(queue, image, CL_TRUE, origin,
+                                             region, 0, 0, src, 0, nullptr,
+                                             nullptr));
+  }
+
+  void download() override {
+    SUCCESS_OR_TERMINATE(clEnqueueReadImage(queue, image, CL_TRUE, origin,
+                                            region, 0, 0, dst, 0, nullptr,
+                                            nullptr));
+  }
+
+  /* OpenCL has no reusable command buffers, commands are enqueued in run */
+  void prepare(const ImageCopyCase) override {}
+
+  void run(const ImageCopyCase copy_case) override {
+    if (copy_case == ImageCopyCase::host_to_device_to_host) {
+      SUCCESS_OR_TERMINATE(clEnqueueWriteImage(queue, image, CL_FALSE, origin,
+                                               region, 0, 0, src, 0, nullptr,
+                                               nullptr));
+      SUCCESS_OR_TERMINATE(
+          clEnqueueBarrierWithWaitList(queue, 0, nullptr, nullptr));
+      SUCCESS_OR_TERMINATE(clEnqueueReadImage(queue, image, CL_FALSE, origin,
+                                              region, 0, 0, dst, 0, nullptr,
+                                              nullptr));
+    } else if (copy_case == ImageCopyCase::host_to_device) {
+      for (uint32_t i = 0; i < params.num_image_copies; i++) {
+        SUCCESS_OR_TERMINATE(clEnqueueWriteImage(queue, image, CL_FALSE,
+                                                 origin, region, 0, 0, src, 0,
+                                                 nullptr, nullptr));
+      }
+    } else {
+      for (uint32_t i = 0; i < params.num_image_copies; i++) {
+        SUCCESS_OR_TERMINATE(clEnqueueReadImage(queue, image, CL_FALSE, origin,
+                                                region, 0, 0, dst, 0, nullptr,
+                                                nullptr));
+      }
+    }
+    SUCCESS_OR_TERMINATE(clFinish(queue));
+  }
+
+private:
+  void select_device(const cl_device_type type) {
+    cl_uint platform_count = 0;
+    SUCCESS_OR_TERMINATE(clGetPlatformIDs(0, nullptr, &platform_count));
+    std::vector<cl_platform_id> platforms(platform_count);
+    SUCCESS_OR_TERMINATE(
+        clGetPlatformIDs(platform_count, platforms.data(), nullptr));
+
+    for (auto platform : platforms) {
+      cl_uint device_count = 0;
+      if ((clGetDeviceIDs(platform, type, 1, &device, &device_count) ==
+           CL_SUCCESS) &&
+          device_count) {
+        return;
+      }
+    }
+    throw std::runtime_error("no OpenCL device of the requested type found");
+  }
+
+  cl_device_id device = nullptr;
+  cl_context context = nullptr;
+  cl_command_queue queue = nullptr;
+  cl_mem image = nullptr;
+  size_t origin[3] = {0, 0, 0};
+  size_t region[3] = {0, 0, 0};
+  ImageCopyParams params;
+  uint8_t *src = nullptr;
+  uint8_t *dst = nullptr;
+};
+
+std::unique_ptr<ImageCopyBackend>
+create_cl_image_copy_backend(const std::string &device_type) {
+  return std::unique_ptr<ImageCopyBackend>(new ClImageCopyBackend(device_type));
+}
@@ -0,0 +1,243 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "image_copy_compare.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+namespace po = boost::program_options;
+namespace pt = boost::property_tree;
+
+std::string to_string(const ImageCopyCase copy_case) {
+  switch (copy_case) {
+  case ImageCopyCase::host_to_device_to_host:
+    return "Host2Device2Host";
+  case ImageCopyCase::host_to_device:
+    return "Host2Device";
+  case ImageCopyCase::device_to_host:
+    return "Device2Host";
+  }
+  return "Unknown";
+}
+
+ImageCopyResult measure_image_copy(ImageCopyBackend &backend,
+                                   const ImageCopyParams &params,
+                                   const ImageCopyCase copy_case) {
+  Timer<std::chrono::microseconds::period> timer;
+  long double total_time_usec = 0;
+  ImageCopyResult result;
+
+  const size_t image_size = params.image_size();
+  std::vector<uint8_t> src(image_size);
+  std::vector<uint8_t> dst(image_size, 0xff);
+  for (size_t i = 0; i < image_size; ++i) {
+    src[i] = static_cast<uint8_t>(i);
+  }
+
+  backend.create(params, src.data(), dst.data());
+  if (copy_case == ImageCopyCase::device_to_host) {
+    backend.upload();
+  }
+  backend.prepare(copy_case);
+
+  for (uint32_t i = 0; i < params.warm_up_iterations; i++) {
+    backend.run(copy_case);
+  }
+
+  /* Both backends are timed from submission to completion */
+  for (uint32_t i = 0; i < params.num_iterations; i++) {
+    timer.start();
+    backend.run(copy_case);
+    timer.end();
+    total_time_usec += timer.period_minus_overhead();
+  }
+
+  if (copy_case == ImageCopyCase::host_to_device) {
+    std::fill(dst.begin(), dst.end(), 0xff);
+    backend.download();
+  }
+  result.valid = (src == dst);
+  backend.destroy();
+
+  /* A round trip copies the image twice */
+  const uint32_t copies_per_iteration =
+      (copy_case == ImageCopyCase::host_to_device_to_host)
+          ? 2
+          : params.num_image_copies;
+  const long double total_copies =
+      static_cast<long double>(copies_per_iteration) * params.num_iterations;
+  result.gbps = (image_size * total_copies / 1e9L) / (total_time_usec / 1e6L);
+  result.latency_usec = total_time_usec / total_copies;
+  return result;
+}
+
+struct CompareOptions {
+  ImageCopyParams params;
+  std::string backends = "both";
+  std::string cl_device_type = "default";
+  std::string json_file_name;
+};
+
+static int parse_command_line(int argc, char **argv, CompareOptions &options) {
+  ImageCopyParams &params = options.params;
+
+  po::options_description desc("Allowed options");
+  desc.add_options()("help", "produce help message")(
+      "width,w", po::value<uint32_t>(&params.width)->default_value(2048),
+      "set image width")(
+      "height,h", po::value<uint32_t>(&params.height)->default_value(2048),
+      "set image height")(
+      "depth,d", po::value<uint32_t>(&params.depth)->default_value(1),
+      "set image depth")(
+      "warmup",
+      po::value<uint32_t>(&params.warm_up_iterations)->default_value(2),
+      "set number of warmup iterations")(
+      "num-iter",
+      po::value<uint32_t>(&params.num_iterations)->default_value(50),
+      "set number of iterations")(
+      "noofimg",
+      po::value<uint32_t>(&params.num_image_copies)->default_value(100),
+      "set number of image copies per Host2Device and Device2Host iteration")(
+      "backend", po::value<std::string>(&options.backends),
+      "backends to run, both/ze/cl; ratios are printed for both")(
+      "cl-device-type", po::value<std::string>(&options.cl_device_type),
+      "OpenCL device to compare against, cpu/gpu/accelerator/default/all; "
+      "cpu runs on CPU implementations such as pocl")(
+      "json-output-file", po::value<std::string>(&options.json_file_name),
+      "test output format file name to be specified");
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  if (vm.count("help")) {
+    std::cout << desc << std::endl;
+    return 1;
+  } else if ((options.backends != "both") && (options.backends != "ze") &&
+             (options.backends != "cl")) {
+    std::cout << "unknown backend" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if (!params.width || !params.height || !params.depth ||
+             !params.num_iterations || !params.num_image_copies) {
+    std::cout << "image dimensions and counts must be at least 1" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+static std::string format_ratio(long double numerator,
+                                long double denominator) {
+  std::stringstream ratio;
+  if (denominator > 0) {
+    ratio << std::fixed << std::setprecision(2) << (numerator / denominator)
+          << "x";
+  } else {
+    ratio << "-";
+  }
+  return ratio.str();
+}
+
+int main(int argc, char **argv) {
+  CompareOptions options;
+  SUCCESS_OR_TERMINATE(parse_command_line(argc, argv, options));
+
+  std::vector<std::unique_ptr<ImageCopyBackend>> backends;
+  if (options.backends != "cl") {
+    backends.push_back(create_ze_image_copy_backend());
+  }
+  if (options.backends != "ze") {
+    backends.push_back(create_cl_image_copy_backend(options.cl_device_type));
+  }
+
+  std::cout << "Image " << options.params.width << "X"
+            << options.params.height << "X" << options.params.depth
+            << ", RGBA 8 bit unsigned integer" << std::endl;
+  for (const auto &backend : backends) {
+    std::cout << "  " << backend->name() << ": " << backend->device_name()
+              << std::endl;
+  }
+
+  const std::vector<ImageCopyCase> cases = {
+      ImageCopyCase::host_to_device_to_host, ImageCopyCase::host_to_device,
+      ImageCopyCase::device_to_host};
+  std::vector<std::vector<ImageCopyResult>> results(cases.size());
+  for (size_t c = 0; c < cases.size(); c++) {
+    for (const auto &backend : backends) {
+      results[c].push_back(
+          measure_image_copy(*backend, options.params, cases[c]));
+    }
+  }
+
+  /* Ratios favour Level Zero above 1x for both bandwidth and latency */
+  const bool compare = (backends.size() == 2);
+  std::cout << std::endl << std::left << std::setw(18) << "Case";
+  for (const auto &backend : backends) {
+    std::cout << std::right << std::setw(18) << (backend->name() + " GBPS")
+              << std::setw(16) << (backend->name() + " us");
+  }
+  if (compare) {
+    std::cout << std::setw(12) << "GBPS ratio" << std::setw(12)
+              << "us ratio";
+  }
+  std::cout << std::endl;
+
+  pt::ptree case_array;
+  bool all_valid = true;
+  for (size_t c = 0; c < cases.size(); c++) {
+    pt::ptree case_ptree;
+    case_ptree.put("Name", to_string(cases[c]));
+
+    std::cout << std::left << std::setw(18) << to_string(cases[c]);
+    for (size_t b = 0; b < backends.size(); b++) {
+      const ImageCopyResult &result = results[c][b];
+      std::cout << std::right << std::fixed << std::setprecision(3)
+                << std::setw(18) << result.gbps << std::setw(16)
+                << result.latency_usec;
+      case_ptree.put(backends[b]->name() + ".GBPS", result.gbps);
+      case_ptree.put(backends[b]->name() + ".Latency", result.latency_usec);
+      case_ptree.put(backends[b]->name() + ".Result",
+                     result.valid ? "PASSED" : "FAILED");
+      all_valid = all_valid && result.valid;
+    }
+    if (compare) {
+      const std::string gbps_ratio =
+          format_ratio(results[c][0].gbps, results[c][1].gbps);
+      const std::string latency_ratio = format_ratio(
+          results[c][1].latency_usec, results[c][0].latency_usec);
+      std::cout << std::setw(12) << gbps_ratio << std::setw(12)
+                << latency_ratio;
+      case_ptree.put("GBPS ratio", gbps_ratio);
+      case_ptree.put("Latency ratio", latency_ratio);
+    }
+    std::cout << std::endl;
+    case_array.push_back(std::make_pair("", case_ptree));
+  }
+
+  if (!all_valid) {
+    std::cout << "Data validation FAILED" << std::endl;
+  }
+
+  if (!options.json_file_name.empty()) {
+    pt::ptree main_tree;
+    std::stringstream image_dimensions;
+    image_dimensions << options.params.width << "X" << options.params.height
+                     << "X" << options.params.depth;
+    main_tree.put("Image size", image_dimensions.str());
+    main_tree.put_child("Cases", case_array);
+    pt::write_json(options.json_file_name, main_tree);
+  }
+  return all_valid ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "image_copy_compare.hpp"
+#include "ze_app.hpp"
+
+#include <level_zero/ze_api.h>
+
+class ZeImageCopyBackend : public ImageCopyBackend {
+public:
+  ZeImageCopyBackend() {
+    benchmark.singleDeviceInit();
+    benchmark.commandQueueCreate(ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+                                 &command_queue);
+    benchmark.commandListCreate(&upload_list);
+    benchmark.commandListCreate(&download_list);
+    benchmark.commandListCreate(&case_list);
+  }
+
+  ~ZeImageCopyBackend() {
+    benchmark.commandListDestroy(case_list);
+    benchmark.commandListDestroy(download_list);
+    benchmark.commandListDestroy(upload_list);
+    benchmark.commandQueueDestroy(command_queue);
+    benchmark.singleDeviceCleanup();
+  }
+
+  std::string name() const override { return "Level Zero"; }
+
+  std::string device_name() const override {
+    ze_device_properties_t properties = {};
+    properties.version = ZE_DEVICE_PROPERTIES_VERSION_CURRENT;
+    SUCCESS_OR_TERMINATE(
+        zeDeviceGetProperties(benchmark.device, &properties));
+    return properties.name;
+  }
+
+  void create(const ImageCopyParams &params, uint8_t *src,
+              uint8_t *dst) override {
+    this->params = params;
+    this->src = src;
+    this->dst = dst;
+    region = {0, 0, 0, params.width, params.height, params.depth};
+
+    ze_image_format_desc_t format = {
+        ZE_IMAGE_FORMAT_LAYOUT_8_8_8_8, ZE_IMAGE_FORMAT_TYPE_UINT,
+        ZE_IMAGE_FORMAT_SWIZZLE_R,      ZE_IMAGE_FORMAT_SWIZZLE_G,
+        ZE_IMAGE_FORMAT_SWIZZLE_B,      ZE_IMAGE_FORMAT_SWIZZLE_A};
+    ze_image_desc_t image_desc = {
+        ZE_IMAGE_DESC_VERSION_CURRENT,
+        ZE_IMAGE_FLAG_PROGRAM_READ,
+        (params.depth > 1) ? ZE_IMAGE_TYPE_3D : ZE_IMAGE_TYPE_2D,
+        format,
+        params.width,
+        params.height,
+        params.depth,
+        0,
+        0};
+    benchmark.imageCreate(&image_desc, &image);
+
+    benchmark.commandListReset(upload_list);
+    benchmark.commandListAppendImageCopyFromMemory(upload_list, image, src,
+                                                   &region);
+    benchmark.commandListClose(upload_list);
+
+    benchmark.commandListReset(download_list);
+    benchmark.commandListAppendImageCopyToMemory(download_list, dst, image,
+                                                 &region);
+    benchmark.commandListClose(download_list);
+  }
+
+  void destroy() override {
+    benchmark.imageDestroy(image);
+    image = nullptr;
+  }
+
+  void upload() override { execute(upload_list); }
+
+  void download() override { execute(download_list); }
+
+  void prepare(const ImageCopyCase copy_case) override {
+    benchmark.commandListReset(case_list);
+    if (copy_case == ImageCopyCase::host_to_device_to_host) {
+      benchmark.commandListAppendImageCopyFromMemory(case_list, image, src,
+                                                     &region);
+      benchmark.commandListAppendBarrier(case_list);
+      benchmark.commandListAppendImageCopyToMemory(case_list, dst, image,
+                                                   &region);
+    } else if (copy_case == ImageCopyCase::host_to_device) {
+      for (uint32_t i = 0; i < params.num_image_copies; i++) {
+        benchmark.commandListAppendImageCopyFromMemory(case_list, image, src,
+                                                       &region);
+      }
+    } else {
+      for (uint32_t i = 0; i < params.num_image_copies; i++) {
+        benchmark.commandListAppendImageCopyToMemory(case_list, dst, image,
+                                                     &region);
+      }
+    }
+    benchmark.commandListClose(case_list);
+  }
+
+  void run(const ImageCopyCase) override { execute(case_list); }
+
+private:
+  void execute(ze_command_list_handle_t list) {
+    SUCCESS_OR_TERMINATE(
+        zeCommandQueueExecuteCommandLists(command_queue, 1, &list, nullptr));
+    SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(command_queue, UINT32_MAX));
+  }
+
+  ZeApp benchmark;
+  ze_command_queue_handle_t command_queue = nullptr;
+  ze_command_list_handle_t upload_list = nullptr;
+  ze_command_list_handle_t download_list = nullptr;
+  ze_command_list_handle_t case_list = nullptr;
+  ze_image_handle_t image = nullptr;
+  ze_image_region_t region = {};
+  ImageCopyParams params;
+  uint8_t *src = nullptr;
+  uint8_t *dst = nullptr;
+};
+
+std::unique_ptr<ImageCopyBackend> create_ze_image_copy_backend() {
+  return std::unique_ptr<ImageCopyBackend>(new ZeImageCopyBackend());
+}
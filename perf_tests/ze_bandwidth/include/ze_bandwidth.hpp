@@ -9,12 +9,17 @@
 #include <chrono>
 #include <level_zero/ze_api.h>
 #include "ze_app.hpp"
+#include "ze_power_monitor.hpp"
+
+#include <memory>
+#include <string>
 
 class ZeBandwidth {
 public:
   ZeBandwidth();
   ~ZeBandwidth();
   int parse_arguments(int argc, char **argv);
+  void init_power_monitor(void);
   void test_host2device(void);
   void test_device2host(void);
 
@@ -24,6 +29,7 @@ public:
   bool verify = false;
   bool run_host2dev = true;
   bool run_dev2host = true;
+  bool monitor_power = false;
   uint32_t number_iterations = 500;
 
 private:
@@ -45,7 +51,10 @@ private:
                          long double total_data_transfer, /* Units in bytes */
                          long double &total_bandwidth,
                          long double &total_latency);
+  std::string power_efficiency(long double total_bandwidth);
   ZeApp *benchmark;
+  std::unique_ptr<ZePowerMonitor> power_monitor;
+  PowerSample power_sample;
   ze_command_queue_handle_t command_queue;
   ze_command_list_handle_t command_list;
   ze_command_list_handle_t command_list_verify;
@@ -18,6 +18,8 @@ static const char *usage_str =
     "\n                            [default:  both]"
     "\n  -v                       enable verificaton"
     "\n                            [default:  disabled]"
+    "\n  -m                       report power & frequency per transfer size"
+    "\n                            [default:  disabled]"
     "\n  -i                       set number of iterations per transfer"
     "\n                            [default:  500]"
     "\n  -s                       select only one transfer size (bytes) "
@@ -52,6 +54,8 @@ int ZeBandwidth::parse_arguments(int argc, char **argv) {
       exit(0);
     } else if (strcmp(argv[i], "-v") == 0) {
       verify = true;
+    } else if (strcmp(argv[i], "-m") == 0) {
+      monitor_power = true;
     } else if (strcmp(argv[i], "-i") == 0) {
       if ((i + 1) < argc) {
         number_iterations = sanitize_ulong(argv[i + 1]);
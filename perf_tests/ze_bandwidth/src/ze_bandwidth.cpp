@@ -36,6 +36,26 @@ ZeBandwidth::~ZeBandwidth() {
   delete benchmark;
 }
 
+void ZeBandwidth::init_power_monitor(void) {
+  if (!monitor_power)
+    return;
+
+  power_monitor.reset(new ZePowerMonitor(benchmark->device));
+  if (!power_monitor->is_supported())
+    power_monitor.reset();
+}
+
+std::string ZeBandwidth::power_efficiency(long double total_bandwidth) {
+  if (!power_monitor ||
+      (!power_sample.power_available && !power_sample.frequency_available))
+    return "";
+
+  std::string result =
+      "  Power = " + power_sample.to_string(total_bandwidth, "GBPS");
+  power_sample = PowerSample();
+  return result;
+}
+
 void ZeBandwidth::calculate_metrics(
     long double total_time_nsec,     /* Units in nanoseconds */
     long double total_data_transfer, /* Units in bytes */
@@ -55,7 +75,8 @@ void ZeBandwidth::print_results_host2device(size_t buffer_size,
   std::cout << "Host->Device[" << std::fixed << std::setw(10) << buffer_size
             << "]:  BW = " << std::setw(9) << std::setprecision(6)
             << total_bandwidth << " GBPS  Latency = " << std::setw(9)
-            << std::setprecision(2) << total_latency << " usec" << std::endl;
+            << std::setprecision(2) << total_latency << " usec"
+            << power_efficiency(total_bandwidth) << std::endl;
 }
 
 void ZeBandwidth::print_results_device2host(size_t buffer_size,
@@ -64,7 +85,8 @@ void ZeBandwidth::print_results_device2host(size_t buffer_size,
   std::cout << "Device->Host[" << std::fixed << std::setw(10) << buffer_size
             << "]:  BW = " << std::setw(9) << std::setprecision(6)
             << total_bandwidth << " GBPS  Latency = " << std::setw(9)
-            << std::setprecision(2) << total_latency << " usec" << std::endl;
+            << std::setprecision(2) << total_latency << " usec"
+            << power_efficiency(total_bandwidth) << std::endl;
 }
 
 void ZeBandwidth::measure_transfer_verify(size_t buffer_size,
@@ -108,12 +130,16 @@ void ZeBandwidth::measure_transfer_verify(size_t buffer_size,
 long double ZeBandwidth::measure_transfer(uint32_t num_transfer) {
   Timer<std::chrono::nanoseconds::period> timer;
 
+  if (power_monitor)
+    power_monitor->start();
   timer.start();
   for (uint32_t i = 0; i < num_transfer; i++) {
     benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list);
     benchmark->commandQueueSynchronize(command_queue);
   }
   timer.end();
+  if (power_monitor)
+    power_sample = power_monitor->stop();
 
   return timer.period_minus_overhead();
 }
@@ -261,6 +287,7 @@ int main(int argc, char **argv) {
   srand(1);
 
   bw.parse_arguments(argc, argv);
+  bw.init_power_monitor();
 
   default_size = bw.transfer_lower_limit;
   while (default_size < bw.transfer_upper_limit) {
@@ -0,0 +1,90 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_COPY_REGION_HPP_
+#define _ZE_COPY_REGION_HPP_
+
+#include <level_zero/ze_api.h>
+#include "common.hpp"
+#include "ze_app.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class CopyRegionMethod {
+  region, /* one zeCommandListAppendMemoryCopyRegion */
+  linear, /* one zeCommandListAppendMemoryCopy per row */
+  kernel  /* strided copy kernel */
+};
+
+std::string to_string(const CopyRegionMethod method);
+
+/*
+ * A width x height x depth byte region read from a strided source and
+ * written to a packed destination, as when packing a halo for exchange.
+ */
+struct RegionShape {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t depth = 0;
+  uint32_t src_pitch = 0;
+  uint32_t src_slice_pitch = 0;
+  std::string pitch_name;
+
+  size_t bytes() const { return static_cast<size_t>(width) * height * depth; }
+  size_t src_size() const {
+    return static_cast<size_t>(src_slice_pitch) * (depth - 1) +
+           static_cast<size_t>(src_pitch) * (height - 1) + width;
+  }
+};
+
+struct CopyRegionResult {
+  long double gbps = 0;
+  long double latency_usec = 0;
+  bool valid = false;
+  bool skipped = false;
+};
+
+class ZeCopyRegion {
+public:
+  ZeCopyRegion();
+  ~ZeCopyRegion();
+  int parse_command_line(int argc, char **argv);
+  std::vector<RegionShape> build_sweep() const;
+  CopyRegionResult measure(const RegionShape &shape,
+                           const CopyRegionMethod method);
+
+  std::vector<uint32_t> widths = {4, 64, 1024, 16384};
+  std::vector<uint32_t> heights = {256};
+  std::vector<uint32_t> depths = {1, 8};
+  std::vector<uint32_t> slice_pads = {0, 4096};
+  uint32_t num_copies = 10;
+  uint32_t warm_up_iterations = 2;
+  uint32_t num_iterations = 20;
+  std::string location = "d2d";
+  std::string json_file_name;
+
+private:
+  void load_kernels();
+  void copy_buffer(void *dst, const void *src, size_t size);
+  void append_copy(const RegionShape &shape, const CopyRegionMethod method,
+                   void *dst, void *src);
+  void append_kernel_copy(const RegionShape &shape, void *dst, void *src);
+  void allocate(bool on_device, size_t size, void **ptr);
+
+  ZeApp *benchmark;
+  ze_command_queue_handle_t command_queue;
+  ze_command_list_handle_t command_list;
+  ze_command_list_handle_t staging_command_list;
+  ze_module_handle_t module = nullptr;
+  ze_kernel_handle_t copy_bytes = nullptr;
+  ze_kernel_handle_t copy_uint4 = nullptr;
+};
+
+#endif /* _ZE_COPY_REGION_HPP_ */
@@ -0,0 +1,41 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+/*
+ * Copy a width x height x depth region between two strided buffers, one
+ * element per work-item. Pitches are given in elements.
+ */
+__kernel void copy_region_bytes(__global uchar *dst, __global const uchar *src,
+                                uint width, uint height, ulong dst_pitch,
+                                ulong dst_slice_pitch, ulong src_pitch,
+                                ulong src_slice_pitch) {
+  const size_t x = get_global_id(0);
+  const size_t y = get_global_id(1);
+  const size_t z = get_global_id(2);
+
+  if ((x >= width) || (y >= height))
+    return;
+  dst[z * dst_slice_pitch + y * dst_pitch + x] =
+      src[z * src_slice_pitch + y * src_pitch + x];
+}
+
+/* Same as copy_region_bytes for regions whose rows and pitches are 16 byte
+ * multiples */
+__kernel void copy_region_uint4(__global uint4 *dst, __global const uint4 *src,
+                                uint width, uint height, ulong dst_pitch,
+                                ulong dst_slice_pitch, ulong src_pitch,
+                                ulong src_slice_pitch) {
+  const size_t x = get_global_id(0);
+  const size_t y = get_global_id(1);
+  const size_t z = get_global_id(2);
+
+  if ((x >= width) || (y >= height))
+    return;
+  dst[z * dst_slice_pitch + y * dst_pitch + x] =
+      src[z * src_slice_pitch + y * src_pitch + x];
+}
@@ -0,0 +1,93 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_copy_region.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+/* Parses a comma separated list such as "4,64,1024" */
+static bool parse_list(const std::string &text, std::vector<uint32_t> &list) {
+  std::stringstream stream(text);
+  std::string item;
+
+  list.clear();
+  while (std::getline(stream, item, ',')) {
+    try {
+      list.push_back(static_cast<uint32_t>(std::stoul(item)));
+    } catch (const std::exception &) {
+      return false;
+    }
+  }
+  return !list.empty();
+}
+
+int ZeCopyRegion::parse_command_line(int argc, char **argv) {
+  std::string width_list;
+  std::string height_list;
+  std::string depth_list;
+  std::string slice_pad_list;
+
+  po::options_description desc("Allowed options");
+  desc.add_options()("help", "produce help message")(
+      "widths", po::value<std::string>(&width_list),
+      "comma separated region widths in bytes (by default 4,64,1024,16384)")(
+      "heights", po::value<std::string>(&height_list),
+      "comma separated region heights in rows (by default 256)")(
+      "depths", po::value<std::string>(&depth_list),
+      "comma separated region depths in slices (by default 1,8)")(
+      "slice-pads", po::value<std::string>(&slice_pad_list),
+      "comma separated bytes added to the source slice pitch of 3D "
+      "regions (by default 0,4096)")(
+      "location", po::value<std::string>(&location)->default_value("d2d"),
+      "source and destination memory, d2d/h2d/d2h")(
+      "warmup", po::value<uint32_t>(&warm_up_iterations)->default_value(2),
+      "set number of warmup iterations")(
+      "num-iter", po::value<uint32_t>(&num_iterations)->default_value(20),
+      "set number of iterations")(
+      "copies", po::value<uint32_t>(&num_copies)->default_value(10),
+      "set number of region copies per iteration")(
+      "json-output-file", po::value<std::string>(&json_file_name),
+      "test output format file name to be specified");
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  if (vm.count("help")) {
+    std::cout << desc << std::endl;
+    return 1;
+  } else if ((!width_list.empty() && !parse_list(width_list, widths)) ||
+             (!height_list.empty() && !parse_list(height_list, heights)) ||
+             (!depth_list.empty() && !parse_list(depth_list, depths)) ||
+             (!slice_pad_list.empty() &&
+              !parse_list(slice_pad_list, slice_pads))) {
+    std::cout << "malformed list" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if ((std::find(widths.begin(), widths.end(), 0) != widths.end()) ||
+             (std::find(heights.begin(), heights.end(), 0) != heights.end()) ||
+             (std::find(depths.begin(), depths.end(), 0) != depths.end())) {
+    std::cout << "region dimensions must be at least 1" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if ((location != "d2d") && (location != "h2d") &&
+             (location != "d2h")) {
+    std::cout << "unknown location" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if (!num_iterations || !num_copies) {
+    std::cout << "iterations and copies must be at least 1" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  }
+  return 0;
+}
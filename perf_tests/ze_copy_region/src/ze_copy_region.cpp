@@ -0,0 +1,408 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_copy_region.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+namespace pt = boost::property_tree;
+
+std::string to_string(const CopyRegionMethod method) {
+  switch (method) {
+  case CopyRegionMethod::region:
+    return "region";
+  case CopyRegionMethod::linear:
+    return "linear";
+  case CopyRegionMethod::kernel:
+    return "kernel";
+  }
+  return "unknown";
+}
+
+static uint64_t round_up(uint64_t value, uint64_t multiple) {
+  return ((value + multiple - 1) / multiple) * multiple;
+}
+
+ZeCopyRegion::ZeCopyRegion() {
+  benchmark = new ZeApp();
+  benchmark->singleDeviceInit();
+
+  benchmark->commandQueueCreate(0, &command_queue);
+  benchmark->commandListCreate(&command_list);
+  benchmark->commandListCreate(&staging_command_list);
+  load_kernels();
+}
+
+ZeCopyRegion::~ZeCopyRegion() {
+  if (copy_uint4)
+    benchmark->functionDestroy(copy_uint4);
+  if (copy_bytes)
+    benchmark->functionDestroy(copy_bytes);
+  if (module)
+    benchmark->moduleDestroy(module);
+
+  benchmark->commandListDestroy(staging_command_list);
+  benchmark->commandListDestroy(command_list);
+  benchmark->commandQueueDestroy(command_queue);
+  benchmark->singleDeviceCleanup();
+
+  delete benchmark;
+}
+
+/* The kernel method is skipped rather than failing the run when the
+ * strided copy kernels cannot be loaded */
+void ZeCopyRegion::load_kernels() {
+  std::ifstream stream("ze_copy_region.spv", std::ios::in | std::ios::binary);
+  std::vector<uint8_t> binary_file((std::istreambuf_iterator<char>(stream)),
+                                   std::istreambuf_iterator<char>());
+  if (binary_file.empty()) {
+    std::cerr << "WARNING : ze_copy_region.spv not found, kernel copies "
+                 "skipped"
+              << std::endl;
+    return;
+  }
+
+  ze_module_desc_t module_description;
+  module_description.version = ZE_MODULE_DESC_VERSION_CURRENT;
+  module_description.format = ZE_MODULE_FORMAT_IL_SPIRV;
+  module_description.inputSize = binary_file.size();
+  module_description.pInputModule = binary_file.data();
+  module_description.pBuildFlags = nullptr;
+  ze_result_t result = zeModuleCreate(benchmark->device, &module_description,
+                                      &module, nullptr);
+  if (result) {
+    std::cerr << "WARNING : zeModuleCreate failed, kernel copies skipped : "
+              << result << std::endl;
+    module = nullptr;
+    return;
+  }
+
+  benchmark->functionCreate(module, &copy_bytes, "copy_region_bytes");
+  benchmark->functionCreate(module, &copy_uint4, "copy_region_uint4");
+}
+
+void ZeCopyRegion::allocate(bool on_device, size_t size, void **ptr) {
+  if (on_device)
+    benchmark->memoryAlloc(size, ptr);
+  else
+    benchmark->memoryAllocHost(size, ptr);
+}
+
+void ZeCopyRegion::copy_buffer(void *dst, const void *src, size_t size) {
+  benchmark->commandListAppendMemoryCopy(staging_command_list, dst,
+                                         const_cast<void *>(src), size);
+  benchmark->commandListClose(staging_command_list);
+  benchmark->commandQueueExecuteCommandList(command_queue, 1,
+                                            &staging_command_list);
+  benchmark->commandQueueSynchronize(command_queue);
+  benchmark->commandListReset(staging_command_list);
+}
+
+/*
+ * Row pitches from contiguous to pathological: unaligned rows, rows padded
+ * past a cache line, rows on their own page and rows 64KB apart, which
+ * alias in caches and TLBs. 3D regions also get each slice padding.
+ */
+std::vector<RegionShape> ZeCopyRegion::build_sweep() const {
+  std::vector<RegionShape> shapes;
+
+  for (auto depth : depths) {
+    for (auto height : heights) {
+      for (auto width : widths) {
+        const std::pair<const char *, uint64_t> pitches[] = {
+            {"contiguous", width},
+            {"unaligned", width + 3},
+            {"padded", round_up(width, 64) + 64},
+            {"page", round_up(width, 4096)},
+            {"64K", round_up(width, 65536)}};
+        const std::vector<uint32_t> pads =
+            (depth > 1) ? slice_pads : std::vector<uint32_t>{0};
+        std::vector<uint64_t> seen;
+
+        for (const auto &pitch : pitches) {
+          if (std::find(seen.begin(), seen.end(), pitch.second) != seen.end())
+            continue;
+          seen.push_back(pitch.second);
+
+          for (auto pad : pads) {
+            /* Region copy pitches are 32 bit */
+            const uint64_t slice_pitch = pitch.second * height + pad;
+            if (slice_pitch > UINT32_MAX)
+              continue;
+
+            RegionShape shape;
+            shape.width = width;
+            shape.height = height;
+            shape.depth = depth;
+            shape.src_pitch = static_cast<uint32_t>(pitch.second);
+            shape.src_slice_pitch = static_cast<uint32_t>(slice_pitch);
+            shape.pitch_name = pitch.first;
+            shapes.push_back(shape);
+          }
+        }
+      }
+    }
+  }
+  return shapes;
+}
+
+void ZeCopyRegion::append_kernel_copy(const RegionShape &shape, void *dst,
+                                      void *src) {
+  const bool vector = (shape.width % 16 == 0) && (shape.src_pitch % 16 == 0) &&
+                      (shape.src_slice_pitch % 16 == 0);
+  ze_kernel_handle_t kernel = vector ? copy_uint4 : copy_bytes;
+  const uint32_t element_size = vector ? 16 : 1;
+  const uint32_t width = shape.width / element_size;
+  const uint64_t pitches[] = {
+      width, static_cast<uint64_t>(width) * shape.height,
+      shape.src_pitch / element_size, shape.src_slice_pitch / element_size};
+
+  uint32_t group_x = 1;
+  while ((group_x < width) && (group_x < 256))
+    group_x *= 2;
+  uint32_t group_y = 1;
+  while ((group_y < shape.height) && (group_x * group_y < 256))
+    group_y *= 2;
+  SUCCESS_OR_TERMINATE(zeKernelSetGroupSize(kernel, group_x, group_y, 1));
+
+  SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(kernel, 0, sizeof(dst), &dst));
+  SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(kernel, 1, sizeof(src), &src));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 2, sizeof(width), &width));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 3, sizeof(shape.height), &shape.height));
+  for (uint32_t i = 0; i < 4; i++) {
+    SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(
+        kernel, 4 + i, sizeof(pitches[i]), &pitches[i]));
+  }
+
+  ze_group_count_t group_count = {(width + group_x - 1) / group_x,
+                                  (shape.height + group_y - 1) / group_y,
+                                  shape.depth};
+  SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+      command_list, kernel, &group_count, nullptr, 0, nullptr));
+}
+
+void ZeCopyRegion::append_copy(const RegionShape &shape,
+                               const CopyRegionMethod method, void *dst,
+                               void *src) {
+  const size_t row_size = shape.width;
+  const size_t slice_size = row_size * shape.height;
+
+  switch (method) {
+  case CopyRegionMethod::region: {
+    ze_copy_region_t src_region = {0,           0,           0,
+                                   shape.width, shape.height, shape.depth};
+    ze_copy_region_t dst_region = src_region;
+    SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopyRegion(
+        command_list, dst, &dst_region, shape.width,
+        static_cast<uint32_t>(slice_size), src, &src_region, shape.src_pitch,
+        shape.src_slice_pitch, nullptr));
+    break;
+  }
+  case CopyRegionMethod::linear:
+    for (uint32_t z = 0; z < shape.depth; z++) {
+      for (uint32_t y = 0; y < shape.height; y++) {
+        uint8_t *dst_row =
+            static_cast<uint8_t *>(dst) + z * slice_size + y * row_size;
+        uint8_t *src_row = static_cast<uint8_t *>(src) +
+                           static_cast<size_t>(z) * shape.src_slice_pitch +
+                           static_cast<size_t>(y) * shape.src_pitch;
+        benchmark->commandListAppendMemoryCopy(command_list, dst_row, src_row,
+                                               row_size);
+      }
+    }
+    break;
+  case CopyRegionMethod::kernel:
+    append_kernel_copy(shape, dst, src);
+    break;
+  }
+}
+
+CopyRegionResult ZeCopyRegion::measure(const RegionShape &shape,
+                                       const CopyRegionMethod method) {
+  Timer<std::chrono::microseconds::period> timer;
+  CopyRegionResult result;
+
+  if ((method == CopyRegionMethod::kernel) && !copy_bytes) {
+    result.skipped = true;
+    return result;
+  }
+
+  const size_t src_size = shape.src_size();
+  const size_t dst_size = shape.bytes();
+  void *src = nullptr;
+  void *dst = nullptr;
+  void *host_pattern = nullptr;
+  void *host_output = nullptr;
+  allocate(location != "h2d", src_size, &src);
+  allocate(location != "d2h", dst_size, &dst);
+  benchmark->memoryAllocHost(src_size, &host_pattern);
+  benchmark->memoryAllocHost(dst_size, &host_output);
+
+  uint8_t *pattern = static_cast<uint8_t *>(host_pattern);
+  uint8_t *output = static_cast<uint8_t *>(host_output);
+  for (size_t i = 0; i < src_size; i++) {
+    pattern[i] = static_cast<uint8_t>(i % 251);
+  }
+  memset(output, 0, dst_size);
+  copy_buffer(src, pattern, src_size);
+  copy_buffer(dst, output, dst_size);
+
+  for (uint32_t i = 0; i < num_copies; i++) {
+    append_copy(shape, method, dst, src);
+  }
+  benchmark->commandListClose(command_list);
+
+  for (uint32_t i = 0; i < warm_up_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list);
+    benchmark->commandQueueSynchronize(command_queue);
+  }
+
+  timer.start();
+  for (uint32_t i = 0; i < num_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list);
+    benchmark->commandQueueSynchronize(command_queue);
+  }
+  timer.end();
+  const long double total_time_usec = timer.period_minus_overhead();
+  benchmark->commandListReset(command_list);
+
+  copy_buffer(output, dst, dst_size);
+  result.valid = true;
+  for (uint32_t z = 0; (z < shape.depth) && result.valid; z++) {
+    for (uint32_t y = 0; (y < shape.height) && result.valid; y++) {
+      const size_t dst_offset =
+          (static_cast<size_t>(z) * shape.height + y) * shape.width;
+      const size_t src_offset =
+          static_cast<size_t>(z) * shape.src_slice_pitch +
+          static_cast<size_t>(y) * shape.src_pitch;
+      result.valid =
+          (memcmp(output + dst_offset, pattern + src_offset, shape.width) == 0);
+    }
+  }
+
+  benchmark->memoryFree(host_output);
+  benchmark->memoryFree(host_pattern);
+  benchmark->memoryFree(dst);
+  benchmark->memoryFree(src);
+
+  const long double total_copies =
+      static_cast<long double>(num_copies) * num_iterations;
+  result.gbps =
+      (shape.bytes() * total_copies / 1e9L) / (total_time_usec / 1e6L);
+  result.latency_usec = total_time_usec / total_copies;
+  return result;
+}
+
+static std::string format_ratio(long double numerator,
+                                long double denominator) {
+  std::stringstream ratio;
+  if ((numerator > 0) && (denominator > 0)) {
+    ratio << std::fixed << std::setprecision(2) << (numerator / denominator)
+          << "x";
+  } else {
+    ratio << "-";
+  }
+  return ratio.str();
+}
+
+int main(int argc, char **argv) {
+  ZeCopyRegion copy_region;
+  SUCCESS_OR_TERMINATE(copy_region.parse_command_line(argc, argv));
+
+  const std::vector<CopyRegionMethod> methods = {CopyRegionMethod::region,
+                                                 CopyRegionMethod::linear,
+                                                 CopyRegionMethod::kernel};
+  const std::vector<RegionShape> shapes = copy_region.build_sweep();
+
+  std::cout << "Strided source to packed destination (" << copy_region.location
+            << "), " << copy_region.num_copies << " copies per iteration, "
+            << copy_region.num_iterations << " iterations" << std::endl;
+  std::cout << "GBPS per method; ratios are region GBPS over linear and "
+               "kernel GBPS, above 1x favours the region copy"
+            << std::endl
+            << std::endl;
+  std::cout << std::right << std::setw(7) << "Width" << std::setw(7)
+            << "Height" << std::setw(6) << "Depth" << std::setw(8) << "Pitch"
+            << std::setw(12) << "Kind" << std::setw(11) << "Slice";
+  for (auto method : methods) {
+    std::cout << std::setw(10) << to_string(method);
+  }
+  std::cout << std::setw(11) << "region us" << std::setw(11) << "vs linear"
+            << std::setw(11) << "vs kernel" << std::setw(8) << "Best"
+            << std::endl;
+
+  pt::ptree shape_array;
+  bool all_valid = true;
+  for (const auto &shape : shapes) {
+    std::vector<CopyRegionResult> results;
+    for (auto method : methods) {
+      results.push_back(copy_region.measure(shape, method));
+    }
+
+    pt::ptree shape_ptree;
+    shape_ptree.put("Width", shape.width);
+    shape_ptree.put("Height", shape.height);
+    shape_ptree.put("Depth", shape.depth);
+    shape_ptree.put("Pitch", shape.src_pitch);
+    shape_ptree.put("Pitch kind", shape.pitch_name);
+    shape_ptree.put("Slice pitch", shape.src_slice_pitch);
+
+    std::cout << std::setw(7) << shape.width << std::setw(7) << shape.height
+              << std::setw(6) << shape.depth << std::setw(8)
+              << shape.src_pitch << std::setw(12) << shape.pitch_name
+              << std::setw(11) << shape.src_slice_pitch;
+
+    size_t best = 0;
+    for (size_t m = 0; m < methods.size(); m++) {
+      const CopyRegionResult &result = results[m];
+      const std::string name = to_string(methods[m]);
+      if (result.skipped) {
+        std::cout << std::setw(10) << "-";
+        shape_ptree.put(name + ".Result", "SKIPPED");
+        continue;
+      }
+      std::cout << std::setw(10) << std::fixed << std::setprecision(3)
+                << result.gbps;
+      shape_ptree.put(name + ".GBPS", result.gbps);
+      shape_ptree.put(name + ".Latency", result.latency_usec);
+      shape_ptree.put(name + ".Result", result.valid ? "PASSED" : "FAILED");
+      all_valid = all_valid && result.valid;
+      if (result.gbps > results[best].gbps)
+        best = m;
+    }
+
+    std::cout << std::setw(11) << std::setprecision(2)
+              << results[0].latency_usec << std::setw(11)
+              << format_ratio(results[0].gbps, results[1].gbps)
+              << std::setw(11)
+              << format_ratio(results[0].gbps, results[2].gbps) << std::setw(8)
+              << to_string(methods[best]) << std::endl;
+    shape_ptree.put("Best", to_string(methods[best]));
+    shape_array.push_back(std::make_pair("", shape_ptree));
+  }
+
+  if (!all_valid) {
+    std::cout << "Data validation FAILED" << std::endl;
+  }
+
+  if (!copy_region.json_file_name.empty()) {
+    pt::ptree main_tree;
+    main_tree.put("Location", copy_region.location);
+    main_tree.put_child("Shapes", shape_array);
+    pt::write_json(copy_region.json_file_name, main_tree);
+  }
+  return all_valid ? 0 : 1;
+}
@@ -12,10 +12,13 @@
 #include "common.hpp"
 #include <level_zero/ze_api.h>
 #include "ze_app.hpp"
+#include "ze_power_monitor.hpp"
 
 #include <assert.h>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <vector>
 #include <boost/program_options.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
@@ -38,7 +41,15 @@ public:
   uint32_t warm_up_iterations = 10;
   uint32_t num_image_copies = 100;
   uint32_t data_validation = 0;
+  uint32_t num_queues = 1;
+  bool queue_threads = false;
+  bool tile_sweep = false;
+  uint32_t min_tile_size = 64;
+  std::string tile_order = "row";
+  bool format_matrix = false;
   bool validRet = false;
+  bool monitor_power = false;
+  PowerSample power_sample;
   long double gbps;
   long double latency;
   ptree param_array;
@@ -54,8 +65,12 @@ public:
   void measureParallelDevice2Host();
   void measureSerialHost2Device();
   void measureSerialDevice2Host();
+  void measureMultiQueue(bool host_to_device, ptree *test_ptree);
+  void measureTiledCopy(bool host_to_device, ptree *test_ptree);
+  void measureFormatMatrix(ptree *test_ptree);
   int parse_command_line(int argc, char **argv);
   bool is_json_output_enabled();
+  void put_power_efficiency(ptree *test_ptree);
 
 private:
   void initialize_buffer(void);
@@ -63,8 +78,16 @@ private:
   void test_cleanup(void);
   void validate_data_buffer(void);
   void reset_all_events(void);
+  void begin_power_sample(void);
+  void end_power_sample(void);
+  void print_power_efficiency(void);
+  long double run_multi_queue(uint32_t queue_count, bool host_to_device);
+  long double run_tiled_copy(uint32_t tile_width, uint32_t tile_height,
+                             bool host_to_device, uint32_t &num_tiles);
+  long double time_command_list(ze_command_list_handle_t list);
 
   ZeApp *benchmark;
+  std::unique_ptr<ZePowerMonitor> power_monitor;
   ze_command_queue_handle_t command_queue;
   ze_command_list_handle_t command_list;
   ze_command_list_handle_t command_list_a;
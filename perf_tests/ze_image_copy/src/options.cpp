@@ -50,7 +50,25 @@ int ZeImageCopy::parse_command_line(int argc, char **argv) {
       "data-validation", po::value<uint32_t>(&data_validation),
       "optional param for validating the copied image is correct or not")(
       "json-output-file", po::value<std::string>(&JsonFileName),
-      "test output format file name to be specified");
+      "test output format file name to be specified")(
+      "queues", po::value<uint32_t>(&num_queues)->default_value(1),
+      "split the image copies across this many command queues, each with "
+      "its own image and command list, and report scaling against one queue")(
+      "queue-threads", po::bool_switch(&queue_threads),
+      "submit to each command queue from its own host thread")(
+      "tile-sweep", po::bool_switch(&tile_sweep),
+      "copy the image as a grid of tiles, doubling the tile size up to the "
+      "full image, and report throughput and per-region overhead")(
+      "tile-size", po::value<uint32_t>(&min_tile_size)->default_value(64),
+      "smallest tile width and height of the tile sweep")(
+      "tile-order", po::value<std::string>(&tile_order)->default_value("row"),
+      "order the tiles are copied in, row/random")(
+      "format-matrix", po::bool_switch(&format_matrix),
+      "measure copy-in, copy-out and image to image bandwidth for every "
+      "layout, format type and image type, printed as a table")(
+      "power-monitor", po::bool_switch(&monitor_power),
+      "report sysman power, GBPS per watt and throttling for each "
+      "measurement");
 
   po::variables_map vm;
   po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -80,6 +98,18 @@ int ZeImageCopy::parse_command_line(int argc, char **argv) {
     std::cout << "unknown  Imageformat" << std::endl;
     std::cout << desc << std::endl;
     return 1;
+  } else if (min_tile_size == 0) {
+    std::cout << "tile size must be at least 1" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if ((tile_order != "row") && (tile_order != "random")) {
+    std::cout << "unknown tile order" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if (num_queues == 0) {
+    std::cout << "number of queues must be at least 1" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
   } else if (Imagetype == -1) {
     std::cout << "unknown  Imagetype" << std::endl;
     std::cout << desc << std::endl;
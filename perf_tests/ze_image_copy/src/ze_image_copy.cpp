@@ -7,7 +7,11 @@
  */
 
 #include "ze_image_copy.h"
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <random>
+#include <thread>
 
 ZeImageCopy ::ZeImageCopy() {
 
@@ -99,6 +103,39 @@ void ZeImageCopy::reset_all_events(void) {
   }
 }
 
+void ZeImageCopy::begin_power_sample(void) {
+  if (monitor_power && !power_monitor) {
+    power_monitor.reset(new ZePowerMonitor(benchmark->device));
+    if (!power_monitor->is_supported())
+      monitor_power = false;
+  }
+  if (monitor_power)
+    power_monitor->start();
+}
+
+void ZeImageCopy::end_power_sample(void) {
+  power_sample = monitor_power ? power_monitor->stop() : PowerSample();
+}
+
+void ZeImageCopy::print_power_efficiency(void) {
+  if (power_sample.power_available || power_sample.frequency_available)
+    std::cout << "  Power: " << power_sample.to_string(gbps, "GBPS")
+              << std::endl;
+}
+
+void ZeImageCopy::put_power_efficiency(ptree *test_ptree) {
+  if (power_sample.power_available) {
+    test_ptree->put("Power (W)", power_sample.average_power_watts);
+    if (power_sample.average_power_watts > 0)
+      test_ptree->put("GBPS per Watt",
+                      gbps / power_sample.average_power_watts);
+  }
+  if (power_sample.frequency_available) {
+    test_ptree->put("Throttled", power_sample.throttled);
+    test_ptree->put("Valid", power_sample.is_valid());
+  }
+}
+
 void ZeImageCopy::validate_data_buffer(void) {
   if (this->data_validation) {
     validRet =
@@ -132,6 +169,7 @@ void ZeImageCopy::measureHost2Device2Host() {
   }
 
   // Measure the bandwidth of copy from host to device to host only
+  begin_power_sample();
   for (int i = 0; i < num_iterations; i++) {
 
     timer.start();
@@ -143,6 +181,7 @@ void ZeImageCopy::measureHost2Device2Host() {
     timer.end();
     total_time_usec += timer.period_minus_overhead();
   }
+  end_power_sample();
 
   total_time_s = total_time_usec / 1e6;
 
@@ -153,6 +192,7 @@ void ZeImageCopy::measureHost2Device2Host() {
   gbps = total_data_transfer / total_time_s;
 
   std::cout << gbps << " GBPS\n";
+  print_power_efficiency();
   this->validate_data_buffer();
   this->test_cleanup();
 }
@@ -188,6 +228,7 @@ void ZeImageCopy::measureParallelHost2Device() {
   benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list_b);
   benchmark->commandQueueSynchronize(command_queue);
 
+  begin_power_sample();
   for (int i = 0; i < num_iterations; i++) {
 
     // Measure the bandwidth of copy from host to device only
@@ -199,6 +240,7 @@ void ZeImageCopy::measureParallelHost2Device() {
 
     total_time_usec += timer.period_minus_overhead();
   }
+  end_power_sample();
 
   // The below commands for command_list_b for final validation at the end
   benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list_b);
@@ -211,6 +253,7 @@ void ZeImageCopy::measureParallelHost2Device() {
 
   gbps = total_data_transfer / total_time_s;
   std::cout << gbps << " GBPS\n";
+  print_power_efficiency();
   latency = total_time_usec /
             static_cast<long double>(num_image_copies * num_iterations);
   std::cout << std::setprecision(11) << latency << " us"
@@ -254,6 +297,7 @@ void ZeImageCopy::measureParallelDevice2Host() {
   benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list_b);
   benchmark->commandQueueSynchronize(command_queue);
 
+  begin_power_sample();
   for (int i = 0; i < num_iterations; i++) {
 
     // measure the bandwidth of copy from device to host only
@@ -265,6 +309,7 @@ void ZeImageCopy::measureParallelDevice2Host() {
 
     total_time_usec += timer.period_minus_overhead();
   }
+  end_power_sample();
   total_time_s = total_time_usec / 1e6;
 
   total_data_transfer =
@@ -273,6 +318,7 @@ void ZeImageCopy::measureParallelDevice2Host() {
 
   gbps = total_data_transfer / total_time_s;
   std::cout << gbps << " GBPS\n";
+  print_power_efficiency();
   latency = total_time_usec /
             static_cast<long double>(num_image_copies * num_iterations);
   std::cout << std::setprecision(11) << latency << " us"
@@ -337,6 +383,7 @@ void ZeImageCopy::measureSerialHost2Device() {
 
   // Measure the bandwidth of copy from host to device only
   total_time_usec = 0;
+  begin_power_sample();
   for (int j = 0; j < num_iterations; j++) {
     benchmark->commandQueueExecuteCommandList(command_queue, 1,
                                               &command_list_a);
@@ -350,6 +397,7 @@ void ZeImageCopy::measureSerialHost2Device() {
     reset_all_events();
     total_time_usec += timer.period_minus_overhead();
   }
+  end_power_sample();
 
   // Copy data from device to host to validate it
   benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list_b);
@@ -362,6 +410,7 @@ void ZeImageCopy::measureSerialHost2Device() {
 
   gbps = total_data_transfer / total_time_s;
   std::cout << gbps << " GBPS\n";
+  print_power_efficiency();
   latency = total_time_usec / static_cast<long double>(num_iterations);
   std::cout << std::setprecision(11) << latency << " us"
             << " (Latency: Host->Device)" << std::endl;
@@ -426,6 +475,7 @@ void ZeImageCopy::measureSerialDevice2Host() {
 
   // Measure the bandwidth of copy from device to host only
   total_time_usec = 0;
+  begin_power_sample();
   for (int i = 0; i < num_iterations; i++) {
     // Measure the bandwidth of copy from device to host only
     benchmark->commandQueueExecuteCommandList(command_queue, 1,
@@ -441,6 +491,7 @@ void ZeImageCopy::measureSerialDevice2Host() {
     reset_all_events();
     total_time_usec += timer.period_minus_overhead();
   }
+  end_power_sample();
 
   total_time_s = total_time_usec / 1e6;
 
@@ -449,6 +500,7 @@ void ZeImageCopy::measureSerialDevice2Host() {
 
   gbps = total_data_transfer / total_time_s;
   std::cout << gbps << " GBPS\n";
+  print_power_efficiency();
   latency = total_time_usec / static_cast<long double>(num_iterations);
   std::cout << std::setprecision(11) << latency << " us"
             << " (Latency: Device->Host)" << std::endl;
@@ -456,6 +508,527 @@ void ZeImageCopy::measureSerialDevice2Host() {
   this->test_cleanup();
 }
 
+// Copies are split across queue_count command queues. Every queue owns its
+// own image, command list and host buffer, so the queues never touch the same
+// resource and can run on separate engines.
+long double ZeImageCopy::run_multi_queue(uint32_t queue_count,
+                                         bool host_to_device) {
+  Timer<std::chrono::microseconds::period> timer;
+  long double total_time_usec;
+  long double total_time_s;
+  long double total_data_transfer;
+  uint32_t total_copies = 0;
+
+  this->test_initialize();
+
+  ze_device_properties_t device_properties = {
+      ZE_DEVICE_PROPERTIES_VERSION_CURRENT};
+  SUCCESS_OR_TERMINATE(
+      zeDeviceGetProperties(benchmark->device, &device_properties));
+  uint32_t num_engines =
+      std::max<uint32_t>(1, device_properties.numAsyncComputeEngines);
+
+  std::vector<ze_command_queue_handle_t> queues(queue_count);
+  std::vector<ze_command_list_handle_t> lists(queue_count);
+  std::vector<ze_image_handle_t> images(queue_count);
+  std::vector<std::vector<uint8_t>> host_buffers(queue_count);
+
+  for (uint32_t q = 0; q < queue_count; q++) {
+    benchmark->commandQueueCreate(q % num_engines, &queues[q]);
+    benchmark->commandListCreate(&lists[q]);
+    benchmark->imageCreate(&imageDesc, &images[q]);
+    host_buffers[q].assign(srcBuffer, srcBuffer + buffer_size);
+
+    /* Give every queue an equal share of the copies, remainder first */
+    uint32_t copies = num_image_copies / queue_count +
+                      (q < (num_image_copies % queue_count) ? 1 : 0);
+    total_copies += copies;
+
+    if (!host_to_device) {
+      benchmark->commandListAppendImageCopyFromMemory(
+          lists[q], images[q], host_buffers[q].data(), &this->region);
+      benchmark->commandListClose(lists[q]);
+      benchmark->commandQueueExecuteCommandList(queues[q], 1, &lists[q]);
+      benchmark->commandQueueSynchronize(queues[q]);
+      benchmark->commandListReset(lists[q]);
+      std::fill(host_buffers[q].begin(), host_buffers[q].end(), 0xff);
+    }
+
+    for (uint32_t i = 0; i < copies; i++) {
+      if (host_to_device)
+        benchmark->commandListAppendImageCopyFromMemory(
+            lists[q], images[q], host_buffers[q].data(), &this->region);
+      else
+        benchmark->commandListAppendImageCopyToMemory(
+            lists[q], host_buffers[q].data(), images[q], &this->region);
+    }
+    benchmark->commandListClose(lists[q]);
+  }
+
+  /* Warm up */
+  for (uint32_t i = 0; i < warm_up_iterations; i++) {
+    for (uint32_t q = 0; q < queue_count; q++)
+      benchmark->commandQueueExecuteCommandList(queues[q], 1, &lists[q]);
+    for (uint32_t q = 0; q < queue_count; q++)
+      benchmark->commandQueueSynchronize(queues[q]);
+  }
+
+  begin_power_sample();
+  if (queue_threads) {
+    std::vector<std::thread> threads;
+
+    timer.start();
+    for (uint32_t q = 0; q < queue_count; q++) {
+      threads.push_back(std::thread([&, q]() {
+        for (uint32_t i = 0; i < num_iterations; i++) {
+          SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+              queues[q], 1, &lists[q], nullptr));
+          SUCCESS_OR_TERMINATE(
+              zeCommandQueueSynchronize(queues[q], UINT32_MAX));
+        }
+      }));
+    }
+    for (auto &thread : threads)
+      thread.join();
+    timer.end();
+  } else {
+    timer.start();
+    for (uint32_t i = 0; i < num_iterations; i++) {
+      for (uint32_t q = 0; q < queue_count; q++)
+        SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+            queues[q], 1, &lists[q], nullptr));
+      for (uint32_t q = 0; q < queue_count; q++)
+        SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(queues[q], UINT32_MAX));
+    }
+    timer.end();
+  }
+  end_power_sample();
+  total_time_usec = timer.period_minus_overhead();
+
+  // Read every image back so that each queue's copies can be validated
+  if (this->data_validation) {
+    validRet = true;
+    for (uint32_t q = 0; q < queue_count; q++) {
+      if (host_to_device) {
+        benchmark->commandListReset(lists[q]);
+        benchmark->commandListAppendImageCopyToMemory(lists[q], dstBuffer,
+                                                      images[q], &this->region);
+        benchmark->commandListClose(lists[q]);
+        benchmark->commandQueueExecuteCommandList(queues[q], 1, &lists[q]);
+        benchmark->commandQueueSynchronize(queues[q]);
+      } else {
+        std::copy(host_buffers[q].begin(), host_buffers[q].end(), dstBuffer);
+      }
+      this->validate_data_buffer();
+      if (!validRet)
+        break;
+    }
+  }
+
+  for (uint32_t q = 0; q < queue_count; q++) {
+    benchmark->imageDestroy(images[q]);
+    benchmark->commandListDestroy(lists[q]);
+    benchmark->commandQueueDestroy(queues[q]);
+  }
+  this->test_cleanup();
+
+  total_time_s = total_time_usec / 1e6;
+  total_data_transfer = (buffer_size * total_copies * num_iterations) /
+                        static_cast<long double>(1e9); /* Units in Gigabytes */
+
+  return total_data_transfer / total_time_s;
+}
+
+void ZeImageCopy::measureMultiQueue(bool host_to_device, ptree *test_ptree) {
+  long double single_queue_gbps = 0;
+  bool all_valid = true;
+
+  /* Sweep powers of two up to the requested queue count */
+  std::vector<uint32_t> queue_counts;
+  for (uint32_t queue_count = 1; queue_count < num_queues; queue_count *= 2)
+    queue_counts.push_back(queue_count);
+  queue_counts.push_back(num_queues);
+
+  for (auto queue_count : queue_counts) {
+    gbps = run_multi_queue(queue_count, host_to_device);
+    if (queue_count == 1)
+      single_queue_gbps = gbps;
+    long double scaling = gbps / single_queue_gbps;
+    all_valid = all_valid && validRet;
+
+    if (is_json_output_enabled()) {
+      ptree queue_ptree;
+      queue_ptree.put("GBPS", gbps);
+      queue_ptree.put("Scaling", scaling);
+      put_power_efficiency(&queue_ptree);
+      test_ptree->put_child(std::to_string(queue_count) + " queues",
+                            queue_ptree);
+    } else {
+      std::cout << "  " << queue_count << " queue(s): " << gbps << " GBPS, "
+                << scaling << "x vs 1 queue" << std::endl;
+      print_power_efficiency();
+    }
+  }
+  validRet = all_valid;
+}
+
+// Copies the whole image as a grid of tile_width x tile_height regions and
+// returns the average time of one pass over all tiles. Each tile reads from
+// (or writes to) its own slice of the host buffer, packed in row-major tile
+// order, so a tiled upload followed by a tiled readback round-trips the data.
+long double ZeImageCopy::run_tiled_copy(uint32_t tile_width,
+                                        uint32_t tile_height,
+                                        bool host_to_device,
+                                        uint32_t &num_tiles) {
+  Timer<std::chrono::microseconds::period> timer;
+  long double total_time_usec;
+  std::vector<std::pair<ze_image_region_t, size_t>> tiles;
+  size_t offset = 0;
+
+  this->test_initialize();
+
+  for (uint32_t y = 0; y < height; y += tile_height) {
+    for (uint32_t x = 0; x < width; x += tile_width) {
+      ze_image_region_t tile = {x,
+                                y,
+                                0,
+                                std::min(tile_width, width - x),
+                                std::min(tile_height, height - y),
+                                depth};
+      tiles.push_back(std::make_pair(tile, offset));
+      offset += 4 * tile.width * tile.height * tile.depth;
+    }
+  }
+  num_tiles = static_cast<uint32_t>(tiles.size());
+
+  /* Fixed seed so that random order runs are repeatable */
+  if (tile_order == "random")
+    std::shuffle(tiles.begin(), tiles.end(), std::mt19937(0));
+
+  // Readback of a tiled upload is done with the same tiles, and a tiled
+  // readback needs an image uploaded the same way to validate against
+  benchmark->commandListReset(command_list_a);
+  benchmark->commandListReset(command_list_b);
+  for (auto &tile : tiles) {
+    benchmark->commandListAppendImageCopyFromMemory(
+        command_list_a, image, srcBuffer + tile.second, &tile.first);
+    benchmark->commandListAppendImageCopyToMemory(
+        command_list_b, dstBuffer + tile.second, image, &tile.first);
+  }
+  benchmark->commandListClose(command_list_a);
+  benchmark->commandListClose(command_list_b);
+
+  ze_command_list_handle_t timed_list =
+      host_to_device ? command_list_a : command_list_b;
+  if (!host_to_device) {
+    benchmark->commandQueueExecuteCommandList(command_queue, 1,
+                                              &command_list_a);
+    benchmark->commandQueueSynchronize(command_queue);
+  }
+
+  /* Warm up */
+  for (uint32_t i = 0; i < warm_up_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(command_queue, 1, &timed_list);
+    benchmark->commandQueueSynchronize(command_queue);
+  }
+
+  begin_power_sample();
+  timer.start();
+  for (uint32_t i = 0; i < num_iterations; i++) {
+    SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+        command_queue, 1, &timed_list, nullptr));
+    SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(command_queue, UINT32_MAX));
+  }
+  timer.end();
+  end_power_sample();
+  total_time_usec = timer.period_minus_overhead();
+
+  if (host_to_device) {
+    benchmark->commandQueueExecuteCommandList(command_queue, 1,
+                                              &command_list_b);
+    benchmark->commandQueueSynchronize(command_queue);
+  }
+  this->validate_data_buffer();
+  this->test_cleanup();
+
+  return total_time_usec / num_iterations;
+}
+
+void ZeImageCopy::measureTiledCopy(bool host_to_device, ptree *test_ptree) {
+  uint32_t num_tiles;
+  bool all_valid = true;
+  ptree sweep_array;
+
+  // The full image is copied first, its pass time is the baseline the
+  // per-region overhead of the smaller tiles is measured against
+  long double full_time_usec =
+      run_tiled_copy(width, height, host_to_device, num_tiles);
+  all_valid = validRet;
+
+  std::vector<std::pair<uint32_t, uint32_t>> tile_sizes;
+  for (uint32_t tile_size = min_tile_size;
+       tile_size < std::max(width, height); tile_size *= 2)
+    tile_sizes.push_back(
+        std::make_pair(std::min(tile_size, width),
+                       std::min(tile_size, height)));
+  tile_sizes.push_back(std::make_pair(width, height));
+
+  if (!is_json_output_enabled())
+    std::cout << std::setw(12) << "Tile" << std::setw(10) << "Regions"
+              << std::setw(14) << "GBPS" << std::setw(16) << "us/region"
+              << std::setw(20) << "overhead us/region" << std::endl;
+
+  for (auto &tile_size : tile_sizes) {
+    long double time_usec =
+        (tile_size.first == width && tile_size.second == height)
+            ? full_time_usec
+            : run_tiled_copy(tile_size.first, tile_size.second, host_to_device,
+                             num_tiles);
+    if (tile_size.first == width && tile_size.second == height)
+      num_tiles = 1;
+    all_valid = all_valid && validRet;
+
+    gbps = buffer_size / (time_usec * 1e3);
+    long double region_usec = time_usec / num_tiles;
+    long double overhead_usec = (time_usec - full_time_usec) / num_tiles;
+    std::string tile_name = std::to_string(tile_size.first) + "x" +
+                            std::to_string(tile_size.second);
+
+    if (is_json_output_enabled()) {
+      ptree tile_ptree;
+      tile_ptree.put("Tile", tile_name);
+      tile_ptree.put("Regions", num_tiles);
+      tile_ptree.put("GBPS", gbps);
+      tile_ptree.put("Time per region (us)", region_usec);
+      tile_ptree.put("Overhead per region (us)", overhead_usec);
+      put_power_efficiency(&tile_ptree);
+      sweep_array.push_back(std::make_pair("", tile_ptree));
+    } else {
+      std::cout << std::setw(12) << tile_name << std::setw(10) << num_tiles
+                << std::setw(14) << gbps << std::setw(16) << region_usec
+                << std::setw(20) << overhead_usec << std::endl;
+      print_power_efficiency();
+    }
+  }
+
+  if (is_json_output_enabled())
+    test_ptree->put_child("Tiles", sweep_array);
+  validRet = all_valid;
+}
+
+// Bytes per pixel of each layout, averaged over the planes for the planar
+// media layouts (e.g. NV12 carries a quarter size UV plane, 1.5 bytes).
+static double bytes_per_pixel(ze_image_format_layout_t layout) {
+  switch (layout) {
+  case ZE_IMAGE_FORMAT_LAYOUT_8:
+  case ZE_IMAGE_FORMAT_LAYOUT_Y8:
+    return 1;
+  case ZE_IMAGE_FORMAT_LAYOUT_NV12:
+    return 1.5;
+  case ZE_IMAGE_FORMAT_LAYOUT_16:
+  case ZE_IMAGE_FORMAT_LAYOUT_8_8:
+  case ZE_IMAGE_FORMAT_LAYOUT_5_6_5:
+  case ZE_IMAGE_FORMAT_LAYOUT_5_5_5_1:
+  case ZE_IMAGE_FORMAT_LAYOUT_4_4_4_4:
+  case ZE_IMAGE_FORMAT_LAYOUT_YUYV:
+  case ZE_IMAGE_FORMAT_LAYOUT_VYUY:
+  case ZE_IMAGE_FORMAT_LAYOUT_YVYU:
+  case ZE_IMAGE_FORMAT_LAYOUT_UYVY:
+  case ZE_IMAGE_FORMAT_LAYOUT_Y16:
+    return 2;
+  case ZE_IMAGE_FORMAT_LAYOUT_P010:
+  case ZE_IMAGE_FORMAT_LAYOUT_P012:
+  case ZE_IMAGE_FORMAT_LAYOUT_P016:
+    return 3;
+  case ZE_IMAGE_FORMAT_LAYOUT_P416:
+    return 6;
+  case ZE_IMAGE_FORMAT_LAYOUT_16_16_16_16:
+  case ZE_IMAGE_FORMAT_LAYOUT_32_32:
+    return 8;
+  case ZE_IMAGE_FORMAT_LAYOUT_32_32_32_32:
+    return 16;
+  default:
+    return 4;
+  }
+}
+
+// Returns the average time of one execution of an already closed command list
+long double ZeImageCopy::time_command_list(ze_command_list_handle_t list) {
+  Timer<std::chrono::microseconds::period> timer;
+
+  /* Warm up */
+  for (uint32_t i = 0; i < warm_up_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(command_queue, 1, &list);
+    benchmark->commandQueueSynchronize(command_queue);
+  }
+
+  timer.start();
+  for (uint32_t i = 0; i < num_iterations; i++) {
+    SUCCESS_OR_TERMINATE(
+        zeCommandQueueExecuteCommandLists(command_queue, 1, &list, nullptr));
+    SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(command_queue, UINT32_MAX));
+  }
+  timer.end();
+
+  return timer.period_minus_overhead() / num_iterations;
+}
+
+// Runs copy-in, copy-out and image to image copies for every layout of every
+// format type, in every image type. Array images use depth as the number of
+// array slices. Combinations the driver refuses to create are reported as
+// unsupported rather than terminating the run.
+void ZeImageCopy::measureFormatMatrix(ptree *test_ptree) {
+  const std::vector<
+      std::pair<ze_image_format_type_t, std::vector<ze_image_format_layout_t>>>
+      formats = {
+          {ZE_IMAGE_FORMAT_TYPE_UINT,
+           level_zero_tests::image_format_layout_uint},
+          {ZE_IMAGE_FORMAT_TYPE_SINT,
+           level_zero_tests::image_format_layout_sint},
+          {ZE_IMAGE_FORMAT_TYPE_UNORM,
+           level_zero_tests::image_format_layout_unorm},
+          {ZE_IMAGE_FORMAT_TYPE_SNORM,
+           level_zero_tests::image_format_layout_snorm},
+          {ZE_IMAGE_FORMAT_TYPE_FLOAT,
+           level_zero_tests::image_format_layout_float},
+          {ZE_IMAGE_FORMAT_TYPE_FLOAT,
+           level_zero_tests::image_format_media_layouts}};
+  const std::vector<ze_image_type_t> image_types = {
+      ZE_IMAGE_TYPE_1D, ZE_IMAGE_TYPE_1DARRAY, ZE_IMAGE_TYPE_2D,
+      ZE_IMAGE_TYPE_2DARRAY, ZE_IMAGE_TYPE_3D};
+  ptree matrix_array;
+
+  if (!is_json_output_enabled())
+    std::cout << std::setw(8) << "Type" << std::setw(14) << "Layout"
+              << std::setw(10) << "Image" << std::setw(14) << "Copy-in"
+              << std::setw(14) << "Copy-out" << std::setw(16)
+              << "Image2Image" << "  (GBPS)" << std::endl;
+
+  for (auto &format : formats) {
+    for (auto layout : format.second) {
+      for (auto image_type : image_types) {
+        uint32_t image_height = height;
+        uint32_t image_depth = depth;
+        uint32_t array_levels = 0;
+        ze_image_region_t matrix_region = {0, 0, 0, width, height, depth};
+
+        switch (image_type) {
+        case ZE_IMAGE_TYPE_1D:
+          image_height = image_depth = 1;
+          matrix_region.height = matrix_region.depth = 1;
+          break;
+        case ZE_IMAGE_TYPE_1DARRAY:
+          /* Slices of a 1D array are addressed through y */
+          image_height = image_depth = 1;
+          array_levels = depth;
+          matrix_region.height = depth;
+          matrix_region.depth = 1;
+          break;
+        case ZE_IMAGE_TYPE_2D:
+          image_depth = 1;
+          matrix_region.depth = 1;
+          break;
+        case ZE_IMAGE_TYPE_2DARRAY:
+          image_depth = 1;
+          array_levels = depth;
+          break;
+        default:
+          break;
+        }
+
+        ze_image_format_desc_t matrix_format = {
+            layout,
+            format.first,
+            ZE_IMAGE_FORMAT_SWIZZLE_R,
+            ZE_IMAGE_FORMAT_SWIZZLE_G,
+            ZE_IMAGE_FORMAT_SWIZZLE_B,
+            ZE_IMAGE_FORMAT_SWIZZLE_A};
+        ze_image_desc_t matrix_desc = {ZE_IMAGE_DESC_VERSION_CURRENT,
+                                       Imageflags,
+                                       image_type,
+                                       matrix_format,
+                                       width,
+                                       image_height,
+                                       image_depth,
+                                       array_levels,
+                                       0};
+
+        ze_image_handle_t src_image = nullptr;
+        ze_image_handle_t dst_image = nullptr;
+        bool supported =
+            (zeImageCreate(benchmark->device, &matrix_desc, &src_image) ==
+             ZE_RESULT_SUCCESS) &&
+            (zeImageCreate(benchmark->device, &matrix_desc, &dst_image) ==
+             ZE_RESULT_SUCCESS);
+
+        long double copy_in_gbps = 0;
+        long double copy_out_gbps = 0;
+        long double image_copy_gbps = 0;
+        if (supported) {
+          size_t pixels = static_cast<size_t>(matrix_region.width) *
+                          matrix_region.height * matrix_region.depth;
+          long double bytes = pixels * bytes_per_pixel(layout);
+          std::vector<uint8_t> host_src(static_cast<size_t>(std::ceil(bytes)));
+          std::vector<uint8_t> host_dst(host_src.size());
+          for (size_t i = 0; i < host_src.size(); i++)
+            host_src[i] = static_cast<uint8_t>(i);
+
+          benchmark->commandListReset(command_list);
+          benchmark->commandListAppendImageCopyFromMemory(
+              command_list, src_image, host_src.data(), &matrix_region);
+          benchmark->commandListClose(command_list);
+          copy_in_gbps = bytes / (time_command_list(command_list) * 1e3);
+
+          benchmark->commandListReset(command_list);
+          benchmark->commandListAppendImageCopyToMemory(
+              command_list, host_dst.data(), src_image, &matrix_region);
+          benchmark->commandListClose(command_list);
+          copy_out_gbps = bytes / (time_command_list(command_list) * 1e3);
+
+          benchmark->commandListReset(command_list);
+          SUCCESS_OR_TERMINATE(zeCommandListAppendImageCopy(
+              command_list, dst_image, src_image, nullptr));
+          benchmark->commandListClose(command_list);
+          image_copy_gbps = bytes / (time_command_list(command_list) * 1e3);
+        }
+        if (src_image)
+          benchmark->imageDestroy(src_image);
+        if (dst_image)
+          benchmark->imageDestroy(dst_image);
+
+        if (is_json_output_enabled()) {
+          ptree cell_ptree;
+          cell_ptree.put("Image format",
+                         level_zero_tests::to_string(format.first));
+          cell_ptree.put("Image Layout", level_zero_tests::to_string(layout));
+          cell_ptree.put("Image type",
+                         level_zero_tests::to_string(image_type));
+          cell_ptree.put("Supported", supported);
+          if (supported) {
+            cell_ptree.put("Copy-in GBPS", copy_in_gbps);
+            cell_ptree.put("Copy-out GBPS", copy_out_gbps);
+            cell_ptree.put("Image2Image GBPS", image_copy_gbps);
+          }
+          matrix_array.push_back(std::make_pair("", cell_ptree));
+        } else {
+          std::cout << std::setw(8) << level_zero_tests::to_string(format.first)
+                    << std::setw(14) << level_zero_tests::to_string(layout)
+                    << std::setw(10) << level_zero_tests::to_string(image_type);
+          if (supported)
+            std::cout << std::setw(14) << copy_in_gbps << std::setw(14)
+                      << copy_out_gbps << std::setw(16) << image_copy_gbps;
+          else
+            std::cout << std::setw(44) << "unsupported";
+          std::cout << std::endl;
+        }
+      }
+    }
+  }
+
+  if (is_json_output_enabled())
+    test_ptree->put_child("Formats", matrix_array);
+}
+
 ZeImageCopyLatency::ZeImageCopyLatency() {
   width = 1;
   height = 1;
@@ -485,6 +1058,7 @@ void measure_bandwidth_Host2Device2Host(ZeImageCopy &Imagecopy,
 
   if (Imagecopy.is_json_output_enabled()) {
     test_ptree->put("GBPS", Imagecopy.gbps);
+    Imagecopy.put_power_efficiency(test_ptree);
     if (Imagecopy.data_validation)
       test_ptree->put("Result", (Imagecopy.validRet ? "PASSED" : "FAILED"));
   } else {
@@ -515,6 +1089,7 @@ void measure_bandwidth_Host2Device(ZeImageCopy &Imagecopy, ptree *test_ptree) {
 
   if (Imagecopy.is_json_output_enabled()) {
     test_ptree->put("GBPS", Imagecopy.gbps);
+    Imagecopy.put_power_efficiency(test_ptree);
     if (Imagecopy.data_validation) {
       test_ptree->put("Result", (Imagecopy.validRet ? "PASSED" : "FAILED"));
     }
@@ -547,6 +1122,7 @@ void measure_bandwidth_Device2Host(ZeImageCopy &Imagecopy, ptree *test_ptree) {
 
   if (Imagecopy.is_json_output_enabled()) {
     test_ptree->put("GBPS", Imagecopy.gbps);
+    Imagecopy.put_power_efficiency(test_ptree);
     if (Imagecopy.data_validation)
       test_ptree->put("Result", (Imagecopy.validRet ? "PASSED" : "FAILED"));
   } else {
@@ -560,20 +1136,146 @@ void measure_bandwidth_Device2Host(ZeImageCopy &Imagecopy, ptree *test_ptree) {
   Imagecopy.measureSerialDevice2Host();
 }
 
+void measure_bandwidth_MultiQueue(ZeImageCopy &Imagecopy, bool host_to_device,
+                                  ptree *test_ptree) {
+  std::string direction = host_to_device ? "Host2Device" : "Device2Host";
+  std::string path = host_to_device ? "Host->Device" : "Device->Host";
+
+  if (Imagecopy.is_json_output_enabled()) {
+    std::stringstream Image_dimensions;
+    Image_dimensions << Imagecopy.width << "X" << Imagecopy.height << "X"
+                     << Imagecopy.depth;
+    test_ptree->put("Name", "MultiQueue " + direction +
+                                ": Bandwidth copying from " + path +
+                                " across command queues");
+    test_ptree->put("Image size", Image_dimensions.str());
+    test_ptree->put("Host threads", Imagecopy.queue_threads);
+  } else {
+    std::cout << "MultiQueue " << direction
+              << ": Measuring aggregate Bandwidth for copying the image "
+                 "buffer size "
+              << Imagecopy.width << "X" << Imagecopy.height << "X"
+              << Imagecopy.depth << " from " << path << " across up to "
+              << Imagecopy.num_queues << " command queues"
+              << (Imagecopy.queue_threads ? " (one host thread per queue)"
+                                          : "")
+              << std::endl;
+  }
+
+  Imagecopy.measureMultiQueue(host_to_device, test_ptree);
+
+  if (Imagecopy.is_json_output_enabled()) {
+    if (Imagecopy.data_validation)
+      test_ptree->put("Result", (Imagecopy.validRet ? "PASSED" : "FAILED"));
+  } else {
+    if (Imagecopy.data_validation) {
+      std::cout << "  Results: Data validation "
+                << (Imagecopy.validRet ? "PASSED" : "FAILED") << std::endl;
+    }
+    std::cout << std::endl;
+  }
+}
+
+void measure_bandwidth_Tiled(ZeImageCopy &Imagecopy, bool host_to_device,
+                             ptree *test_ptree) {
+  std::string direction = host_to_device ? "Host2Device" : "Device2Host";
+  std::string path = host_to_device ? "Host->Device" : "Device->Host";
+
+  if (Imagecopy.is_json_output_enabled()) {
+    std::stringstream Image_dimensions;
+    Image_dimensions << Imagecopy.width << "X" << Imagecopy.height << "X"
+                     << Imagecopy.depth;
+    test_ptree->put("Name", "Tiled " + direction + ": Bandwidth copying from " +
+                                path + " as a grid of tiles");
+    test_ptree->put("Image size", Image_dimensions.str());
+    test_ptree->put("Tile order", Imagecopy.tile_order);
+  } else {
+    std::cout << "Tiled " << direction
+              << ": Measuring Bandwidth for copying the image buffer size "
+              << Imagecopy.width << "X" << Imagecopy.height << "X"
+              << Imagecopy.depth << " from " << path << " in "
+              << Imagecopy.tile_order << " tile order" << std::endl;
+  }
+
+  Imagecopy.measureTiledCopy(host_to_device, test_ptree);
+
+  if (Imagecopy.is_json_output_enabled()) {
+    if (Imagecopy.data_validation)
+      test_ptree->put("Result", (Imagecopy.validRet ? "PASSED" : "FAILED"));
+  } else {
+    if (Imagecopy.data_validation) {
+      std::cout << "  Results: Data validation "
+                << (Imagecopy.validRet ? "PASSED" : "FAILED") << std::endl;
+    }
+    std::cout << std::endl;
+  }
+}
+
+void measure_bandwidth_FormatMatrix(ZeImageCopy &Imagecopy, ptree *test_ptree) {
+  if (Imagecopy.is_json_output_enabled()) {
+    std::stringstream Image_dimensions;
+    Image_dimensions << Imagecopy.width << "X" << Imagecopy.height << "X"
+                     << Imagecopy.depth;
+    test_ptree->put("Name", "FormatMatrix: Bandwidth of copy-in, copy-out and "
+                            "image to image copies for every image format");
+    test_ptree->put("Image size", Image_dimensions.str());
+  } else {
+    std::cout << "FormatMatrix: Measuring Bandwidth for every image format "
+                 "with image size "
+              << Imagecopy.width << "X" << Imagecopy.height << "X"
+              << Imagecopy.depth << std::endl;
+  }
+
+  Imagecopy.measureFormatMatrix(test_ptree);
+
+  if (!Imagecopy.is_json_output_enabled())
+    std::cout << std::endl;
+}
+
 void measure_bandwidth(ZeImageCopy &Imagecopy) {
   ptree ptree_Host2Device2Host;
   ptree ptree_Host2Device;
   ptree ptree_Device2Host;
+  ptree ptree_MultiQueueHost2Device;
+  ptree ptree_MultiQueueDevice2Host;
+  ptree ptree_TiledHost2Device;
+  ptree ptree_TiledDevice2Host;
+  ptree ptree_FormatMatrix;
   ptree ptree_main;
 
   measure_bandwidth_Host2Device2Host(Imagecopy, &ptree_Host2Device2Host);
   measure_bandwidth_Host2Device(Imagecopy, &ptree_Host2Device);
   measure_bandwidth_Device2Host(Imagecopy, &ptree_Device2Host);
+  if (Imagecopy.num_queues > 1) {
+    measure_bandwidth_MultiQueue(Imagecopy, true, &ptree_MultiQueueHost2Device);
+    measure_bandwidth_MultiQueue(Imagecopy, false,
+                                 &ptree_MultiQueueDevice2Host);
+  }
+  if (Imagecopy.tile_sweep) {
+    measure_bandwidth_Tiled(Imagecopy, true, &ptree_TiledHost2Device);
+    measure_bandwidth_Tiled(Imagecopy, false, &ptree_TiledDevice2Host);
+  }
+  if (Imagecopy.format_matrix)
+    measure_bandwidth_FormatMatrix(Imagecopy, &ptree_FormatMatrix);
 
   if (Imagecopy.is_json_output_enabled()) {
     Imagecopy.param_array.push_back(std::make_pair("", ptree_Host2Device2Host));
     Imagecopy.param_array.push_back(std::make_pair("", ptree_Host2Device));
     Imagecopy.param_array.push_back(std::make_pair("", ptree_Device2Host));
+    if (Imagecopy.num_queues > 1) {
+      Imagecopy.param_array.push_back(
+          std::make_pair("", ptree_MultiQueueHost2Device));
+      Imagecopy.param_array.push_back(
+          std::make_pair("", ptree_MultiQueueDevice2Host));
+    }
+    if (Imagecopy.tile_sweep) {
+      Imagecopy.param_array.push_back(
+          std::make_pair("", ptree_TiledHost2Device));
+      Imagecopy.param_array.push_back(
+          std::make_pair("", ptree_TiledDevice2Host));
+    }
+    if (Imagecopy.format_matrix)
+      Imagecopy.param_array.push_back(std::make_pair("", ptree_FormatMatrix));
     ptree_main.put_child("Performance Benchmark.bandwidth",
                          Imagecopy.param_array);
     pt::write_json(Imagecopy.JsonFileName.c_str(), ptree_main);
@@ -0,0 +1,87 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_MEMORY_ALLOC_HPP_
+#define _ZE_MEMORY_ALLOC_HPP_
+
+#include <level_zero/ze_api.h>
+#include "common.hpp"
+#include "ze_app.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class AllocMemory { device, host, shared };
+
+std::string to_string(const AllocMemory memory);
+
+/* The alignments the test harness' memory tests allocate with */
+const std::vector<size_t> memory_allocation_alignments = {1,  2,  4, 8,
+                                                          16, 32, 64};
+
+/* Latency percentiles of one call, in usec */
+struct LatencyDistribution {
+  long double min = 0;
+  long double p50 = 0;
+  long double p90 = 0;
+  long double p99 = 0;
+  long double max = 0;
+};
+
+LatencyDistribution compute_distribution(std::vector<long double> &samples);
+
+struct AllocResult {
+  bool failed = false;
+  LatencyDistribution alloc;
+  LatencyDistribution free;
+  /* Allocate and free pairs per second over all threads */
+  long double pairs_per_sec = 0;
+};
+
+struct TraceResult {
+  bool failed = false;
+  size_t allocations = 0;
+  LatencyDistribution alloc;
+  LatencyDistribution free;
+  uint64_t peak_live_size = 0;
+  uint64_t peak_reserved_size = 0;
+};
+
+class ZeMemoryAlloc {
+public:
+  ZeMemoryAlloc();
+  ~ZeMemoryAlloc();
+  int parse_command_line(int argc, char **argv);
+  bool allocate(AllocMemory memory, size_t size, size_t alignment,
+                void **ptr);
+  void release(void *ptr);
+  size_t reserved_size(void *ptr, size_t size);
+  AllocResult measure(AllocMemory memory, size_t size, size_t alignment,
+                      uint32_t threads);
+  TraceResult replay_trace(AllocMemory memory);
+
+  std::vector<AllocMemory> memories = {AllocMemory::device, AllocMemory::host,
+                                       AllocMemory::shared};
+  size_t min_size = 1;
+  size_t max_size = (1ull << 30);
+  size_t fixed_size = 4096;
+  uint32_t max_threads = 8;
+  uint32_t num_iterations = 100;
+  uint32_t trace_length = 10000;
+  size_t trace_min_size = 64;
+  size_t trace_max_size = (1u << 24);
+  uint32_t trace_max_lifetime = 1000;
+  uint32_t trace_seed = 1;
+  std::string json_file_name;
+
+private:
+  ZeApp *benchmark;
+};
+
+#endif /* _ZE_MEMORY_ALLOC_HPP_ */
@@ -0,0 +1,86 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_memory_alloc.hpp"
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+int ZeMemoryAlloc::parse_command_line(int argc, char **argv) {
+  std::string memory = "all";
+
+  po::options_description desc("Allowed options");
+  desc.add_options()("help", "produce help message")(
+      "memory", po::value<std::string>(&memory),
+      "allocated memory, device/host/shared/all")(
+      "min-size", po::value<size_t>(&min_size)->default_value(1),
+      "smallest allocation size in bytes, multiplied by 16 up to max-size")(
+      "max-size", po::value<size_t>(&max_size)->default_value(1ull << 30),
+      "largest allocation size in bytes")(
+      "fixed-size", po::value<size_t>(&fixed_size)->default_value(4096),
+      "allocation size of the alignment and thread sweeps")(
+      "max-threads", po::value<uint32_t>(&max_threads)->default_value(8),
+      "largest number of threads, doubled from 1")(
+      "num-iter", po::value<uint32_t>(&num_iterations)->default_value(100),
+      "allocations per thread of each measurement")(
+      "trace-length", po::value<uint32_t>(&trace_length)->default_value(10000),
+      "allocations in the fragmentation trace")(
+      "trace-min-size",
+      po::value<size_t>(&trace_min_size)->default_value(64),
+      "smallest allocation size of the fragmentation trace")(
+      "trace-max-size",
+      po::value<size_t>(&trace_max_size)->default_value(1u << 24),
+      "largest allocation size of the fragmentation trace")(
+      "trace-max-lifetime",
+      po::value<uint32_t>(&trace_max_lifetime)->default_value(1000),
+      "longest lifetime in the fragmentation trace, counted in allocations")(
+      "trace-seed", po::value<uint32_t>(&trace_seed)->default_value(1),
+      "seed of the fragmentation trace")(
+      "json-output-file", po::value<std::string>(&json_file_name),
+      "test output format file name to be specified");
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  if (memory == "device") {
+    memories = {AllocMemory::device};
+  } else if (memory == "host") {
+    memories = {AllocMemory::host};
+  } else if (memory == "shared") {
+    memories = {AllocMemory::shared};
+  }
+
+  if (vm.count("help")) {
+    std::cout << desc << std::endl;
+    return 1;
+  } else if ((memory != "all") && (memory != "device") && (memory != "host") &&
+             (memory != "shared")) {
+    std::cout << "unknown memory" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if (!min_size || !fixed_size || !max_threads || !num_iterations ||
+             !trace_max_lifetime) {
+    std::cout << "sizes, counts and lifetimes must be at least 1"
+              << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if (min_size > max_size) {
+    std::cout << "min-size must be at most max-size" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if (!trace_min_size || (trace_min_size > trace_max_size)) {
+    std::cout << "trace-min-size must be at least 1 and at most "
+                 "trace-max-size"
+              << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  }
+  return 0;
+}
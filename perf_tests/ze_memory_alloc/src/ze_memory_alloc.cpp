@@ -0,0 +1,375 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_memory_alloc.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <thread>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+namespace pt = boost::property_tree;
+
+std::string to_string(const AllocMemory memory) {
+  switch (memory) {
+  case AllocMemory::device:
+    return "device";
+  case AllocMemory::host:
+    return "host";
+  case AllocMemory::shared:
+    return "shared";
+  }
+  return "unknown";
+}
+
+LatencyDistribution compute_distribution(std::vector<long double> &samples) {
+  LatencyDistribution distribution;
+  if (samples.empty())
+    return distribution;
+
+  std::sort(samples.begin(), samples.end());
+  auto percentile = [&samples](long double fraction) {
+    size_t index = static_cast<size_t>(fraction * samples.size());
+    return samples[std::min(index, samples.size() - 1)];
+  };
+  distribution.min = samples.front();
+  distribution.p50 = percentile(0.50);
+  distribution.p90 = percentile(0.90);
+  distribution.p99 = percentile(0.99);
+  distribution.max = samples.back();
+  return distribution;
+}
+
+ZeMemoryAlloc::ZeMemoryAlloc() {
+  benchmark = new ZeApp();
+  benchmark->singleDeviceInit();
+}
+
+ZeMemoryAlloc::~ZeMemoryAlloc() {
+  benchmark->singleDeviceCleanup();
+  delete benchmark;
+}
+
+/* Unlike ZeApp, a failed allocation is reported so the sweeps can carry on
+ * past sizes the driver refuses */
+bool ZeMemoryAlloc::allocate(AllocMemory memory, size_t size,
+                             size_t alignment, void **ptr) {
+  ze_device_mem_alloc_desc_t device_desc;
+  device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  device_desc.ordinal = 0;
+  device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  ze_host_mem_alloc_desc_t host_desc;
+  host_desc.version = ZE_HOST_MEM_ALLOC_DESC_VERSION_CURRENT;
+  host_desc.flags = ZE_HOST_MEM_ALLOC_FLAG_DEFAULT;
+
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  switch (memory) {
+  case AllocMemory::device:
+    result = zeDriverAllocDeviceMem(benchmark->driver, &device_desc, size,
+                                    alignment, benchmark->device, ptr);
+    break;
+  case AllocMemory::host:
+    result = zeDriverAllocHostMem(benchmark->driver, &host_desc, size,
+                                  alignment, ptr);
+    break;
+  case AllocMemory::shared:
+    result = zeDriverAllocSharedMem(benchmark->driver, &device_desc,
+                                    &host_desc, size, alignment,
+                                    benchmark->device, ptr);
+    break;
+  }
+  return (result == ZE_RESULT_SUCCESS);
+}
+
+void ZeMemoryAlloc::release(void *ptr) {
+  SUCCESS_OR_TERMINATE(zeDriverFreeMem(benchmark->driver, ptr));
+}
+
+/* The size the driver actually set aside for an allocation, falling back to
+ * the requested size when the driver does not report it */
+size_t ZeMemoryAlloc::reserved_size(void *ptr, size_t size) {
+  void *base = nullptr;
+  size_t range_size = 0;
+  if ((zeDriverGetMemAddressRange(benchmark->driver, ptr, &base,
+                                  &range_size) != ZE_RESULT_SUCCESS) ||
+      (range_size < size)) {
+    return size;
+  }
+  return range_size;
+}
+
+/* Every thread allocates and frees one buffer at a time, timing each call */
+AllocResult ZeMemoryAlloc::measure(AllocMemory memory, size_t size,
+                                   size_t alignment, uint32_t threads) {
+  std::vector<std::vector<long double>> alloc_samples(threads);
+  std::vector<std::vector<long double>> free_samples(threads);
+  std::vector<int> failed(threads, 0);
+
+  auto worker = [&](uint32_t id) {
+    Timer<std::chrono::microseconds::period> timer;
+    for (uint32_t i = 0; i < num_iterations; i++) {
+      void *ptr = nullptr;
+      timer.start();
+      const bool allocated = allocate(memory, size, alignment, &ptr);
+      timer.end();
+      if (!allocated) {
+        failed[id] = 1;
+        return;
+      }
+      alloc_samples[id].push_back(timer.period_minus_overhead());
+
+      timer.start();
+      release(ptr);
+      timer.end();
+      free_samples[id].push_back(timer.period_minus_overhead());
+    }
+  };
+
+  Timer<std::chrono::microseconds::period> wall_timer;
+  wall_timer.start();
+  std::vector<std::thread> workers;
+  for (uint32_t id = 0; id < threads; id++) {
+    workers.push_back(std::thread(worker, id));
+  }
+  for (auto &thread : workers) {
+    thread.join();
+  }
+  wall_timer.end();
+
+  AllocResult result;
+  std::vector<long double> all_alloc;
+  std::vector<long double> all_free;
+  for (uint32_t id = 0; id < threads; id++) {
+    result.failed = result.failed || failed[id];
+    all_alloc.insert(all_alloc.end(), alloc_samples[id].begin(),
+                     alloc_samples[id].end());
+    all_free.insert(all_free.end(), free_samples[id].begin(),
+                    free_samples[id].end());
+  }
+  result.alloc = compute_distribution(all_alloc);
+  result.free = compute_distribution(all_free);
+  result.pairs_per_sec =
+      all_free.size() / (wall_timer.period_minus_overhead() / 1e6L);
+  return result;
+}
+
+/*
+ * Replays a random trace of allocations with log-uniform sizes and uniform
+ * lifetimes, counted in allocations. Allocations whose lifetime is over are
+ * freed before each new one. The trace depends only on the seed, so every
+ * memory type replays the same one.
+ */
+TraceResult ZeMemoryAlloc::replay_trace(AllocMemory memory) {
+  struct LiveAllocation {
+    void *ptr;
+    size_t size;
+    size_t reserved;
+  };
+
+  std::mt19937_64 generator(trace_seed);
+  std::uniform_real_distribution<double> log_size(
+      std::log(static_cast<double>(trace_min_size)),
+      std::log(static_cast<double>(trace_max_size)));
+  std::uniform_int_distribution<uint32_t> lifetime(1, trace_max_lifetime);
+
+  Timer<std::chrono::microseconds::period> timer;
+  std::multimap<uint32_t, LiveAllocation> live;
+  std::vector<long double> alloc_samples;
+  std::vector<long double> free_samples;
+  uint64_t live_size = 0;
+  uint64_t reserved = 0;
+  TraceResult result;
+
+  for (uint32_t step = 0; step < trace_length; step++) {
+    while (!live.empty() && (live.begin()->first <= step)) {
+      const LiveAllocation &allocation = live.begin()->second;
+      timer.start();
+      release(allocation.ptr);
+      timer.end();
+      free_samples.push_back(timer.period_minus_overhead());
+      live_size -= allocation.size;
+      reserved -= allocation.reserved;
+      live.erase(live.begin());
+    }
+
+    const size_t size = static_cast<size_t>(std::exp(log_size(generator)));
+    const uint32_t expiry = step + lifetime(generator);
+    void *ptr = nullptr;
+    timer.start();
+    const bool allocated = allocate(memory, size, 1, &ptr);
+    timer.end();
+    if (!allocated) {
+      result.failed = true;
+      break;
+    }
+    alloc_samples.push_back(timer.period_minus_overhead());
+
+    LiveAllocation allocation = {ptr, size, reserved_size(ptr, size)};
+    live.insert(std::make_pair(expiry, allocation));
+    live_size += allocation.size;
+    reserved += allocation.reserved;
+    result.peak_live_size = std::max(result.peak_live_size, live_size);
+    result.peak_reserved_size = std::max(result.peak_reserved_size, reserved);
+  }
+
+  for (auto &entry : live) {
+    release(entry.second.ptr);
+  }
+
+  result.allocations = alloc_samples.size();
+  result.alloc = compute_distribution(alloc_samples);
+  result.free = compute_distribution(free_samples);
+  return result;
+}
+
+static void print_header(const std::string &first_column) {
+  std::cout << std::right << std::setw(12) << first_column << std::setw(10)
+            << "alloc p50" << std::setw(10) << "p90" << std::setw(10)
+            << "p99" << std::setw(10) << "max" << std::setw(10)
+            << "free p50" << std::setw(10) << "p99" << std::setw(12)
+            << "pairs/sec" << std::endl;
+}
+
+static void print_row(const std::string &first_column,
+                      const AllocResult &result) {
+  std::cout << std::setw(12) << first_column;
+  if (result.failed) {
+    std::cout << "  allocation failed" << std::endl;
+    return;
+  }
+  std::cout << std::fixed << std::setprecision(2) << std::setw(10)
+            << result.alloc.p50 << std::setw(10) << result.alloc.p90
+            << std::setw(10) << result.alloc.p99 << std::setw(10)
+            << result.alloc.max << std::setw(10) << result.free.p50
+            << std::setw(10) << result.free.p99 << std::setw(12)
+            << std::setprecision(0) << result.pairs_per_sec << std::endl;
+}
+
+static pt::ptree to_ptree(const LatencyDistribution &distribution) {
+  pt::ptree distribution_ptree;
+  distribution_ptree.put("Min", distribution.min);
+  distribution_ptree.put("P50", distribution.p50);
+  distribution_ptree.put("P90", distribution.p90);
+  distribution_ptree.put("P99", distribution.p99);
+  distribution_ptree.put("Max", distribution.max);
+  return distribution_ptree;
+}
+
+static pt::ptree to_ptree(const AllocResult &result) {
+  pt::ptree result_ptree;
+  result_ptree.put("Failed", result.failed);
+  result_ptree.put_child("Alloc usec", to_ptree(result.alloc));
+  result_ptree.put_child("Free usec", to_ptree(result.free));
+  result_ptree.put("Pairs per sec", result.pairs_per_sec);
+  return result_ptree;
+}
+
+int main(int argc, char **argv) {
+  ZeMemoryAlloc alloc;
+  SUCCESS_OR_TERMINATE(alloc.parse_command_line(argc, argv));
+
+  std::cout << "Allocation and free latency in usec" << std::endl;
+
+  pt::ptree memory_array;
+  for (auto memory : alloc.memories) {
+    pt::ptree memory_ptree;
+    memory_ptree.put("Memory", to_string(memory));
+
+    std::cout << std::endl
+              << to_string(memory) << " memory by size, alignment 1, 1 thread"
+              << std::endl;
+    print_header("Size");
+    pt::ptree size_array;
+    // Steps of 16x, the last one clamped so that max-size is measured too
+    size_t size = alloc.min_size;
+    while (true) {
+      const AllocResult result = alloc.measure(memory, size, 1, 1);
+      print_row(std::to_string(size), result);
+      pt::ptree row = to_ptree(result);
+      row.put("Size", size);
+      size_array.push_back(std::make_pair("", row));
+      if (size >= alloc.max_size)
+        break;
+      size = std::min(size * 16, alloc.max_size);
+    }
+    memory_ptree.put_child("Sizes", size_array);
+
+    std::cout << std::endl
+              << to_string(memory) << " memory by alignment, size "
+              << alloc.fixed_size << ", 1 thread" << std::endl;
+    print_header("Alignment");
+    pt::ptree alignment_array;
+    for (auto alignment : memory_allocation_alignments) {
+      const AllocResult result =
+          alloc.measure(memory, alloc.fixed_size, alignment, 1);
+      print_row(std::to_string(alignment), result);
+      pt::ptree row = to_ptree(result);
+      row.put("Alignment", alignment);
+      alignment_array.push_back(std::make_pair("", row));
+    }
+    memory_ptree.put_child("Alignments", alignment_array);
+
+    std::cout << std::endl
+              << to_string(memory) << " memory by thread count, size "
+              << alloc.fixed_size << ", alignment 1" << std::endl;
+    print_header("Threads");
+    pt::ptree thread_array;
+    for (uint32_t threads = 1; threads <= alloc.max_threads; threads *= 2) {
+      const AllocResult result =
+          alloc.measure(memory, alloc.fixed_size, 1, threads);
+      print_row(std::to_string(threads), result);
+      pt::ptree row = to_ptree(result);
+      row.put("Threads", threads);
+      thread_array.push_back(std::make_pair("", row));
+    }
+    memory_ptree.put_child("Threads", thread_array);
+
+    const TraceResult trace = alloc.replay_trace(memory);
+    const long double peak_to_live =
+        trace.peak_live_size ? static_cast<long double>(
+                                   trace.peak_reserved_size) /
+                                   trace.peak_live_size
+                             : 0;
+    std::cout << std::endl
+              << to_string(memory) << " memory fragmentation trace, "
+              << trace.allocations << " allocations"
+              << (trace.failed ? ", stopped at a failed allocation" : "")
+              << std::endl
+              << std::fixed << std::setprecision(2)
+              << "  alloc p50 " << trace.alloc.p50 << " p99 "
+              << trace.alloc.p99 << ", free p50 " << trace.free.p50
+              << " p99 " << trace.free.p99 << std::endl
+              << "  peak live " << trace.peak_live_size << " bytes, peak "
+              << "reserved " << trace.peak_reserved_size
+              << " bytes, peak to live " << peak_to_live << std::endl;
+
+    pt::ptree trace_ptree;
+    trace_ptree.put("Allocations", trace.allocations);
+    trace_ptree.put("Failed", trace.failed);
+    trace_ptree.put_child("Alloc usec", to_ptree(trace.alloc));
+    trace_ptree.put_child("Free usec", to_ptree(trace.free));
+    trace_ptree.put("Peak live size", trace.peak_live_size);
+    trace_ptree.put("Peak reserved size", trace.peak_reserved_size);
+    trace_ptree.put("Peak to live", peak_to_live);
+    memory_ptree.put_child("Trace", trace_ptree);
+
+    memory_array.push_back(std::make_pair("", memory_ptree));
+  }
+
+  if (!alloc.json_file_name.empty()) {
+    pt::ptree main_tree;
+    main_tree.put_child("Memories", memory_array);
+    pt::write_json(alloc.json_file_name, main_tree);
+  }
+  return 0;
+}
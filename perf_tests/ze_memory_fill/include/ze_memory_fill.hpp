@@ -0,0 +1,69 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_MEMORY_FILL_HPP_
+#define _ZE_MEMORY_FILL_HPP_
+
+#include <level_zero/ze_api.h>
+#include "common.hpp"
+#include "ze_app.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class FillMemory { device, host, shared };
+
+std::string to_string(const FillMemory memory);
+
+/* Pattern sizes accepted by zeCommandListAppendMemoryFill */
+const std::vector<size_t> fill_pattern_sizes = {1, 2, 4, 8, 16, 32, 64, 128};
+
+/* Fills below this fraction of the fastest fill of a buffer are reported
+ * as off the fast path */
+const long double fast_path_fraction = 0.5;
+
+class ZeMemoryFill {
+public:
+  ZeMemoryFill();
+  ~ZeMemoryFill();
+  int parse_command_line(int argc, char **argv);
+  uint64_t device_memory_size();
+  bool allocate(FillMemory memory, size_t size, void **ptr);
+  void release(void *ptr) { benchmark->memoryFree(ptr); }
+  long double measure_fill(void *buffer, size_t size, size_t pattern_size);
+  long double measure_kernel_fill(void *buffer, size_t size,
+                                  size_t pattern_size);
+  bool has_fill_kernel() const { return fill_kernel != nullptr; }
+
+  std::vector<FillMemory> memories = {FillMemory::device, FillMemory::host,
+                                      FillMemory::shared};
+  size_t min_size = 4096;
+  size_t max_size = (1ull << 30);
+  uint32_t warm_up_iterations = 2;
+  uint32_t num_iterations = 20;
+  std::string json_file_name;
+  bool all_valid = true;
+
+private:
+  void load_kernels();
+  long double run_command_list(size_t size);
+  bool verify(void *buffer, size_t size, size_t pattern_size);
+  void make_pattern(size_t pattern_size, std::vector<uint8_t> &pattern);
+
+  ZeApp *benchmark;
+  ze_command_queue_handle_t command_queue;
+  ze_command_list_handle_t command_list;
+  ze_module_handle_t module = nullptr;
+  ze_kernel_handle_t fill_kernel = nullptr;
+  uint32_t max_group_count = 1;
+  void *kernel_pattern = nullptr;
+  void *verify_buffer = nullptr;
+};
+
+#endif /* _ZE_MEMORY_FILL_HPP_ */
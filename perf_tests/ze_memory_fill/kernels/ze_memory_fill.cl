@@ -0,0 +1,25 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+/*
+ * Fill count 16 byte elements with a repeating pattern of pattern_count
+ * elements, walking the buffer with a grid-sized stride.
+ */
+__kernel void fill_pattern(__global uint4 *dst, __global const uint4 *pattern,
+                           uint pattern_count, ulong count) {
+  const size_t stride = get_global_size(0);
+
+  if (pattern_count == 1) {
+    const uint4 value = pattern[0];
+    for (size_t i = get_global_id(0); i < count; i += stride)
+      dst[i] = value;
+  } else {
+    for (size_t i = get_global_id(0); i < count; i += stride)
+      dst[i] = pattern[i % pattern_count];
+  }
+}
@@ -0,0 +1,65 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_memory_fill.hpp"
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+int ZeMemoryFill::parse_command_line(int argc, char **argv) {
+  std::string memory = "all";
+
+  po::options_description desc("Allowed options");
+  desc.add_options()("help", "produce help message")(
+      "memory", po::value<std::string>(&memory),
+      "destination memory, device/host/shared/all")(
+      "min-size", po::value<size_t>(&min_size)->default_value(4096),
+      "smallest buffer size in bytes, multiplied by 4 up to max-size")(
+      "max-size", po::value<size_t>(&max_size)->default_value(1ull << 30),
+      "largest buffer size in bytes, 0 for the device memory size")(
+      "warmup", po::value<uint32_t>(&warm_up_iterations)->default_value(2),
+      "set number of warmup iterations")(
+      "num-iter", po::value<uint32_t>(&num_iterations)->default_value(20),
+      "set number of iterations")(
+      "json-output-file", po::value<std::string>(&json_file_name),
+      "test output format file name to be specified");
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  if (memory == "device") {
+    memories = {FillMemory::device};
+  } else if (memory == "host") {
+    memories = {FillMemory::host};
+  } else if (memory == "shared") {
+    memories = {FillMemory::shared};
+  }
+
+  if (vm.count("help")) {
+    std::cout << desc << std::endl;
+    return 1;
+  } else if ((memory != "all") && (memory != "device") && (memory != "host") &&
+             (memory != "shared")) {
+    std::cout << "unknown memory" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if ((min_size < fill_pattern_sizes.back()) ||
+             (min_size % fill_pattern_sizes.back() != 0)) {
+    std::cout << "min-size must be a multiple of "
+              << fill_pattern_sizes.back() << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if (!num_iterations) {
+    std::cout << "number of iterations must be at least 1" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  }
+  return 0;
+}
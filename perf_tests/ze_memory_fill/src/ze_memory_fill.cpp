@@ -0,0 +1,387 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_memory_fill.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+namespace pt = boost::property_tree;
+
+/* Bytes checked at each end of a filled buffer */
+static const size_t verify_size = 4096;
+
+std::string to_string(const FillMemory memory) {
+  switch (memory) {
+  case FillMemory::device:
+    return "device";
+  case FillMemory::host:
+    return "host";
+  case FillMemory::shared:
+    return "shared";
+  }
+  return "unknown";
+}
+
+ZeMemoryFill::ZeMemoryFill() {
+  benchmark = new ZeApp();
+  benchmark->singleDeviceInit();
+
+  benchmark->commandQueueCreate(0, &command_queue);
+  benchmark->commandListCreate(&command_list);
+  benchmark->memoryAllocHost(2 * verify_size, &verify_buffer);
+
+  ze_device_properties_t device_properties;
+  device_properties.version = ZE_DEVICE_PROPERTIES_VERSION_CURRENT;
+  SUCCESS_OR_TERMINATE(
+      zeDeviceGetProperties(benchmark->device, &device_properties));
+  max_group_count = std::max(
+      1u, device_properties.numSlices * device_properties.numSubslicesPerSlice *
+              device_properties.numEUsPerSubslice *
+              device_properties.numThreadsPerEU);
+
+  load_kernels();
+}
+
+ZeMemoryFill::~ZeMemoryFill() {
+  if (fill_kernel) {
+    benchmark->functionDestroy(fill_kernel);
+    benchmark->moduleDestroy(module);
+    benchmark->memoryFree(kernel_pattern);
+  }
+  benchmark->memoryFree(verify_buffer);
+  benchmark->commandListDestroy(command_list);
+  benchmark->commandQueueDestroy(command_queue);
+  benchmark->singleDeviceCleanup();
+
+  delete benchmark;
+}
+
+/* The kernel fill is skipped rather than failing the run when the fill
+ * kernel cannot be loaded */
+void ZeMemoryFill::load_kernels() {
+  std::ifstream stream("ze_memory_fill.spv", std::ios::in | std::ios::binary);
+  std::vector<uint8_t> binary_file((std::istreambuf_iterator<char>(stream)),
+                                   std::istreambuf_iterator<char>());
+  if (binary_file.empty()) {
+    std::cerr << "WARNING : ze_memory_fill.spv not found, kernel fills "
+                 "skipped"
+              << std::endl;
+    return;
+  }
+
+  ze_module_desc_t module_description;
+  module_description.version = ZE_MODULE_DESC_VERSION_CURRENT;
+  module_description.format = ZE_MODULE_FORMAT_IL_SPIRV;
+  module_description.inputSize = binary_file.size();
+  module_description.pInputModule = binary_file.data();
+  module_description.pBuildFlags = nullptr;
+  ze_result_t result = zeModuleCreate(benchmark->device, &module_description,
+                                      &module, nullptr);
+  if (result) {
+    std::cerr << "WARNING : zeModuleCreate failed, kernel fills skipped : "
+              << result << std::endl;
+    module = nullptr;
+    return;
+  }
+
+  benchmark->functionCreate(module, &fill_kernel, "fill_pattern");
+  benchmark->memoryAllocHost(fill_pattern_sizes.back(), &kernel_pattern);
+}
+
+uint64_t ZeMemoryFill::device_memory_size() {
+  uint32_t count = 0;
+  SUCCESS_OR_TERMINATE(
+      zeDeviceGetMemoryProperties(benchmark->device, &count, nullptr));
+
+  std::vector<ze_device_memory_properties_t> properties(count);
+  for (auto &property : properties) {
+    property.version = ZE_DEVICE_MEMORY_PROPERTIES_VERSION_CURRENT;
+  }
+  SUCCESS_OR_TERMINATE(zeDeviceGetMemoryProperties(benchmark->device, &count,
+                                                   properties.data()));
+
+  uint64_t total_size = 0;
+  for (const auto &property : properties) {
+    total_size = std::max(total_size, property.totalSize);
+  }
+  return total_size;
+}
+
+/* Unlike ZeApp, a failed allocation is reported so the sweep can stop at
+ * the largest buffer the device accepts */
+bool ZeMemoryFill::allocate(FillMemory memory, size_t size, void **ptr) {
+  ze_device_mem_alloc_desc_t device_desc;
+  device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  device_desc.ordinal = 0;
+  device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  ze_host_mem_alloc_desc_t host_desc;
+  host_desc.version = ZE_HOST_MEM_ALLOC_DESC_VERSION_CURRENT;
+  host_desc.flags = ZE_HOST_MEM_ALLOC_FLAG_DEFAULT;
+
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  switch (memory) {
+  case FillMemory::device:
+    result = zeDriverAllocDeviceMem(benchmark->driver, &device_desc, size, 1,
+                                    benchmark->device, ptr);
+    break;
+  case FillMemory::host:
+    result =
+        zeDriverAllocHostMem(benchmark->driver, &host_desc, size, 1, ptr);
+    break;
+  case FillMemory::shared:
+    result = zeDriverAllocSharedMem(benchmark->driver, &device_desc,
+                                    &host_desc, size, 1, benchmark->device,
+                                    ptr);
+    break;
+  }
+  return (result == ZE_RESULT_SUCCESS);
+}
+
+void ZeMemoryFill::make_pattern(size_t pattern_size,
+                                std::vector<uint8_t> &pattern) {
+  pattern.resize(pattern_size);
+  for (size_t i = 0; i < pattern_size; i++) {
+    pattern[i] = static_cast<uint8_t>(0x5a + i * 29);
+  }
+}
+
+/* Checks both ends of the buffer rather than all of a multi-GB fill */
+bool ZeMemoryFill::verify(void *buffer, size_t size, size_t pattern_size) {
+  std::vector<uint8_t> pattern;
+  make_pattern(pattern_size, pattern);
+
+  const size_t head_size = std::min(size, verify_size);
+  const size_t tail_offset = size - head_size;
+  uint8_t *head = static_cast<uint8_t *>(verify_buffer);
+  uint8_t *tail = head + verify_size;
+
+  benchmark->commandListAppendMemoryCopy(command_list, head, buffer,
+                                         head_size);
+  benchmark->commandListAppendMemoryCopy(
+      command_list, tail, static_cast<uint8_t *>(buffer) + tail_offset,
+      head_size);
+  benchmark->commandListClose(command_list);
+  benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list);
+  benchmark->commandQueueSynchronize(command_queue);
+  benchmark->commandListReset(command_list);
+
+  for (size_t i = 0; i < head_size; i++) {
+    if ((head[i] != pattern[i % pattern_size]) ||
+        (tail[i] != pattern[(tail_offset + i) % pattern_size])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+long double ZeMemoryFill::run_command_list(size_t size) {
+  Timer<std::chrono::microseconds::period> timer;
+
+  benchmark->commandListClose(command_list);
+  for (uint32_t i = 0; i < warm_up_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list);
+    benchmark->commandQueueSynchronize(command_queue);
+  }
+
+  timer.start();
+  for (uint32_t i = 0; i < num_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list);
+    benchmark->commandQueueSynchronize(command_queue);
+  }
+  timer.end();
+  benchmark->commandListReset(command_list);
+
+  const long double total_time_usec = timer.period_minus_overhead();
+  return (static_cast<long double>(size) * num_iterations / 1e9L) /
+         (total_time_usec / 1e6L);
+}
+
+long double ZeMemoryFill::measure_fill(void *buffer, size_t size,
+                                       size_t pattern_size) {
+  std::vector<uint8_t> pattern;
+  make_pattern(pattern_size, pattern);
+
+  SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryFill(
+      command_list, buffer, pattern.data(), pattern_size, size, nullptr));
+  const long double gbps = run_command_list(size);
+
+  if (!verify(buffer, size, pattern_size)) {
+    std::cerr << "ERROR : " << size << " byte fill with a " << pattern_size
+              << " byte pattern failed verification" << std::endl;
+    all_valid = false;
+  }
+  return gbps;
+}
+
+long double ZeMemoryFill::measure_kernel_fill(void *buffer, size_t size,
+                                              size_t pattern_size) {
+  std::vector<uint8_t> pattern;
+  make_pattern(pattern_size, pattern);
+
+  /* The kernel writes 16 byte elements, so short patterns are repeated to
+   * fill one element */
+  const size_t element_size = 16;
+  const size_t expanded_size = std::max(pattern_size, element_size);
+  uint8_t *expanded = static_cast<uint8_t *>(kernel_pattern);
+  for (size_t i = 0; i < expanded_size; i++) {
+    expanded[i] = pattern[i % pattern_size];
+  }
+
+  const uint32_t pattern_count =
+      static_cast<uint32_t>(expanded_size / element_size);
+  const uint64_t count = size / element_size;
+  uint32_t group_size_x = 1;
+  uint32_t group_size_y = 1;
+  uint32_t group_size_z = 1;
+  SUCCESS_OR_TERMINATE(zeKernelSuggestGroupSize(
+      fill_kernel, static_cast<uint32_t>(std::min<uint64_t>(count, 256)), 1,
+      1, &group_size_x, &group_size_y, &group_size_z));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetGroupSize(fill_kernel, group_size_x, 1, 1));
+
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(fill_kernel, 0, sizeof(buffer), &buffer));
+  SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(
+      fill_kernel, 1, sizeof(kernel_pattern), &kernel_pattern));
+  SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(
+      fill_kernel, 2, sizeof(pattern_count), &pattern_count));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(fill_kernel, 3, sizeof(count), &count));
+
+  /* Enough groups to occupy the device, the kernel strides over the rest */
+  const uint64_t groups_needed = (count + group_size_x - 1) / group_size_x;
+  ze_group_count_t group_count = {
+      static_cast<uint32_t>(
+          std::min<uint64_t>(groups_needed, max_group_count)),
+      1, 1};
+  SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+      command_list, fill_kernel, &group_count, nullptr, 0, nullptr));
+  const long double gbps = run_command_list(size);
+
+  if (!verify(buffer, size, pattern_size)) {
+    std::cerr << "ERROR : " << size << " byte kernel fill with a "
+              << pattern_size << " byte pattern failed verification"
+              << std::endl;
+    all_valid = false;
+  }
+  return gbps;
+}
+
+static void print_row(size_t size, const std::vector<long double> &results,
+                      bool has_kernel) {
+  const long double fastest =
+      *std::max_element(results.begin(), results.end());
+
+  std::cout << std::setw(12) << size;
+  for (size_t i = 0; i < results.size(); i++) {
+    const bool slow = (results[i] < fastest * fast_path_fraction);
+    std::cout << std::setw(9) << std::fixed << std::setprecision(2)
+              << results[i] << (slow ? "*" : " ");
+  }
+  if (!has_kernel) {
+    std::cout << std::setw(10) << "-";
+  }
+  std::cout << std::endl;
+}
+
+int main(int argc, char **argv) {
+  ZeMemoryFill fill;
+  SUCCESS_OR_TERMINATE(fill.parse_command_line(argc, argv));
+
+  if (fill.max_size == 0) {
+    fill.max_size = fill.device_memory_size();
+  }
+
+  std::cout << "zeCommandListAppendMemoryFill GBPS per pattern size in bytes"
+            << std::endl
+            << "  1 byte patterns are what append_memory_set issues; kernel "
+               "is a grid-stride fill kernel with the 1 byte pattern"
+            << std::endl
+            << "  * marks fills below "
+            << static_cast<int>(fast_path_fraction * 100)
+            << "% of the fastest fill of the same buffer" << std::endl;
+
+  pt::ptree memory_array;
+  for (auto memory : fill.memories) {
+    std::cout << std::endl
+              << to_string(memory) << " memory" << std::endl
+              << std::right << std::setw(12) << "Size";
+    for (auto pattern_size : fill_pattern_sizes) {
+      std::cout << std::setw(10) << pattern_size;
+    }
+    std::cout << std::setw(10) << "kernel" << std::endl;
+
+    pt::ptree size_array;
+    std::vector<long double> largest_results;
+    for (size_t size = fill.min_size; size <= fill.max_size; size *= 4) {
+      void *buffer = nullptr;
+      if (!fill.allocate(memory, size, &buffer)) {
+        std::cout << std::setw(12) << size
+                  << "  allocation failed, largest buffer reached"
+                  << std::endl;
+        break;
+      }
+
+      pt::ptree size_ptree;
+      size_ptree.put("Size", size);
+      std::vector<long double> results;
+      for (auto pattern_size : fill_pattern_sizes) {
+        results.push_back(fill.measure_fill(buffer, size, pattern_size));
+        size_ptree.put("Pattern " + std::to_string(pattern_size) + ".GBPS",
+                       results.back());
+      }
+      if (fill.has_fill_kernel()) {
+        results.push_back(fill.measure_kernel_fill(
+            buffer, size, fill_pattern_sizes.front()));
+        size_ptree.put("Kernel.GBPS", results.back());
+      }
+      fill.release(buffer);
+
+      print_row(size, results, fill.has_fill_kernel());
+      size_array.push_back(std::make_pair("", size_ptree));
+      largest_results = results;
+    }
+
+    /* The largest buffer is the zero-initialization case we care about */
+    if (!largest_results.empty()) {
+      const long double fastest =
+          *std::max_element(largest_results.begin(), largest_results.end());
+      std::stringstream slow_patterns;
+      for (size_t i = 0; i < fill_pattern_sizes.size(); i++) {
+        if (largest_results[i] < fastest * fast_path_fraction)
+          slow_patterns << " " << fill_pattern_sizes[i];
+      }
+      std::cout << "Off the fast path at the largest size:"
+                << (slow_patterns.str().empty() ? " none"
+                                                : slow_patterns.str())
+                << std::endl;
+    }
+
+    pt::ptree memory_ptree;
+    memory_ptree.put("Memory", to_string(memory));
+    memory_ptree.put_child("Sizes", size_array);
+    memory_array.push_back(std::make_pair("", memory_ptree));
+  }
+
+  if (!fill.all_valid) {
+    std::cout << "Data validation FAILED" << std::endl;
+  }
+
+  if (!fill.json_file_name.empty()) {
+    pt::ptree main_tree;
+    main_tree.put_child("Memories", memory_array);
+    pt::write_json(fill.json_file_name, main_tree);
+  }
+  return fill.all_valid ? 0 : 1;
+}
@@ -14,6 +14,10 @@
 /* ze includes */
 #include <level_zero/ze_api.h>
 
+#include "ze_power_monitor.hpp"
+
+#include <memory>
+
 #define MIN(X, Y) (X < Y) ? X : Y
 
 #undef FETCH_2
@@ -80,11 +84,20 @@ public:
   bool run_int_compute = true;
   bool run_transfer_bw = true;
   bool run_kernel_lat = true;
+  bool run_mem_latency = true;
+  bool run_local_bw = true;
+  bool run_atomics = true;
+  bool run_sub_group = true;
+  bool run_roofline = true;
+  bool run_dot_product = true;
+  bool run_gemm = true;
+  bool monitor_power = false;
   uint32_t specified_platform, specified_device;
   uint32_t global_bw_max_size = 1 << 29;
   uint32_t transfer_bw_max_size = 1 << 29;
   uint32_t iters = 50;
   uint32_t warmup_iterations = 10;
+  std::string roofline_json_file;
 
   int parse_arguments(int argc, char **argv);
 
@@ -100,9 +113,16 @@ public:
                       const char *name, void *input, void *output,
                       size_t outputSize = 0u);
   uint64_t get_max_work_items(L0Context &context);
+  long double get_peak_gflops(L0Context &context);
   void print_test_complete();
   void run_command_queue(L0Context &context);
   void synchronize_command_queue(L0Context &context);
+  void init_power_monitor(L0Context &context);
+  void begin_power_sample();
+  void end_power_sample();
+  void print_power_efficiency(long double rate, const char *unit);
+  void print_fraction_of_peak(long double rate, long double peak,
+                              const char *unit);
   /* Benchmark Functions*/
   void ze_peak_global_bw(L0Context &context);
   void ze_peak_kernel_latency(L0Context &context);
@@ -111,6 +131,13 @@ public:
   void ze_peak_dp_compute(L0Context &context);
   void ze_peak_int_compute(L0Context &context);
   void ze_peak_transfer_bw(L0Context &context);
+  void ze_peak_mem_latency(L0Context &context);
+  void ze_peak_local_bw(L0Context &context);
+  void ze_peak_atomics(L0Context &context);
+  void ze_peak_sub_group(L0Context &context);
+  void ze_peak_roofline(L0Context &context);
+  void ze_peak_dot_product(L0Context &context);
+  void ze_peak_gemm(L0Context &context);
 
 private:
   void _transfer_bw_gpu_copy(L0Context &context, void *destination_buffer,
@@ -119,8 +146,14 @@ private:
                               size_t buffer_size);
   void _transfer_bw_shared_memory(L0Context &context,
                                   std::vector<float> local_memory);
+  long double _chase_latency(L0Context &context, ze_kernel_handle_t &function,
+                             struct ZeWorkGroups &workgroup_info,
+                             void *position_buffer, uint32_t nodes);
   TimingMeasurement is_bandwidth_with_event_timer(void);
   long double calculate_gbps(long double period, long double buffer_size);
+
+  std::unique_ptr<ZePowerMonitor> power_monitor;
+  PowerSample power_sample;
 };
 
 uint64_t max_device_object_size(L0Context &context);
@@ -0,0 +1,132 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#define ATOMICS_PER_WI          16
+// Uncontended work-items each get their own 64 byte line of global memory
+#define GLOBAL_ATOMIC_STRIDE    16
+#define LOCAL_ATOMIC_COUNTERS   1024
+
+// Contended kernels have every work-item update the same counter,
+// uncontended kernels give every work-item its own
+__kernel void global_atomic_add_contended(volatile __global uint *counters, __global uint *output)
+{
+    uint value = 0;
+
+    for (uint i = 0; i < ATOMICS_PER_WI; i++)
+        value += atomic_add(&counters[0], 1);
+
+    output[get_global_id(0)] = value;
+}
+
+__kernel void global_atomic_add_uncontended(volatile __global uint *counters, __global uint *output)
+{
+    volatile __global uint *counter = &counters[get_global_id(0) * GLOBAL_ATOMIC_STRIDE];
+    uint value = 0;
+
+    for (uint i = 0; i < ATOMICS_PER_WI; i++)
+        value += atomic_add(counter, 1);
+
+    output[get_global_id(0)] = value;
+}
+
+// Exchanges are a compare-and-swap update loop: after a success the next
+// attempt expects the value it stored, after a failure the value it found.
+// Uncontended exchanges therefore always succeed. Contended ones mostly lose
+// the race and retry, their rate counts every attempt, as an update loop
+// pays for them.
+#define CMPXCHG_NEXT(old, expected)     (((old) == (expected)) ? (expected) + 1 : (old))
+
+__kernel void global_atomic_cmpxchg_contended(volatile __global uint *counters, __global uint *output)
+{
+    uint expected = counters[0];
+
+    for (uint i = 0; i < ATOMICS_PER_WI; i++) {
+        uint old = atomic_cmpxchg(&counters[0], expected, expected + 1);
+        expected = CMPXCHG_NEXT(old, expected);
+    }
+
+    output[get_global_id(0)] = expected;
+}
+
+__kernel void global_atomic_cmpxchg_uncontended(volatile __global uint *counters, __global uint *output)
+{
+    volatile __global uint *counter = &counters[get_global_id(0) * GLOBAL_ATOMIC_STRIDE];
+    // The counters keep their values from earlier launches
+    uint expected = *counter;
+
+    for (uint i = 0; i < ATOMICS_PER_WI; i++) {
+        uint old = atomic_cmpxchg(counter, expected, expected + 1);
+        expected = CMPXCHG_NEXT(old, expected);
+    }
+
+    output[get_global_id(0)] = expected;
+}
+
+__kernel void local_atomic_add_contended(volatile __global uint *counters, __global uint *output)
+{
+    volatile __local uint counter;
+    uint value = 0;
+
+    if (get_local_id(0) == 0)
+        counter = 0;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (uint i = 0; i < ATOMICS_PER_WI; i++)
+        value += atomic_add(&counter, 1);
+
+    output[get_global_id(0)] = value;
+}
+
+__kernel void local_atomic_add_uncontended(volatile __global uint *counters, __global uint *output)
+{
+    volatile __local uint local_counters[LOCAL_ATOMIC_COUNTERS];
+    volatile __local uint *counter = &local_counters[get_local_id(0) & (LOCAL_ATOMIC_COUNTERS - 1)];
+    uint value = 0;
+
+    *counter = 0;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (uint i = 0; i < ATOMICS_PER_WI; i++)
+        value += atomic_add(counter, 1);
+
+    output[get_global_id(0)] = value;
+}
+
+__kernel void local_atomic_cmpxchg_contended(volatile __global uint *counters, __global uint *output)
+{
+    volatile __local uint counter;
+    uint expected = 0;
+
+    if (get_local_id(0) == 0)
+        counter = 0;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (uint i = 0; i < ATOMICS_PER_WI; i++) {
+        uint old = atomic_cmpxchg(&counter, expected, expected + 1);
+        expected = CMPXCHG_NEXT(old, expected);
+    }
+
+    output[get_global_id(0)] = expected;
+}
+
+__kernel void local_atomic_cmpxchg_uncontended(volatile __global uint *counters, __global uint *output)
+{
+    volatile __local uint local_counters[LOCAL_ATOMIC_COUNTERS];
+    volatile __local uint *counter = &local_counters[get_local_id(0) & (LOCAL_ATOMIC_COUNTERS - 1)];
+    uint expected = 0;
+
+    *counter = 0;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (uint i = 0; i < ATOMICS_PER_WI; i++) {
+        uint old = atomic_cmpxchg(counter, expected, expected + 1);
+        expected = CMPXCHG_NEXT(old, expected);
+    }
+
+    output[get_global_id(0)] = expected;
+}
@@ -0,0 +1,239 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// input_value[0] holds 4 packed int8, input_value[1] holds 2 packed bf16.
+// Every step feeds its result back into an operand of its own chain so that
+// nothing can be hoisted out of the loop. The chains start from different
+// values and are interleaved, so the steps of one chain wait on each other
+// but the chains issue back to back and the loop measures throughput.
+#define DOT_ITERATIONS      256
+#define DPAS_ITERATIONS     64
+#define DOT_CHAINS          8
+#define DPAS_CHAINS         4
+
+// 4 int8 multiply-adds, widened to int by hand
+#define DOT_INT8_EMULATED(x, y)     ((int)(x).s0 * (y).s0 + (int)(x).s1 * (y).s1 + \
+                                     (int)(x).s2 * (y).s2 + (int)(x).s3 * (y).s3)
+
+// bf16 is the upper half of a float
+#define BF16_LO(x)                  as_float((x) << 16)
+#define BF16_HI(x)                  as_float((x) & 0xffff0000)
+#define BF16_PACK2(f)               ((as_uint(f) >> 16) * 0x00010001)
+
+__kernel void dot_int8_emulated(__global uint *input_value, __global int *output)
+{
+    char4 x[DOT_CHAINS];
+    char4 y = as_char4(input_value[0] + (uint)get_local_id(0));
+    int acc[DOT_CHAINS];
+    int sum = 0;
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DOT_CHAINS; c++) {
+        x[c] = as_char4(input_value[0] + c);
+        acc[c] = 0;
+    }
+
+    for (uint i = 0; i < DOT_ITERATIONS; i += DOT_CHAINS) {
+        __attribute__((opencl_unroll_hint))
+        for (uint c = 0; c < DOT_CHAINS; c++) {
+            acc[c] += DOT_INT8_EMULATED(x[c], y);
+            x[c] = as_char4(acc[c]);
+        }
+    }
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DOT_CHAINS; c++)
+        sum += acc[c];
+
+    output[get_global_id(0)] = sum;
+}
+
+#if defined(__opencl_c_integer_dot_product_input_4x8bit)
+__kernel void dot_int8_builtin(__global uint *input_value, __global int *output)
+{
+    char4 x[DOT_CHAINS];
+    char4 y = as_char4(input_value[0] + (uint)get_local_id(0));
+    int acc[DOT_CHAINS];
+    int sum = 0;
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DOT_CHAINS; c++) {
+        x[c] = as_char4(input_value[0] + c);
+        acc[c] = 0;
+    }
+
+    for (uint i = 0; i < DOT_ITERATIONS; i += DOT_CHAINS) {
+        __attribute__((opencl_unroll_hint))
+        for (uint c = 0; c < DOT_CHAINS; c++) {
+            acc[c] += dot(x[c], y);
+            x[c] = as_char4(acc[c]);
+        }
+    }
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DOT_CHAINS; c++)
+        sum += acc[c];
+
+    output[get_global_id(0)] = sum;
+}
+#else
+#warning "integer dot product built-ins are not available, dot_int8_builtin is not built"
+#endif
+
+#if defined(__opencl_c_integer_dot_product_input_4x8bit_packed)
+__kernel void dot_int8_packed(__global uint *input_value, __global int *output)
+{
+    uint x[DOT_CHAINS];
+    uint y = input_value[0] + (uint)get_local_id(0);
+    int acc[DOT_CHAINS];
+    int sum = 0;
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DOT_CHAINS; c++) {
+        x[c] = input_value[0] + c;
+        acc[c] = 0;
+    }
+
+    for (uint i = 0; i < DOT_ITERATIONS; i += DOT_CHAINS) {
+        __attribute__((opencl_unroll_hint))
+        for (uint c = 0; c < DOT_CHAINS; c++) {
+            acc[c] += dot_4x8packed_ss_int(x[c], y);
+            x[c] = as_uint(acc[c]);
+        }
+    }
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DOT_CHAINS; c++)
+        sum += acc[c];
+
+    output[get_global_id(0)] = sum;
+}
+#else
+#warning "packed integer dot product built-ins are not available, dot_int8_packed is not built"
+#endif
+
+__kernel void dot_bf16_emulated(__global uint *input_value, __global float *output)
+{
+    uint x[DOT_CHAINS];
+    uint y = input_value[1] + (uint)get_local_id(0);
+    float acc[DOT_CHAINS];
+    float sum = 0.0f;
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DOT_CHAINS; c++) {
+        x[c] = input_value[1] + c;
+        acc[c] = 0.0f;
+    }
+
+    for (uint i = 0; i < DOT_ITERATIONS; i += DOT_CHAINS) {
+        __attribute__((opencl_unroll_hint))
+        for (uint c = 0; c < DOT_CHAINS; c++) {
+            acc[c] = fma(BF16_LO(x[c]), BF16_LO(y), acc[c]);
+            acc[c] = fma(BF16_HI(x[c]), BF16_HI(y), acc[c]);
+            x[c] = BF16_PACK2(acc[c]);
+        }
+    }
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DOT_CHAINS; c++)
+        sum += acc[c];
+
+    output[get_global_id(0)] = sum;
+}
+
+#if defined(cl_intel_bfloat16_conversions)
+__kernel void dot_bf16_builtin(__global uint *input_value, __global float *output)
+{
+    ushort2 x[DOT_CHAINS];
+    float2 y = intel_convert_as_bfloat162_float2(as_ushort2(input_value[1] + (uint)get_local_id(0)));
+    float acc[DOT_CHAINS];
+    float sum = 0.0f;
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DOT_CHAINS; c++) {
+        x[c] = as_ushort2(input_value[1] + c);
+        acc[c] = 0.0f;
+    }
+
+    for (uint i = 0; i < DOT_ITERATIONS; i += DOT_CHAINS) {
+        __attribute__((opencl_unroll_hint))
+        for (uint c = 0; c < DOT_CHAINS; c++) {
+            float2 fx = intel_convert_as_bfloat162_float2(x[c]);
+            acc[c] = fma(fx.s0, y.s0, acc[c]);
+            acc[c] = fma(fx.s1, y.s1, acc[c]);
+            x[c] = intel_convert_bfloat162_as_ushort2((float2)(acc[c]));
+        }
+    }
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DOT_CHAINS; c++)
+        sum += acc[c];
+
+    output[get_global_id(0)] = sum;
+}
+#else
+#warning "bf16 conversion built-ins are not available, dot_bf16_builtin is not built"
+#endif
+
+// Matrix engine: each call is an 8x8 tile of multiply-adds shared by the
+// 8 work-items of the sub-group, with K = 32 for int8 and K = 16 for bf16
+#if defined(cl_intel_subgroup_matrix_multiply_accumulate)
+__attribute__((intel_reqd_sub_group_size(8)))
+__kernel void dpas_int8(__global uint *input_value, __global int *output)
+{
+    short8 a = (short8)(as_short2(input_value[0]).s0);
+    int8 b = (int8)(input_value[0] + (uint)get_local_id(0));
+    int8 acc[DPAS_CHAINS];
+    int8 sum = 0;
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DPAS_CHAINS; c++)
+        acc[c] = (int8)(c);
+
+    for (uint i = 0; i < DPAS_ITERATIONS; i += DPAS_CHAINS) {
+        __attribute__((opencl_unroll_hint))
+        for (uint c = 0; c < DPAS_CHAINS; c++)
+            acc[c] = intel_sub_group_i8_i8_matrix_mad_k32(a, b, acc[c]);
+    }
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DPAS_CHAINS; c++)
+        sum += acc[c];
+
+    output[get_global_id(0)] = sum.s0 + sum.s1 + sum.s2 + sum.s3 +
+                               sum.s4 + sum.s5 + sum.s6 + sum.s7;
+}
+
+__attribute__((intel_reqd_sub_group_size(8)))
+__kernel void dpas_bf16(__global uint *input_value, __global float *output)
+{
+    int8 a = (int8)(input_value[1]);
+    int8 b = (int8)(input_value[1] + (uint)get_local_id(0));
+    float8 acc[DPAS_CHAINS];
+    float8 sum = 0.0f;
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DPAS_CHAINS; c++)
+        acc[c] = (float8)(c);
+
+    for (uint i = 0; i < DPAS_ITERATIONS; i += DPAS_CHAINS) {
+        __attribute__((opencl_unroll_hint))
+        for (uint c = 0; c < DPAS_CHAINS; c++)
+            acc[c] = intel_sub_group_bf16_bf16_matrix_mad_k16(a, b, acc[c]);
+    }
+
+    __attribute__((opencl_unroll_hint))
+    for (uint c = 0; c < DPAS_CHAINS; c++)
+        sum += acc[c];
+
+    output[get_global_id(0)] = sum.s0 + sum.s1 + sum.s2 + sum.s3 +
+                               sum.s4 + sum.s5 + sum.s6 + sum.s7;
+}
+#else
+#warning "sub-group matrix multiply-accumulate is not available, dpas kernels are not built"
+#endif
@@ -0,0 +1,42 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#define GEMM_TILE   16
+
+// c = a * b for square n x n row-major matrices, n a multiple of GEMM_TILE.
+// Each work-group stages one GEMM_TILE x GEMM_TILE tile of a and of b in
+// local memory per step along k.
+#define GEMM_KERNEL(name, in_type, acc_type)                                                    \
+__attribute__((reqd_work_group_size(GEMM_TILE, GEMM_TILE, 1)))                                  \
+__kernel void name(__global const in_type *a, __global const in_type *b,                        \
+                   __global acc_type *c, uint n)                                                \
+{                                                                                               \
+    __local in_type a_tile[GEMM_TILE][GEMM_TILE];                                               \
+    __local in_type b_tile[GEMM_TILE][GEMM_TILE];                                               \
+    const uint col = get_global_id(0);                                                          \
+    const uint row = get_global_id(1);                                                          \
+    const uint lx = get_local_id(0);                                                            \
+    const uint ly = get_local_id(1);                                                            \
+    acc_type acc = 0;                                                                           \
+                                                                                                \
+    for (uint t = 0; t < n; t += GEMM_TILE) {                                                   \
+        a_tile[ly][lx] = a[row * n + t + lx];                                                   \
+        b_tile[ly][lx] = b[(t + ly) * n + col];                                                 \
+        barrier(CLK_LOCAL_MEM_FENCE);                                                           \
+                                                                                                \
+        for (uint k = 0; k < GEMM_TILE; k++)                                                    \
+            acc += (acc_type)a_tile[ly][k] * (acc_type)b_tile[k][lx];                           \
+        barrier(CLK_LOCAL_MEM_FENCE);                                                           \
+    }                                                                                           \
+                                                                                                \
+    c[row * n + col] = acc;                                                                     \
+}
+
+GEMM_KERNEL(gemm_sp, float, float)
+
+GEMM_KERNEL(gemm_int8, char, int)
@@ -0,0 +1,74 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#define LOCAL_ELEMENTS      4096
+#define LOCAL_FETCH_PER_WI  256
+// Work-items 32 floats apart all read from the same bank
+#define CONFLICT_STRIDE     32
+
+// Consecutive work-items read consecutive words, every bank is used once
+__kernel void local_bandwidth_v1(__global float *input_value, __global float *output)
+{
+    __local float buffer[LOCAL_ELEMENTS];
+    const uint lid = get_local_id(0);
+    const uint lsize = get_local_size(0);
+
+    for (uint i = lid; i < LOCAL_ELEMENTS; i += lsize)
+        buffer[i] = input_value[0] + i;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    float sum = 0;
+    uint id = lid;
+    for (uint i = 0; i < LOCAL_FETCH_PER_WI; i++) {
+        sum += buffer[id & (LOCAL_ELEMENTS - 1)];
+        id += lsize;
+    }
+
+    output[get_global_id(0)] = sum;
+}
+
+__kernel void local_bandwidth_v4(__global float *input_value, __global float *output)
+{
+    __local float4 buffer[LOCAL_ELEMENTS / 4];
+    const uint lid = get_local_id(0);
+    const uint lsize = get_local_size(0);
+
+    for (uint i = lid; i < LOCAL_ELEMENTS / 4; i += lsize)
+        buffer[i] = (float4)(input_value[0] + i);
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    float4 sum = 0;
+    uint id = lid;
+    for (uint i = 0; i < LOCAL_FETCH_PER_WI; i++) {
+        sum += buffer[id & (LOCAL_ELEMENTS / 4 - 1)];
+        id += lsize;
+    }
+
+    output[get_global_id(0)] = (sum.S0) + (sum.S1) + (sum.S2) + (sum.S3);
+}
+
+// Every work-item of a sub-group reads a different word of the same bank
+__kernel void local_bandwidth_bank_conflict(__global float *input_value, __global float *output)
+{
+    __local float buffer[LOCAL_ELEMENTS];
+    const uint lid = get_local_id(0);
+    const uint lsize = get_local_size(0);
+
+    for (uint i = lid; i < LOCAL_ELEMENTS; i += lsize)
+        buffer[i] = input_value[0] + i;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    float sum = 0;
+    uint id = lid * CONFLICT_STRIDE;
+    for (uint i = 0; i < LOCAL_FETCH_PER_WI; i++) {
+        sum += buffer[id & (LOCAL_ELEMENTS - 1)];
+        id++;
+    }
+
+    output[get_global_id(0)] = sum;
+}
@@ -0,0 +1,22 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// Every load depends on the one before it, so the time per step is the
+// load-to-use latency of wherever the chain is held. The chase resumes at
+// the node where the previous launch stopped, so repeated launches keep
+// walking the cycle instead of revisiting its first nodes.
+__kernel void memory_latency(__global const uint *chain, __global uint *position, uint steps)
+{
+    uint index = position[0];
+
+    for (uint i = 0; i < steps; i++) {
+        index = chain[index];
+    }
+
+    position[0] = index;
+}
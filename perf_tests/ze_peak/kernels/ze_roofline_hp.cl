@@ -0,0 +1,66 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#if defined(cl_khr_fp16)
+  #pragma OPENCL EXTENSION cl_khr_fp16 : enable
+  #define HALF_AVAILABLE
+#endif
+
+#define ROOFLINE_ELEMENTS_PER_WI    16
+
+// Every work-item reads ROOFLINE_ELEMENTS_PER_WI elements, a whole grid apart
+// so the reads coalesce, runs mads multiply-adds on each and writes one
+// result. The elements are independent chains, interleaved so the
+// multiply-adds can issue back to back instead of waiting on each other,
+// and mads is a compile-time constant so the loops unroll. Arithmetic
+// intensity grows with mads, one kernel per step of the sweep.
+#define ROOFLINE_KERNEL(name, type, mads)                                                       \
+__kernel void name(__global type *input, __global type *output)                                 \
+{                                                                                               \
+    const uint gsize = get_global_size(0) * get_global_size(1) * get_global_size(2);            \
+    const uint gid = get_global_id(0) + get_global_size(0) *                                    \
+                     (get_global_id(1) + get_global_size(1) * get_global_id(2));                \
+    type x[ROOFLINE_ELEMENTS_PER_WI];                                                           \
+    type y[ROOFLINE_ELEMENTS_PER_WI];                                                           \
+    type sum = 0;                                                                               \
+                                                                                                \
+    __attribute__((opencl_unroll_hint))                                                         \
+    for (uint e = 0; e < ROOFLINE_ELEMENTS_PER_WI; e++) {                                       \
+        x[e] = input[gid + e * gsize];                                                          \
+        y[e] = x[e];                                                                            \
+    }                                                                                           \
+                                                                                                \
+    for (uint m = 0; m < (mads); m++) {                                                         \
+        __attribute__((opencl_unroll_hint))                                                     \
+        for (uint e = 0; e < ROOFLINE_ELEMENTS_PER_WI; e++)                                     \
+            y[e] = y[e] * x[e] + x[e];                                                          \
+    }                                                                                           \
+                                                                                                \
+    __attribute__((opencl_unroll_hint))                                                         \
+    for (uint e = 0; e < ROOFLINE_ELEMENTS_PER_WI; e++)                                         \
+        sum += y[e];                                                                            \
+                                                                                                \
+    output[gid] = sum;                                                                          \
+}
+
+// The sweep, 0 and then powers of two up to 256 multiply-adds per element
+#define ROOFLINE_KERNELS(prefix, type)                                                          \
+    ROOFLINE_KERNEL(prefix##_0, type, 0)                                                        \
+    ROOFLINE_KERNEL(prefix##_1, type, 1)                                                        \
+    ROOFLINE_KERNEL(prefix##_2, type, 2)                                                        \
+    ROOFLINE_KERNEL(prefix##_4, type, 4)                                                        \
+    ROOFLINE_KERNEL(prefix##_8, type, 8)                                                        \
+    ROOFLINE_KERNEL(prefix##_16, type, 16)                                                      \
+    ROOFLINE_KERNEL(prefix##_32, type, 32)                                                      \
+    ROOFLINE_KERNEL(prefix##_64, type, 64)                                                      \
+    ROOFLINE_KERNEL(prefix##_128, type, 128)                                                    \
+    ROOFLINE_KERNEL(prefix##_256, type, 256)
+
+#ifdef HALF_AVAILABLE
+ROOFLINE_KERNELS(roofline_hp, half)
+#endif
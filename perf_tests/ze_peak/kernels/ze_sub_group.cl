@@ -0,0 +1,71 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#if defined(cl_intel_subgroups)
+  #pragma OPENCL EXTENSION cl_intel_subgroups : enable
+  #define SUB_GROUPS_AVAILABLE
+#endif
+
+#undef BROADCAST_4
+#undef BROADCAST_16
+#undef BROADCAST_64
+#undef SHUFFLE_4
+#undef SHUFFLE_16
+#undef SHUFFLE_64
+
+// Adding y keeps every lane's value different, so nothing can be folded
+#define BROADCAST_4(x, y)       x = sub_group_broadcast(x, 0) + y;   x = sub_group_broadcast(x, 0) + y;   x = sub_group_broadcast(x, 0) + y;   x = sub_group_broadcast(x, 0) + y;
+#define BROADCAST_16(x, y)      BROADCAST_4(x, y);      BROADCAST_4(x, y);      BROADCAST_4(x, y);      BROADCAST_4(x, y);
+#define BROADCAST_64(x, y)      BROADCAST_16(x, y);     BROADCAST_16(x, y);     BROADCAST_16(x, y);     BROADCAST_16(x, y);
+
+#define SHUFFLE_4(x, y, lane)   x = intel_sub_group_shuffle(x, lane) + y;   x = intel_sub_group_shuffle(x, lane) + y;   x = intel_sub_group_shuffle(x, lane) + y;   x = intel_sub_group_shuffle(x, lane) + y;
+#define SHUFFLE_16(x, y, lane)  SHUFFLE_4(x, y, lane);  SHUFFLE_4(x, y, lane);  SHUFFLE_4(x, y, lane);  SHUFFLE_4(x, y, lane);
+#define SHUFFLE_64(x, y, lane)  SHUFFLE_16(x, y, lane); SHUFFLE_16(x, y, lane); SHUFFLE_16(x, y, lane); SHUFFLE_16(x, y, lane);
+
+#ifndef SUB_GROUPS_AVAILABLE
+#warning "OPENCL EXTENSION cl_intel_subgroups NOT AVAILABLE!"
+#else
+
+// 1024 broadcasts per work-item
+__kernel void sub_group_broadcast_throughput(__global float *input_value, __global float *output)
+{
+    float x = input_value[0];
+    float y = (float)get_sub_group_local_id();
+
+    BROADCAST_64(x, y);     BROADCAST_64(x, y);
+    BROADCAST_64(x, y);     BROADCAST_64(x, y);
+    BROADCAST_64(x, y);     BROADCAST_64(x, y);
+    BROADCAST_64(x, y);     BROADCAST_64(x, y);
+    BROADCAST_64(x, y);     BROADCAST_64(x, y);
+    BROADCAST_64(x, y);     BROADCAST_64(x, y);
+    BROADCAST_64(x, y);     BROADCAST_64(x, y);
+    BROADCAST_64(x, y);     BROADCAST_64(x, y);
+
+    output[get_global_id(0)] = x;
+}
+
+// 1024 shuffles per work-item, each lane reads its neighbour
+__kernel void sub_group_shuffle_throughput(__global float *input_value, __global float *output)
+{
+    float x = input_value[0];
+    float y = (float)get_sub_group_local_id();
+    uint lane = (get_sub_group_local_id() + 1) % get_sub_group_size();
+
+    SHUFFLE_64(x, y, lane); SHUFFLE_64(x, y, lane);
+    SHUFFLE_64(x, y, lane); SHUFFLE_64(x, y, lane);
+    SHUFFLE_64(x, y, lane); SHUFFLE_64(x, y, lane);
+    SHUFFLE_64(x, y, lane); SHUFFLE_64(x, y, lane);
+    SHUFFLE_64(x, y, lane); SHUFFLE_64(x, y, lane);
+    SHUFFLE_64(x, y, lane); SHUFFLE_64(x, y, lane);
+    SHUFFLE_64(x, y, lane); SHUFFLE_64(x, y, lane);
+    SHUFFLE_64(x, y, lane); SHUFFLE_64(x, y, lane);
+
+    output[get_global_id(0)] = x;
+}
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "../include/ze_peak.h"
+
+// Must match ze_atomics.cl
+#define ATOMICS_PER_WI 16
+#define GLOBAL_ATOMIC_STRIDE 16
+
+void ZePeak::ze_peak_atomics(L0Context &context) {
+  long double timed, gops;
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  TimingMeasurement type = is_bandwidth_with_event_timer();
+  struct ZeWorkGroups workgroup_info;
+
+  struct AtomicKernel {
+    const char *name;
+    const char *label;
+    ze_kernel_handle_t function;
+  } kernels[] = {
+      {"global_atomic_add_contended", "global add, contended", nullptr},
+      {"global_atomic_add_uncontended", "global add, uncontended", nullptr},
+      {"global_atomic_cmpxchg_contended", "global cmpxchg attempts, contended",
+       nullptr},
+      {"global_atomic_cmpxchg_uncontended", "global cmpxchg, uncontended",
+       nullptr},
+      {"local_atomic_add_contended", "local add, contended", nullptr},
+      {"local_atomic_add_uncontended", "local add, uncontended", nullptr},
+      {"local_atomic_cmpxchg_contended", "local cmpxchg attempts, contended",
+       nullptr},
+      {"local_atomic_cmpxchg_uncontended", "local cmpxchg, uncontended",
+       nullptr}};
+
+  std::vector<uint8_t> binary_file =
+      context.load_binary_file("ze_atomics.spv");
+  if (binary_file.empty()) {
+    std::cout << "Atomic throughput test skipped\n";
+    print_test_complete();
+    return;
+  }
+
+  context.create_module(binary_file);
+
+  uint64_t number_of_work_items = set_workgroups(
+      context, get_max_work_items(context) * 4, &workgroup_info);
+
+  void *device_counters;
+  ze_device_mem_alloc_desc_t counters_device_desc;
+  counters_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  counters_device_desc.ordinal = 0;
+  counters_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocDeviceMem(
+      context.driver, &counters_device_desc,
+      static_cast<size_t>(number_of_work_items * GLOBAL_ATOMIC_STRIDE *
+                          sizeof(uint32_t)),
+      1, context.device, &device_counters);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocDeviceMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "device counters allocated\n";
+
+  void *device_output_buffer;
+  ze_device_mem_alloc_desc_t out_device_desc;
+  out_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  out_device_desc.ordinal = 0;
+  out_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocDeviceMem(
+      context.driver, &out_device_desc,
+      static_cast<size_t>(number_of_work_items * sizeof(uint32_t)), 1,
+      context.device, &device_output_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocDeviceMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "device output buffer allocated\n";
+
+  /*Begin setup of Function*/
+
+  for (auto &kernel : kernels) {
+    setup_function(context, kernel.function, kernel.name, device_counters,
+                   device_output_buffer);
+  }
+
+  std::cout << "Atomic throughput (GOPS)\n";
+
+  for (auto &kernel : kernels) {
+    std::cout << kernel.label << " : ";
+    timed = run_kernel(context, kernel.function, workgroup_info, type);
+    gops = calculate_gbps(timed, number_of_work_items * ATOMICS_PER_WI);
+    std::cout << gops << " GOPS\n";
+    print_power_efficiency(gops, "GOPS");
+  }
+
+  for (auto &kernel : kernels) {
+    result = zeKernelDestroy(kernel.function);
+    if (result) {
+      throw std::runtime_error("zeKernelDestroy failed: " +
+                               std::to_string(result));
+    }
+    if (verbose)
+      std::cout << kernel.name << " Function Destroyed\n";
+  }
+
+  result = zeDriverFreeMem(context.driver, device_counters);
+  if (result) {
+    throw std::runtime_error("zeDriverFreeMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Counters Buffer freed\n";
+
+  result = zeDriverFreeMem(context.driver, device_output_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverFreeMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Output Buffer freed\n";
+
+  result = zeModuleDestroy(context.module);
+  if (result) {
+    throw std::runtime_error("zeModuleDestroy failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Module destroyed\n";
+
+  print_test_complete();
+}
@@ -0,0 +1,220 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "../include/ze_peak.h"
+
+// Must match ze_dot_product.cl
+#define DOT_ITERATIONS 256
+#define DPAS_ITERATIONS 64
+#define DOT_INT8_OPS 8 // 4 multiply-adds
+#define DOT_BF16_OPS 4 // 2 multiply-adds
+#define DPAS_INT8_OPS_PER_WI 512 // 8x8x32 multiply-adds over 8 work-items
+#define DPAS_BF16_OPS_PER_WI 256 // 8x8x16 multiply-adds over 8 work-items
+
+//---------------------------------------------------------------------
+// Utility function to check whether the module contains a kernel. The
+// built-in variants are only compiled in when the kernel compiler exposes
+// the matching extension.
+//---------------------------------------------------------------------
+static bool module_has_kernel(L0Context &context, const char *name) {
+  ze_kernel_desc_t function_description;
+  ze_kernel_handle_t function;
+
+  function_description.version = ZE_KERNEL_DESC_VERSION_CURRENT;
+  function_description.flags = ZE_KERNEL_FLAG_NONE;
+  function_description.pKernelName = name;
+
+  if (zeKernelCreate(context.module, &function_description, &function))
+    return false;
+
+  ze_result_t result = zeKernelDestroy(function);
+  if (result) {
+    throw std::runtime_error("zeKernelDestroy failed: " +
+                             std::to_string(result));
+  }
+  return true;
+}
+
+void ZePeak::ze_peak_dot_product(L0Context &context) {
+  long double timed, gops;
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  TimingMeasurement type = is_bandwidth_with_event_timer();
+  struct ZeWorkGroups workgroup_info;
+  // 4 packed int8 (1, 2, 3, 4) and 2 packed bf16 (1.0, 1.0)
+  uint32_t input_values[2] = {0x04030201, 0x3f803f80};
+
+  std::vector<uint8_t> binary_file =
+      context.load_binary_file("ze_dot_product.spv");
+  if (binary_file.empty()) {
+    std::cout << "Dot product test skipped\n";
+    print_test_complete();
+    return;
+  }
+
+  context.create_module(binary_file);
+
+  ze_device_kernel_properties_t kernel_properties;
+  kernel_properties.version = ZE_DEVICE_KERNEL_PROPERTIES_VERSION_CURRENT;
+  result = zeDeviceGetKernelProperties(context.device, &kernel_properties);
+  if (result) {
+    throw std::runtime_error("zeDeviceGetKernelProperties failed: " +
+                             std::to_string(result));
+  }
+
+  // Without a matrix engine bf16 runs on the fp32 pipes after conversion,
+  // int8 does 4 multiply-adds per lane per clock when dp4a is supported.
+  // The matrix engine rate is not reported by the device.
+  const long double bf16_peak = get_peak_gflops(context);
+  const long double int8_peak =
+      kernel_properties.dp4aSupported ? bf16_peak * 4 : bf16_peak;
+
+  struct DotProductKernel {
+    const char *name;
+    const char *label;
+    uint64_t ops_per_work_item;
+    long double peak;
+    ze_kernel_handle_t function;
+  } kernels[] = {
+      {"dot_int8_emulated", "int8 emulated", DOT_ITERATIONS * DOT_INT8_OPS,
+       int8_peak, nullptr},
+      {"dot_int8_builtin", "int8 dot built-in", DOT_ITERATIONS * DOT_INT8_OPS,
+       int8_peak, nullptr},
+      {"dot_int8_packed", "int8 packed dot built-in",
+       DOT_ITERATIONS * DOT_INT8_OPS, int8_peak, nullptr},
+      {"dpas_int8", "int8 matrix engine",
+       DPAS_ITERATIONS * DPAS_INT8_OPS_PER_WI, 0, nullptr},
+      {"dot_bf16_emulated", "bf16 emulated", DOT_ITERATIONS * DOT_BF16_OPS,
+       bf16_peak, nullptr},
+      {"dot_bf16_builtin", "bf16 conversion built-in",
+       DOT_ITERATIONS * DOT_BF16_OPS, bf16_peak, nullptr},
+      {"dpas_bf16", "bf16 matrix engine",
+       DPAS_ITERATIONS * DPAS_BF16_OPS_PER_WI, 0, nullptr}};
+
+  uint64_t max_number_of_allocated_items =
+      max_device_object_size(context) / sizeof(float);
+  uint64_t number_of_work_items =
+      MIN(max_number_of_allocated_items, get_max_work_items(context) * 2048);
+  number_of_work_items =
+      set_workgroups(context, number_of_work_items, &workgroup_info);
+
+  void *device_input_value;
+  ze_device_mem_alloc_desc_t in_device_desc;
+  in_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  in_device_desc.ordinal = 0;
+  in_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocDeviceMem(context.driver, &in_device_desc,
+                                  sizeof(input_values), 1, context.device,
+                                  &device_input_value);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocDeviceMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "device input value allocated\n";
+
+  void *device_output_buffer;
+  ze_device_mem_alloc_desc_t out_device_desc;
+  out_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  out_device_desc.ordinal = 0;
+  out_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocDeviceMem(
+      context.driver, &out_device_desc,
+      static_cast<size_t>((number_of_work_items * sizeof(float))), 1,
+      context.device, &device_output_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocDeviceMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "device output buffer allocated\n";
+
+  result = zeCommandListAppendMemoryCopy(context.command_list,
+                                         device_input_value, input_values,
+                                         sizeof(input_values), nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendMemoryCopy failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Input value copy encoded\n";
+
+  result =
+      zeCommandListAppendBarrier(context.command_list, nullptr, 0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendExecutionBarrier failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Execution barrier appended\n";
+
+  context.execute_commandlist_and_sync();
+
+  /*Begin setup of Function*/
+
+  for (auto &kernel : kernels) {
+    if (!module_has_kernel(context, kernel.name))
+      continue;
+    setup_function(context, kernel.function, kernel.name, device_input_value,
+                   device_output_buffer);
+  }
+
+  std::cout << "Dot product throughput (GOPS)\n";
+
+  for (auto &kernel : kernels) {
+    std::cout << kernel.label << " : ";
+    if (!kernel.function) {
+      std::cout << "not available in ze_dot_product.spv\n";
+      continue;
+    }
+
+    timed = run_kernel(context, kernel.function, workgroup_info, type);
+    gops = calculate_gbps(timed,
+                          number_of_work_items * kernel.ops_per_work_item);
+    std::cout << gops << " GOPS\n";
+    print_fraction_of_peak(gops, kernel.peak, "GOPS");
+    print_power_efficiency(gops, "GOPS");
+  }
+
+  for (auto &kernel : kernels) {
+    if (!kernel.function)
+      continue;
+    result = zeKernelDestroy(kernel.function);
+    if (result) {
+      throw std::runtime_error("zeKernelDestroy failed: " +
+                               std::to_string(result));
+    }
+    if (verbose)
+      std::cout << kernel.name << " Function Destroyed\n";
+  }
+
+  result = zeDriverFreeMem(context.driver, device_input_value);
+  if (result) {
+    throw std::runtime_error("zeDriverFreeMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Input Buffer freed\n";
+
+  result = zeDriverFreeMem(context.driver, device_output_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverFreeMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Output Buffer freed\n";
+
+  result = zeModuleDestroy(context.module);
+  if (result) {
+    throw std::runtime_error("zeModuleDestroy failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Module destroyed\n";
+
+  print_test_complete();
+}
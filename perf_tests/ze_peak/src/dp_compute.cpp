@@ -109,6 +109,7 @@ void ZePeak::ze_peak_dp_compute(L0Context &context) {
   timed = run_kernel(context, compute_dp_v1, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 2
@@ -116,6 +117,7 @@ void ZePeak::ze_peak_dp_compute(L0Context &context) {
   timed = run_kernel(context, compute_dp_v2, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 4
@@ -123,6 +125,7 @@ void ZePeak::ze_peak_dp_compute(L0Context &context) {
   timed = run_kernel(context, compute_dp_v4, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 8
@@ -130,6 +133,7 @@ void ZePeak::ze_peak_dp_compute(L0Context &context) {
   timed = run_kernel(context, compute_dp_v8, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 16
@@ -137,6 +141,7 @@ void ZePeak::ze_peak_dp_compute(L0Context &context) {
   timed = run_kernel(context, compute_dp_v16, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   result = zeKernelDestroy(compute_dp_v1);
   if (result) {
@@ -0,0 +1,225 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "../include/ze_peak.h"
+
+// Must match ze_gemm.cl
+#define GEMM_TILE 16
+#define GEMM_MAX_SIZE 2048
+
+void ZePeak::ze_peak_gemm(L0Context &context) {
+  long double timed, gops;
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  TimingMeasurement type = is_bandwidth_with_event_timer();
+  struct ZeWorkGroups workgroup_info;
+
+  std::vector<uint8_t> binary_file = context.load_binary_file("ze_gemm.spv");
+  if (binary_file.empty()) {
+    std::cout << "GEMM test skipped\n";
+    print_test_complete();
+    return;
+  }
+
+  if ((context.device_compute_property.maxTotalGroupSize <
+       GEMM_TILE * GEMM_TILE) ||
+      (context.device_compute_property.maxGroupSizeX < GEMM_TILE) ||
+      (context.device_compute_property.maxGroupSizeY < GEMM_TILE)) {
+    std::cout << "GEMM test skipped, work-groups of " << GEMM_TILE << "x"
+              << GEMM_TILE << " are not supported\n";
+    print_test_complete();
+    return;
+  }
+
+  context.create_module(binary_file);
+
+  ze_device_kernel_properties_t kernel_properties;
+  kernel_properties.version = ZE_DEVICE_KERNEL_PROPERTIES_VERSION_CURRENT;
+  result = zeDeviceGetKernelProperties(context.device, &kernel_properties);
+  if (result) {
+    throw std::runtime_error("zeDeviceGetKernelProperties failed: " +
+                             std::to_string(result));
+  }
+
+  const long double fp32_peak = get_peak_gflops(context);
+  const long double int8_peak =
+      kernel_properties.dp4aSupported ? fp32_peak * 4 : fp32_peak;
+
+  // All inputs are 1, so every element of the result is n
+  float float_one = 1.0f;
+  int8_t int8_one = 1;
+
+  struct GemmKernel {
+    const char *name;
+    const char *label;
+    const char *unit;
+    size_t element_size;
+    const void *fill_pattern;
+    bool float_result;
+    long double peak;
+  } kernels[] = {{"gemm_sp", "fp32", "GFLOPS", sizeof(float), &float_one,
+                  true, fp32_peak},
+                 {"gemm_int8", "int8", "GOPS", sizeof(int8_t), &int8_one,
+                  false, int8_peak}};
+
+  // The result is always 4 bytes per element
+  uint32_t n = GEMM_MAX_SIZE;
+  while ((n > GEMM_TILE) &&
+         (static_cast<uint64_t>(n) * n * sizeof(float) >
+          max_device_object_size(context))) {
+    n /= 2;
+  }
+  const size_t matrix_size = static_cast<size_t>(n) * n;
+
+  void *device_a_buffer;
+  ze_device_mem_alloc_desc_t a_device_desc;
+  a_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  a_device_desc.ordinal = 0;
+  a_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocDeviceMem(context.driver, &a_device_desc,
+                                  matrix_size * sizeof(float), 1,
+                                  context.device, &device_a_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocDeviceMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "device A buffer allocated\n";
+
+  void *device_b_buffer;
+  ze_device_mem_alloc_desc_t b_device_desc;
+  b_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  b_device_desc.ordinal = 0;
+  b_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocDeviceMem(context.driver, &b_device_desc,
+                                  matrix_size * sizeof(float), 1,
+                                  context.device, &device_b_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocDeviceMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "device B buffer allocated\n";
+
+  void *device_c_buffer;
+  ze_device_mem_alloc_desc_t c_device_desc;
+  c_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  c_device_desc.ordinal = 0;
+  c_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocDeviceMem(context.driver, &c_device_desc,
+                                  matrix_size * sizeof(float), 1,
+                                  context.device, &device_c_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocDeviceMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "device C buffer allocated\n";
+
+  // One work-item per element of C, in GEMM_TILE x GEMM_TILE work-groups
+  workgroup_info.group_size_x = GEMM_TILE;
+  workgroup_info.group_size_y = GEMM_TILE;
+  workgroup_info.group_size_z = 1;
+  workgroup_info.thread_group_dimensions.groupCountX = n / GEMM_TILE;
+  workgroup_info.thread_group_dimensions.groupCountY = n / GEMM_TILE;
+  workgroup_info.thread_group_dimensions.groupCountZ = 1;
+
+  const long double operations = 2.0L * n * n * n;
+
+  std::cout << "GEMM (" << n << "x" << n << ", " << GEMM_TILE << "x"
+            << GEMM_TILE << " tiles)\n";
+
+  for (auto &kernel : kernels) {
+    for (auto buffer : {device_a_buffer, device_b_buffer}) {
+      result = zeCommandListAppendMemoryFill(
+          context.command_list, buffer, kernel.fill_pattern,
+          kernel.element_size, matrix_size * kernel.element_size, nullptr);
+      if (result) {
+        throw std::runtime_error("zeCommandListAppendMemoryFill failed: " +
+                                 std::to_string(result));
+      }
+    }
+    if (verbose)
+      std::cout << "Input matrix fills encoded\n";
+
+    context.execute_commandlist_and_sync();
+
+    ze_kernel_handle_t function;
+    setup_function(context, function, kernel.name, device_a_buffer,
+                   device_b_buffer);
+
+    result = zeKernelSetArgumentValue(function, 2, sizeof(device_c_buffer),
+                                      &device_c_buffer);
+    if (result) {
+      throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                               std::to_string(result));
+    }
+    result = zeKernelSetArgumentValue(function, 3, sizeof(n), &n);
+    if (result) {
+      throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                               std::to_string(result));
+    }
+    if (verbose)
+      std::cout << "Output buffer & size set as function arguments\n";
+
+    std::cout << kernel.label << " : ";
+    timed = run_kernel(context, function, workgroup_info, type);
+    gops = calculate_gbps(timed, operations);
+    std::cout << gops << " " << kernel.unit << "\n";
+    print_fraction_of_peak(gops, kernel.peak, kernel.unit);
+    print_power_efficiency(gops, kernel.unit);
+
+    uint32_t first_element = 0;
+    result = zeCommandListAppendMemoryCopy(context.command_list,
+                                           &first_element, device_c_buffer,
+                                           sizeof(first_element), nullptr);
+    if (result) {
+      throw std::runtime_error("zeCommandListAppendMemoryCopy failed: " +
+                               std::to_string(result));
+    }
+    context.execute_commandlist_and_sync();
+
+    long double value = first_element;
+    if (kernel.float_result) {
+      float float_value;
+      memcpy(&float_value, &first_element, sizeof(float_value));
+      value = float_value;
+    }
+    if (value != n) {
+      std::cout << "  WARNING: " << kernel.name << " computed " << value
+                << " instead of " << n << "\n";
+    }
+
+    result = zeKernelDestroy(function);
+    if (result) {
+      throw std::runtime_error("zeKernelDestroy failed: " +
+                               std::to_string(result));
+    }
+    if (verbose)
+      std::cout << kernel.name << " Function Destroyed\n";
+  }
+
+  for (auto buffer : {device_a_buffer, device_b_buffer, device_c_buffer}) {
+    result = zeDriverFreeMem(context.driver, buffer);
+    if (result) {
+      throw std::runtime_error("zeDriverFreeMem failed: " +
+                               std::to_string(result));
+    }
+  }
+  if (verbose)
+    std::cout << "Matrix Buffers freed\n";
+
+  result = zeModuleDestroy(context.module);
+  if (result) {
+    throw std::runtime_error("zeModuleDestroy failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Module destroyed\n";
+
+  print_test_complete();
+}
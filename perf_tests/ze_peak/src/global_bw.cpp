@@ -140,6 +140,7 @@ void ZePeak::ze_peak_global_bw(L0Context &context) {
   gbps = calculate_gbps(timed, numItems * sizeof(float));
 
   std::cout << gbps << " GBPS\n";
+  print_power_efficiency(gbps, "GBPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 2
@@ -157,6 +158,7 @@ void ZePeak::ze_peak_global_bw(L0Context &context) {
   gbps = calculate_gbps(timed, numItems * sizeof(float));
 
   std::cout << gbps << " GBPS\n";
+  print_power_efficiency(gbps, "GBPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 4
@@ -174,6 +176,7 @@ void ZePeak::ze_peak_global_bw(L0Context &context) {
   gbps = calculate_gbps(timed, numItems * sizeof(float));
 
   std::cout << gbps << " GBPS\n";
+  print_power_efficiency(gbps, "GBPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 8
@@ -191,6 +194,7 @@ void ZePeak::ze_peak_global_bw(L0Context &context) {
   gbps = calculate_gbps(timed, numItems * sizeof(float));
 
   std::cout << gbps << " GBPS\n";
+  print_power_efficiency(gbps, "GBPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 16
@@ -207,6 +211,7 @@ void ZePeak::ze_peak_global_bw(L0Context &context) {
   gbps = calculate_gbps(timed, numItems * sizeof(float));
 
   std::cout << gbps << " GBPS\n";
+  print_power_efficiency(gbps, "GBPS");
 
   result = zeKernelDestroy(local_offset_v1);
   if (result) {
@@ -88,6 +88,7 @@ void ZePeak::ze_peak_hp_compute(L0Context &context) {
   timed = run_kernel(context, compute_hp_v1, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 2
@@ -95,6 +96,7 @@ void ZePeak::ze_peak_hp_compute(L0Context &context) {
   timed = run_kernel(context, compute_hp_v2, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 4
@@ -102,6 +104,7 @@ void ZePeak::ze_peak_hp_compute(L0Context &context) {
   timed = run_kernel(context, compute_hp_v4, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 8
@@ -109,6 +112,7 @@ void ZePeak::ze_peak_hp_compute(L0Context &context) {
   timed = run_kernel(context, compute_hp_v8, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 16
@@ -116,6 +120,7 @@ void ZePeak::ze_peak_hp_compute(L0Context &context) {
   timed = run_kernel(context, compute_hp_v16, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   result = zeKernelDestroy(compute_hp_v1);
   if (result) {
@@ -108,6 +108,7 @@ void ZePeak::ze_peak_int_compute(L0Context &context) {
   timed = run_kernel(context, compute_int_v1, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 2
@@ -115,6 +116,7 @@ void ZePeak::ze_peak_int_compute(L0Context &context) {
   timed = run_kernel(context, compute_int_v2, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 4
@@ -122,6 +124,7 @@ void ZePeak::ze_peak_int_compute(L0Context &context) {
   timed = run_kernel(context, compute_int_v4, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 8
@@ -129,6 +132,7 @@ void ZePeak::ze_peak_int_compute(L0Context &context) {
   timed = run_kernel(context, compute_int_v8, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 16
@@ -136,6 +140,7 @@ void ZePeak::ze_peak_int_compute(L0Context &context) {
   timed = run_kernel(context, compute_int_v16, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   result = zeKernelDestroy(compute_int_v1);
   if (result) {
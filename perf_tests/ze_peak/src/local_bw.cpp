@@ -0,0 +1,150 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "../include/ze_peak.h"
+
+// Must match ze_local_bw.cl
+#define LOCAL_FETCH_PER_WI 256
+
+void ZePeak::ze_peak_local_bw(L0Context &context) {
+  long double timed, gbps;
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  TimingMeasurement type = is_bandwidth_with_event_timer();
+  struct ZeWorkGroups workgroup_info;
+  float input_value = 1.3f;
+
+  struct LocalBandwidthKernel {
+    const char *name;
+    const char *label;
+    size_t bytes_per_fetch;
+    ze_kernel_handle_t function;
+  } kernels[] = {
+      {"local_bandwidth_v1", "float", sizeof(float), nullptr},
+      {"local_bandwidth_v4", "float4", 4 * sizeof(float), nullptr},
+      {"local_bandwidth_bank_conflict", "float, bank conflicts", sizeof(float),
+       nullptr}};
+
+  std::vector<uint8_t> binary_file =
+      context.load_binary_file("ze_local_bw.spv");
+  if (binary_file.empty()) {
+    std::cout << "Local memory bandwidth test skipped\n";
+    print_test_complete();
+    return;
+  }
+
+  context.create_module(binary_file);
+
+  uint64_t number_of_work_items = set_workgroups(
+      context, get_max_work_items(context) * 16, &workgroup_info);
+
+  void *device_input_value;
+  ze_device_mem_alloc_desc_t in_device_desc;
+  in_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  in_device_desc.ordinal = 0;
+  in_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result =
+      zeDriverAllocDeviceMem(context.driver, &in_device_desc, sizeof(float), 1,
+                             context.device, &device_input_value);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocDeviceMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "device input value allocated\n";
+
+  void *device_output_buffer;
+  ze_device_mem_alloc_desc_t out_device_desc;
+  out_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  out_device_desc.ordinal = 0;
+  out_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocDeviceMem(
+      context.driver, &out_device_desc,
+      static_cast<size_t>((number_of_work_items * sizeof(float))), 1,
+      context.device, &device_output_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocDeviceMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "device output buffer allocated\n";
+
+  result =
+      zeCommandListAppendMemoryCopy(context.command_list, device_input_value,
+                                    &input_value, sizeof(float), nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendMemoryCopy failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Input value copy encoded\n";
+
+  result =
+      zeCommandListAppendBarrier(context.command_list, nullptr, 0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendExecutionBarrier failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Execution barrier appended\n";
+
+  context.execute_commandlist_and_sync();
+
+  /*Begin setup of Function*/
+
+  for (auto &kernel : kernels) {
+    setup_function(context, kernel.function, kernel.name, device_input_value,
+                   device_output_buffer);
+  }
+
+  std::cout << "Local memory bandwidth (GBPS)\n";
+
+  for (auto &kernel : kernels) {
+    std::cout << kernel.label << " : ";
+    timed = run_kernel(context, kernel.function, workgroup_info, type);
+    gbps = calculate_gbps(timed, number_of_work_items * LOCAL_FETCH_PER_WI *
+                                     kernel.bytes_per_fetch);
+    std::cout << gbps << " GBPS\n";
+    print_power_efficiency(gbps, "GBPS");
+  }
+
+  for (auto &kernel : kernels) {
+    result = zeKernelDestroy(kernel.function);
+    if (result) {
+      throw std::runtime_error("zeKernelDestroy failed: " +
+                               std::to_string(result));
+    }
+    if (verbose)
+      std::cout << kernel.name << " Function Destroyed\n";
+  }
+
+  result = zeDriverFreeMem(context.driver, device_input_value);
+  if (result) {
+    throw std::runtime_error("zeDriverFreeMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Input Buffer freed\n";
+
+  result = zeDriverFreeMem(context.driver, device_output_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverFreeMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Output Buffer freed\n";
+
+  result = zeModuleDestroy(context.module);
+  if (result) {
+    throw std::runtime_error("zeModuleDestroy failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Module destroyed\n";
+
+  print_test_complete();
+}
@@ -0,0 +1,349 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "../include/ze_peak.h"
+
+#include <algorithm>
+#include <random>
+
+#define LATENCY_NODE_SIZE 64
+#define LATENCY_MIN_SIZE (4 * 1024ULL)
+#define LATENCY_STEPS 8192
+// A size is in a new level once its latency is this much above the latency
+// of the first size of the current level
+#define LATENCY_KNEE_RATIO 1.25
+
+enum class ChainPattern { RANDOM, STRIDED };
+
+struct LatencyLevel {
+  uint64_t first_size;
+  uint64_t last_size;
+  long double latency;
+};
+
+//---------------------------------------------------------------------
+// Utility function to link every LATENCY_NODE_SIZE byte node of the first
+// size bytes of chain into a single cycle starting at node 0. Random chains
+// are a Sattolo shuffle, strided chains visit the nodes in address order.
+//---------------------------------------------------------------------
+static void fill_chain(std::vector<uint32_t> &chain, uint64_t size,
+                       ChainPattern pattern, std::mt19937 &random_engine) {
+  const uint32_t node_stride = LATENCY_NODE_SIZE / sizeof(uint32_t);
+  const uint32_t nodes = static_cast<uint32_t>(size / LATENCY_NODE_SIZE);
+  std::vector<uint32_t> next(nodes);
+
+  if (pattern == ChainPattern::RANDOM) {
+    std::iota(next.begin(), next.end(), 0);
+    for (uint32_t k = nodes - 1; k > 0; k--) {
+      std::uniform_int_distribution<uint32_t> distribution(0, k - 1);
+      std::swap(next[k], next[distribution(random_engine)]);
+    }
+  } else {
+    for (uint32_t k = 0; k < nodes; k++) {
+      next[k] = (k + 1) % nodes;
+    }
+  }
+
+  for (uint32_t k = 0; k < nodes; k++) {
+    chain[k * node_stride] = next[k] * node_stride;
+  }
+}
+
+//---------------------------------------------------------------------
+// Utility function to group consecutive working set sizes with similar
+// latency into the cache levels they fit in.
+//---------------------------------------------------------------------
+static std::vector<LatencyLevel>
+find_latency_levels(const std::vector<uint64_t> &sizes,
+                    const std::vector<long double> &latencies) {
+  std::vector<LatencyLevel> levels;
+
+  for (size_t i = 0; i < sizes.size(); i++) {
+    if (levels.empty() ||
+        (latencies[i] > levels.back().latency * LATENCY_KNEE_RATIO)) {
+      levels.push_back({sizes[i], sizes[i], latencies[i]});
+    } else {
+      levels.back().last_size = sizes[i];
+    }
+  }
+  return levels;
+}
+
+static std::string latency_level_name(size_t level, size_t level_count) {
+  if ((level_count > 1) && (level == level_count - 1))
+    return "device memory";
+  if (level == 0)
+    return "L1";
+  if (level == 1)
+    return "L3";
+  return "cache level " + std::to_string(level + 1);
+}
+
+//---------------------------------------------------------------------
+// Utility function to measure the latency of one dependent load in nano
+// seconds on a chain of the given number of nodes. The kernel carries its
+// position in position_buffer from launch to launch, so the chase starts at
+// node 0, walks one full untimed cycle to prime whatever fits in the caches,
+// and every warmup and timed launch after that continues along the cycle.
+// Launch overhead cancels out of the difference between chasing
+// 2 * LATENCY_STEPS and LATENCY_STEPS nodes.
+//---------------------------------------------------------------------
+long double ZePeak::_chase_latency(L0Context &context,
+                                   ze_kernel_handle_t &function,
+                                   struct ZeWorkGroups &workgroup_info,
+                                   void *position_buffer, uint32_t nodes) {
+  TimingMeasurement type = is_bandwidth_with_event_timer();
+  const uint32_t start = 0;
+  long double timed[2];
+  ze_result_t result = ZE_RESULT_SUCCESS;
+
+  result = zeCommandListAppendMemoryCopy(context.command_list, position_buffer,
+                                         &start, sizeof(start), nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendMemoryCopy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeKernelSetArgumentValue(function, 2, sizeof(nodes), &nodes);
+  if (result) {
+    throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                             std::to_string(result));
+  }
+  result = zeKernelSetGroupSize(function, workgroup_info.group_size_x,
+                                workgroup_info.group_size_y,
+                                workgroup_info.group_size_z);
+  if (result) {
+    throw std::runtime_error("zeKernelSetGroupSize failed: " +
+                             std::to_string(result));
+  }
+  result = zeCommandListAppendLaunchKernel(
+      context.command_list, function, &workgroup_info.thread_group_dimensions,
+      nullptr, 0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Priming cycle appended\n";
+
+  context.execute_commandlist_and_sync();
+
+  for (uint32_t run = 0; run < 2; run++) {
+    uint32_t steps = LATENCY_STEPS * (run + 1);
+    result = zeKernelSetArgumentValue(function, 2, sizeof(steps), &steps);
+    if (result) {
+      throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                               std::to_string(result));
+    }
+    timed[run] = run_kernel(context, function, workgroup_info, type);
+  }
+
+  // The chase is not a rate, keep its power samples out of the next result
+  power_sample = PowerSample();
+
+  return (timed[1] - timed[0]) * 1e3 / LATENCY_STEPS;
+}
+
+void ZePeak::ze_peak_mem_latency(L0Context &context) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  struct ZeWorkGroups workgroup_info;
+  std::mt19937 random_engine(0);
+
+  std::vector<uint8_t> binary_file =
+      context.load_binary_file("ze_mem_latency.spv");
+  if (binary_file.empty()) {
+    std::cout << "Memory latency test skipped\n";
+    print_test_complete();
+    return;
+  }
+
+  context.create_module(binary_file);
+
+  ze_device_cache_properties_t cache_properties;
+  cache_properties.version = ZE_DEVICE_CACHE_PROPERTIES_VERSION_CURRENT;
+  result = zeDeviceGetCacheProperties(context.device, &cache_properties);
+  if (result) {
+    throw std::runtime_error("zeDeviceGetCacheProperties failed: " +
+                             std::to_string(result));
+  }
+
+  // Go well past the last level cache, but stay a power of two
+  uint64_t wanted_size = std::max<uint64_t>(
+      256 * 1024 * 1024ULL, 8 * cache_properties.lastLevelCacheSize);
+  wanted_size = std::min(wanted_size, max_device_object_size(context) / 2);
+  uint64_t max_size = LATENCY_MIN_SIZE;
+  while (max_size * 2 <= wanted_size) {
+    max_size *= 2;
+  }
+
+  void *chain_buffer;
+  ze_device_mem_alloc_desc_t chain_device_desc;
+  chain_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  chain_device_desc.ordinal = 0;
+  chain_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocDeviceMem(context.driver, &chain_device_desc,
+                                  static_cast<size_t>(max_size), 1,
+                                  context.device, &chain_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocDeviceMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "chain device buffer allocated\n";
+
+  void *position_buffer;
+  ze_device_mem_alloc_desc_t position_device_desc;
+  position_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  position_device_desc.ordinal = 0;
+  position_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocDeviceMem(context.driver, &position_device_desc,
+                                  sizeof(uint32_t), 1, context.device,
+                                  &position_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocDeviceMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "position device buffer allocated\n";
+
+  void *host_chain_buffer;
+  ze_host_mem_alloc_desc_t host_desc;
+  host_desc.version = ZE_HOST_MEM_ALLOC_DESC_VERSION_CURRENT;
+  host_desc.flags = ZE_HOST_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocHostMem(context.driver, &host_desc,
+                                static_cast<size_t>(max_size), 1,
+                                &host_chain_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocHostMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "chain host buffer allocated\n";
+
+  /*Begin setup of Function*/
+
+  ze_kernel_handle_t memory_latency;
+  setup_function(context, memory_latency, "memory_latency", chain_buffer,
+                 position_buffer);
+
+  // A single work-item, anything more would overlap the loads
+  set_workgroups(context, 1, &workgroup_info);
+
+  std::vector<uint32_t> chain(
+      static_cast<size_t>(max_size / sizeof(uint32_t)));
+  std::vector<uint64_t> sizes;
+  std::vector<long double> random_latencies;
+
+  std::cout << "Memory latency (nS per dependent load)\n";
+  std::cout << "cache sizes reported : intermediate "
+            << cache_properties.intermediateCacheSize << " bytes, last level "
+            << cache_properties.lastLevelCacheSize << " bytes\n";
+
+  for (uint64_t size = LATENCY_MIN_SIZE; size <= max_size; size *= 2) {
+    long double latency[2];
+
+    for (auto pattern : {ChainPattern::RANDOM, ChainPattern::STRIDED}) {
+      fill_chain(chain, size, pattern, random_engine);
+
+      result = zeCommandListAppendMemoryCopy(context.command_list,
+                                             chain_buffer, chain.data(),
+                                             static_cast<size_t>(size),
+                                             nullptr);
+      if (result) {
+        throw std::runtime_error("zeCommandListAppendMemoryCopy failed: " +
+                                 std::to_string(result));
+      }
+      if (verbose)
+        std::cout << "Chain copy encoded\n";
+
+      context.execute_commandlist_and_sync();
+
+      latency[static_cast<int>(pattern)] = _chase_latency(
+          context, memory_latency, workgroup_info, position_buffer,
+          static_cast<uint32_t>(size / LATENCY_NODE_SIZE));
+    }
+
+    std::cout << size << " bytes : random "
+              << latency[static_cast<int>(ChainPattern::RANDOM)]
+              << " nS, stride " << LATENCY_NODE_SIZE << "B "
+              << latency[static_cast<int>(ChainPattern::STRIDED)] << " nS\n";
+
+    sizes.push_back(size);
+    random_latencies.push_back(latency[static_cast<int>(ChainPattern::RANDOM)]);
+  }
+
+  std::vector<LatencyLevel> levels =
+      find_latency_levels(sizes, random_latencies);
+  for (size_t i = 0; i < levels.size(); i++) {
+    std::cout << latency_level_name(i, levels.size()) << " : "
+              << levels[i].latency << " nS (" << levels[i].first_size
+              << " to " << levels[i].last_size << " bytes)\n";
+    if (i + 1 < levels.size()) {
+      std::cout << "  knee between " << levels[i].last_size << " and "
+                << levels[i + 1].first_size << " bytes\n";
+    }
+  }
+
+  // System memory, reached through a host allocation
+  fill_chain(chain, max_size, ChainPattern::RANDOM, random_engine);
+  memcpy(host_chain_buffer, chain.data(), static_cast<size_t>(max_size));
+  result = zeKernelSetArgumentValue(memory_latency, 0,
+                                    sizeof(host_chain_buffer),
+                                    &host_chain_buffer);
+  if (result) {
+    throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                             std::to_string(result));
+  }
+  std::cout << "system memory : "
+            << _chase_latency(
+                   context, memory_latency, workgroup_info, position_buffer,
+                   static_cast<uint32_t>(max_size / LATENCY_NODE_SIZE))
+            << " nS (" << max_size << " bytes)\n";
+
+  result = zeKernelDestroy(memory_latency);
+  if (result) {
+    throw std::runtime_error("zeKernelDestroy failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "memory_latency Function Destroyed\n";
+
+  result = zeDriverFreeMem(context.driver, chain_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverFreeMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Chain Buffer freed\n";
+
+  result = zeDriverFreeMem(context.driver, position_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverFreeMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Position Buffer freed\n";
+
+  result = zeDriverFreeMem(context.driver, host_chain_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverFreeMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Host Chain Buffer freed\n";
+
+  result = zeModuleDestroy(context.module);
+  if (result) {
+    throw std::runtime_error("zeModuleDestroy failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Module destroyed\n";
+
+  print_test_complete();
+}
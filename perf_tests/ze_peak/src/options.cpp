@@ -28,7 +28,24 @@ static const char *usage_str =
     "\n      int_compute             selectively run integer compute test"
     "\n      transfer_bw             selectively run transfer bandwidth test"
     "\n      kernel_lat              selectively run kernel latency test"
+    "\n      mem_latency             selectively run memory latency (pointer "
+    "chasing) test"
+    "\n      local_bw                selectively run local memory bandwidth "
+    "test"
+    "\n      atomics                 selectively run atomic throughput test"
+    "\n      sub_group               selectively run sub-group shuffle & "
+    "broadcast test"
+    "\n      roofline                selectively run roofline (compute vs "
+    "bandwidth) test"
+    "\n      dot_product             selectively run int8 & bf16 dot product "
+    "test"
+    "\n      gemm                    selectively run tiled matrix multiply "
+    "test"
     "\n  -a                          run all above tests [default]"
+    "\n  -m                          report power & frequency with each result"
+    "\n                              (perf per watt) [default: No]"
+    "\n  -j file                     write the roofline test results to file "
+    "as JSON"
     "\n  -v                          enable verbose prints"
     "\n  -i                          set number of iterations to run[default: "
     "50]"
@@ -73,6 +90,13 @@ int ZePeak::parse_arguments(int argc, char **argv) {
       }
     } else if (strcmp(argv[i], "-e") == 0) {
       use_event_timer = true;
+    } else if (strcmp(argv[i], "-m") == 0) {
+      monitor_power = true;
+    } else if (strcmp(argv[i], "-j") == 0) {
+      if ((i + 1) < argc) {
+        roofline_json_file = argv[i + 1];
+        i++;
+      }
     } else if (strcmp(argv[i], "-v") == 0) {
       verbose = true;
     } else if (strcmp(argv[i], "-i") == 0) {
@@ -93,6 +117,13 @@ int ZePeak::parse_arguments(int argc, char **argv) {
       run_int_compute = false;
       run_transfer_bw = false;
       run_kernel_lat = false;
+      run_mem_latency = false;
+      run_local_bw = false;
+      run_atomics = false;
+      run_sub_group = false;
+      run_roofline = false;
+      run_dot_product = false;
+      run_gemm = false;
       if ((i + 1) >= argc) {
         std::cout << usage_str;
         exit(-1);
@@ -118,13 +149,37 @@ int ZePeak::parse_arguments(int argc, char **argv) {
       } else if (strcmp(argv[i + 1], "kernel_lat") == 0) {
         run_kernel_lat = true;
         i++;
+      } else if (strcmp(argv[i + 1], "mem_latency") == 0) {
+        run_mem_latency = true;
+        i++;
+      } else if (strcmp(argv[i + 1], "local_bw") == 0) {
+        run_local_bw = true;
+        i++;
+      } else if (strcmp(argv[i + 1], "atomics") == 0) {
+        run_atomics = true;
+        i++;
+      } else if (strcmp(argv[i + 1], "sub_group") == 0) {
+        run_sub_group = true;
+        i++;
+      } else if (strcmp(argv[i + 1], "roofline") == 0) {
+        run_roofline = true;
+        i++;
+      } else if (strcmp(argv[i + 1], "dot_product") == 0) {
+        run_dot_product = true;
+        i++;
+      } else if (strcmp(argv[i + 1], "gemm") == 0) {
+        run_gemm = true;
+        i++;
       } else {
         std::cout << usage_str;
         exit(-1);
       }
     } else if (strcmp(argv[i], "-a") == 0) {
       run_global_bw = run_hp_compute = run_sp_compute = run_dp_compute =
-          run_int_compute = run_transfer_bw = run_kernel_lat = true;
+          run_int_compute = run_transfer_bw = run_kernel_lat =
+              run_mem_latency = run_local_bw = run_atomics =
+                  run_sub_group = run_roofline = run_dot_product =
+                      run_gemm = true;
     } else {
       std::cout << usage_str;
       exit(-1);
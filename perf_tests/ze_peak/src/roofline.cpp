@@ -0,0 +1,255 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "../include/ze_peak.h"
+
+#include <algorithm>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+namespace pt = boost::property_tree;
+
+// Must match ze_roofline.cl
+#define ROOFLINE_ELEMENTS_PER_WI 16
+#define ROOFLINE_MAX_MADS_PER_ELEMENT 256
+#define ROOFLINE_BUFFER_SIZE (256 * 1024 * 1024ULL)
+
+struct RooflinePoint {
+  uint32_t mads_per_element;
+  long double intensity; // operations per byte
+  long double gops;
+  long double gbps;
+};
+
+struct RooflineKernel {
+  const char *module;
+  const char *name;
+  const char *label;
+  const char *unit;
+  size_t element_size;
+  bool supported;
+  std::vector<RooflinePoint> points;
+  long double peak_gops;
+};
+
+//---------------------------------------------------------------------
+// Utility function to write the roofline as JSON: the peak bandwidth,
+// then for each data type its peak rate, ridge point & measured points.
+//---------------------------------------------------------------------
+static void write_roofline_json(const std::string &file_name,
+                                L0Context &context, long double peak_gbps,
+                                const std::vector<RooflineKernel> &kernels) {
+  pt::ptree roofline;
+  roofline.put("Device", context.device_property.name);
+  roofline.put("Peak bandwidth GBPS", peak_gbps);
+
+  for (auto &kernel : kernels) {
+    if (kernel.points.empty())
+      continue;
+
+    pt::ptree type;
+    type.put("Unit", kernel.unit);
+    type.put("Peak", kernel.peak_gops);
+    type.put("Ridge point", kernel.peak_gops / peak_gbps);
+
+    pt::ptree points;
+    for (auto &point : kernel.points) {
+      pt::ptree row;
+      row.put("Mads per element", point.mads_per_element);
+      row.put("Intensity", point.intensity);
+      row.put("Rate", point.gops);
+      row.put("GBPS", point.gbps);
+      points.push_back(std::make_pair("", row));
+    }
+    type.put_child("Points", points);
+    roofline.put_child(pt::ptree::path_type(kernel.label, '/'), type);
+  }
+
+  pt::write_json(file_name, roofline);
+}
+
+void ZePeak::ze_peak_roofline(L0Context &context) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  TimingMeasurement type = is_bandwidth_with_event_timer();
+  struct ZeWorkGroups workgroup_info;
+  long double peak_gbps = 0;
+
+  ze_device_kernel_properties_t kernel_properties;
+  kernel_properties.version = ZE_DEVICE_KERNEL_PROPERTIES_VERSION_CURRENT;
+  result = zeDeviceGetKernelProperties(context.device, &kernel_properties);
+  if (result) {
+    throw std::runtime_error("zeDeviceGetKernelProperties failed: " +
+                             std::to_string(result));
+  }
+
+  // The half & double kernels are in modules of their own, like the hp & dp
+  // compute kernels, so that devices without them can still load the others
+  std::vector<RooflineKernel> kernels = {
+      {"ze_roofline_hp.spv", "roofline_hp", "fp16", "GFLOPS",
+       sizeof(uint16_t), static_cast<bool>(kernel_properties.fp16Supported),
+       {}, 0},
+      {"ze_roofline.spv", "roofline_sp", "fp32", "GFLOPS", sizeof(float), true,
+       {}, 0},
+      {"ze_roofline_dp.spv", "roofline_dp", "fp64", "GFLOPS", sizeof(double),
+       static_cast<bool>(kernel_properties.fp64Supported), {}, 0},
+      {"ze_roofline.spv", "roofline_int", "int32", "GIOPS", sizeof(int32_t),
+       true, {}, 0}};
+
+  // Large enough that the reads come from device memory, not a cache
+  uint64_t buffer_size = std::min<uint64_t>(
+      ROOFLINE_BUFFER_SIZE, max_device_object_size(context) / 2);
+
+  void *device_input_buffer;
+  ze_device_mem_alloc_desc_t in_device_desc;
+  in_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  in_device_desc.ordinal = 0;
+  in_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocDeviceMem(context.driver, &in_device_desc,
+                                  static_cast<size_t>(buffer_size), 1,
+                                  context.device, &device_input_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocDeviceMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "device input buffer allocated\n";
+
+  void *device_output_buffer;
+  ze_device_mem_alloc_desc_t out_device_desc;
+  out_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  out_device_desc.ordinal = 0;
+  out_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocDeviceMem(
+      context.driver, &out_device_desc,
+      static_cast<size_t>(buffer_size / ROOFLINE_ELEMENTS_PER_WI), 1,
+      context.device, &device_output_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocDeviceMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "device output buffer allocated\n";
+
+  // Zero is a normal value in every data type, denormals would be slower
+  uint8_t zero = 0;
+  result = zeCommandListAppendMemoryFill(
+      context.command_list, device_input_buffer, &zero, sizeof(zero),
+      static_cast<size_t>(buffer_size), nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendMemoryFill failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Input buffer fill encoded\n";
+
+  context.execute_commandlist_and_sync();
+
+  std::cout << "Roofline (operations per byte of device memory traffic)\n";
+
+  for (auto &kernel : kernels) {
+    if (!kernel.supported) {
+      std::cout << kernel.label << " : not supported by the device\n";
+      continue;
+    }
+
+    std::vector<uint8_t> binary_file = context.load_binary_file(kernel.module);
+
+    context.create_module(binary_file);
+
+    uint64_t number_of_work_items = set_workgroups(
+        context, buffer_size / kernel.element_size / ROOFLINE_ELEMENTS_PER_WI,
+        &workgroup_info);
+    const long double bytes = static_cast<long double>(number_of_work_items) *
+                              (ROOFLINE_ELEMENTS_PER_WI + 1) *
+                              kernel.element_size;
+
+    for (uint32_t mads_per_element = 0;
+         mads_per_element <= ROOFLINE_MAX_MADS_PER_ELEMENT;
+         mads_per_element = mads_per_element ? mads_per_element * 2 : 1) {
+      // One kernel per step, the multiply-add count is compiled in
+      const std::string function_name =
+          std::string(kernel.name) + "_" + std::to_string(mads_per_element);
+      ze_kernel_handle_t function;
+      setup_function(context, function, function_name.c_str(),
+                     device_input_buffer, device_output_buffer);
+
+      long double timed = run_kernel(context, function, workgroup_info, type);
+      const long double operations =
+          static_cast<long double>(number_of_work_items) *
+          ROOFLINE_ELEMENTS_PER_WI * 2 * mads_per_element;
+
+      RooflinePoint point;
+      point.mads_per_element = mads_per_element;
+      point.intensity = operations / bytes;
+      point.gops = calculate_gbps(timed, operations);
+      point.gbps = calculate_gbps(timed, bytes);
+      kernel.points.push_back(point);
+      kernel.peak_gops = std::max(kernel.peak_gops, point.gops);
+      peak_gbps = std::max(peak_gbps, point.gbps);
+
+      std::cout << kernel.label << ", " << point.intensity << " ops/byte : "
+                << point.gops << " " << kernel.unit << ", " << point.gbps
+                << " GBPS\n";
+      if (mads_per_element) {
+        print_power_efficiency(point.gops, kernel.unit);
+      } else {
+        print_power_efficiency(point.gbps, "GBPS");
+      }
+
+      result = zeKernelDestroy(function);
+      if (result) {
+        throw std::runtime_error("zeKernelDestroy failed: " +
+                                 std::to_string(result));
+      }
+      if (verbose)
+        std::cout << function_name << " Function Destroyed\n";
+    }
+
+    result = zeModuleDestroy(context.module);
+    if (result) {
+      throw std::runtime_error("zeModuleDestroy failed: " +
+                               std::to_string(result));
+    }
+    if (verbose)
+      std::cout << "Module destroyed\n";
+  }
+
+  // The ridge point is the intensity where the bandwidth roof meets the
+  // compute roof, kernels below it are bandwidth bound
+  std::cout << "peak bandwidth : " << peak_gbps << " GBPS\n";
+  for (auto &kernel : kernels) {
+    if (kernel.points.empty())
+      continue;
+    std::cout << kernel.label << " : peak " << kernel.peak_gops << " "
+              << kernel.unit << ", ridge point "
+              << kernel.peak_gops / peak_gbps << " ops/byte\n";
+  }
+
+  if (!roofline_json_file.empty()) {
+    write_roofline_json(roofline_json_file, context, peak_gbps, kernels);
+    std::cout << "roofline written to " << roofline_json_file << "\n";
+  }
+
+  result = zeDriverFreeMem(context.driver, device_input_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverFreeMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Input Buffer freed\n";
+
+  result = zeDriverFreeMem(context.driver, device_output_buffer);
+  if (result) {
+    throw std::runtime_error("zeDriverFreeMem failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Output Buffer freed\n";
+
+  print_test_complete();
+}
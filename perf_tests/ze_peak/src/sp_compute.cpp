@@ -110,6 +110,7 @@ void ZePeak::ze_peak_sp_compute(L0Context &context) {
   timed = run_kernel(context, compute_sp_v1, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 2
@@ -117,6 +118,7 @@ void ZePeak::ze_peak_sp_compute(L0Context &context) {
   timed = run_kernel(context, compute_sp_v2, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 4
@@ -124,6 +126,7 @@ void ZePeak::ze_peak_sp_compute(L0Context &context) {
   timed = run_kernel(context, compute_sp_v4, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 8
@@ -131,6 +134,7 @@ void ZePeak::ze_peak_sp_compute(L0Context &context) {
   timed = run_kernel(context, compute_sp_v8, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 16
@@ -138,6 +142,7 @@ void ZePeak::ze_peak_sp_compute(L0Context &context) {
   timed = run_kernel(context, compute_sp_v16, workgroup_info, type);
   gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
   std::cout << gflops << " GFLOPS\n";
+  print_power_efficiency(gflops, "GFLOPS");
 
   result = zeKernelDestroy(compute_sp_v1);
   if (result) {
@@ -25,6 +25,7 @@ void ZePeak::_transfer_bw_gpu_copy(L0Context &context, void *destination_buffer,
   }
   context.execute_commandlist_and_sync();
 
+  begin_power_sample();
   timer.start();
   for (uint32_t i = 0; i < iters; i++) {
     result =
@@ -38,11 +39,13 @@ void ZePeak::_transfer_bw_gpu_copy(L0Context &context, void *destination_buffer,
 
   context.execute_commandlist_and_sync();
   timed = timer.stopAndTime();
+  end_power_sample();
   timed /= static_cast<long double>(iters);
 
   gbps = calculate_gbps(timed, static_cast<long double>(buffer_size));
 
   std::cout << gbps << " GBPS\n";
+  print_power_efficiency(gbps, "GBPS");
 }
 
 void ZePeak::_transfer_bw_host_copy(void *destination_buffer,
@@ -459,12 +459,14 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
 
     synchronize_command_queue(context);
 
+    begin_power_sample();
     timer.start();
     for (uint32_t i = 0; i < iters; i++) {
       run_command_queue(context);
     }
     synchronize_command_queue(context);
     timed = timer.stopAndTime();
+    end_power_sample();
   } else if (type == TimingMeasurement::BANDWIDTH_EVENT_TIMING) {
     ze_event_pool_handle_t event_pool;
     ze_event_handle_t function_event;
@@ -524,6 +526,7 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
         std::cout << "Event Reset" << std::endl;
     }
 
+    begin_power_sample();
     for (uint32_t i = 0; i < iters; i++) {
       timer.start();
       result = zeCommandQueueExecuteCommandLists(
@@ -556,6 +559,7 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
       if (verbose)
         std::cout << "Event Reset\n";
     }
+    end_power_sample();
     zeEventDestroy(function_event);
   } else if (type == TimingMeasurement::KERNEL_LAUNCH_LATENCY) {
     ze_event_handle_t kernel_launch_event;
@@ -739,6 +743,76 @@ uint64_t ZePeak::get_max_work_items(L0Context &context) {
          context.device_compute_property.maxGroupSizeX;
 }
 
+//---------------------------------------------------------------------
+// Utility function to estimate the peak vector multiply-add rate of the
+// device in GFLOPS, assuming every SIMD lane of every EU retires one
+// multiply-add (2 operations) per clock at coreClockRate (MHz).
+//---------------------------------------------------------------------
+long double ZePeak::get_peak_gflops(L0Context &context) {
+  const long double lanes =
+      static_cast<long double>(context.device_property.numSlices) *
+      context.device_property.numSubslicesPerSlice *
+      context.device_property.numEUsPerSubslice *
+      context.device_property.physicalEUSimdWidth;
+  return lanes * 2 * context.device_property.coreClockRate / 1e3;
+}
+
+//---------------------------------------------------------------------
+// Utility function to create the sysman power monitor when power & frequency
+// reporting was requested. Monitoring is skipped with a warning when the
+// device exposes no sysman power or frequency domains.
+//---------------------------------------------------------------------
+void ZePeak::init_power_monitor(L0Context &context) {
+  if (!monitor_power)
+    return;
+
+  power_monitor.reset(new ZePowerMonitor(context.device));
+  if (!power_monitor->is_supported())
+    power_monitor.reset();
+}
+
+//---------------------------------------------------------------------
+// Utility functions to sample power & frequency over a measured interval.
+// Samples taken before the next result is printed are merged together.
+//---------------------------------------------------------------------
+void ZePeak::begin_power_sample() {
+  if (power_monitor)
+    power_monitor->start();
+}
+
+void ZePeak::end_power_sample() {
+  if (power_monitor)
+    power_sample.merge(power_monitor->stop());
+}
+
+//---------------------------------------------------------------------
+// Utility function to print the power, perf per watt & throttling state
+// recorded while measuring the given result.
+//---------------------------------------------------------------------
+void ZePeak::print_power_efficiency(long double rate, const char *unit) {
+  if (!power_monitor)
+    return;
+
+  std::cout << "  power : " << power_sample.to_string(rate, unit) << "\n";
+  power_sample = PowerSample();
+}
+
+//---------------------------------------------------------------------
+// Utility function to print a rate as a fraction of the theoretical peak
+// of the path that measured it. A peak of 0 means there is none to compare
+// against.
+//---------------------------------------------------------------------
+void ZePeak::print_fraction_of_peak(long double rate, long double peak,
+                                    const char *unit) {
+  if (peak <= 0) {
+    std::cout << "  no theoretical peak for this path\n";
+    return;
+  }
+
+  std::cout << "  " << (rate / peak) * 100 << "% of theoretical peak ("
+            << peak << " " << unit << ")\n";
+}
+
 //---------------------------------------------------------------------
 // Utility function to print a standard string to end a test.
 //---------------------------------------------------------------------
@@ -758,6 +832,7 @@ int main(int argc, char **argv) {
   context.verbose = peak_benchmark.verbose;
 
   context.init_xe();
+  peak_benchmark.init_power_monitor(context);
 
   if (peak_benchmark.run_global_bw)
     peak_benchmark.ze_peak_global_bw(context);
@@ -780,6 +855,27 @@ int main(int argc, char **argv) {
   if (peak_benchmark.run_kernel_lat)
     peak_benchmark.ze_peak_kernel_latency(context);
 
+  if (peak_benchmark.run_mem_latency)
+    peak_benchmark.ze_peak_mem_latency(context);
+
+  if (peak_benchmark.run_local_bw)
+    peak_benchmark.ze_peak_local_bw(context);
+
+  if (peak_benchmark.run_atomics)
+    peak_benchmark.ze_peak_atomics(context);
+
+  if (peak_benchmark.run_sub_group)
+    peak_benchmark.ze_peak_sub_group(context);
+
+  if (peak_benchmark.run_roofline)
+    peak_benchmark.ze_peak_roofline(context);
+
+  if (peak_benchmark.run_dot_product)
+    peak_benchmark.ze_peak_dot_product(context);
+
+  if (peak_benchmark.run_gemm)
+    peak_benchmark.ze_peak_gemm(context);
+
   context.clean_xe();
 
   return 0;
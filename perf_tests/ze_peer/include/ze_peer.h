@@ -17,6 +17,7 @@ enum peer_transfer_t {
 struct device_context_t {
     ze_device_handle_t device;
     ze_module_handle_t module;
+    ze_module_handle_t access_module; /* nullptr without ze_peer_access.spv */
     ze_command_queue_handle_t command_queue;
     ze_command_list_handle_t command_list;
 };
@@ -0,0 +1,26 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+/* Every load depends on the previous one, so the time per step is the
+ * load-to-use latency of wherever chain lives */
+__kernel void peer_pointer_chase(__global const uint *chain, uint steps,
+                                 __global uint *result) {
+  uint index = 0;
+  for (uint i = 0; i < steps; i++) {
+    index = chain[index];
+  }
+  result[0] = index;
+}
+
+/* All work-items of all launching devices add to the same counter */
+__kernel void peer_atomic_add(volatile __global uint *counter,
+                              uint iterations) {
+  for (uint i = 0; i < iterations; i++) {
+    atomic_add(counter, 1);
+  }
+}
@@ -12,9 +12,13 @@
 #include "ze_app.hpp"
 #include "ze_peer.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <random>
 
 class ZePeer {
 public:
@@ -37,6 +41,16 @@ public:
 
     device_contexts = new std::vector<device_context_t>(device_count);
 
+    std::ifstream stream("ze_peer_access.spv", std::ios::in | std::ios::binary);
+    std::vector<uint8_t> access_binary(
+        (std::istreambuf_iterator<char>(stream)),
+        std::istreambuf_iterator<char>());
+    if (access_binary.empty()) {
+      std::cerr << "WARNING : ze_peer_access.spv not found, access latency "
+                   "and atomic measurements skipped"
+                << std::endl;
+    }
+
     for (uint32_t i = 0; i < device_count; i++) {
       ze_device_handle_t device;
       ze_module_handle_t module;
@@ -50,6 +64,8 @@ public:
       device_context->device = device;
       device_context->module = module;
       device_context->command_queue = command_queue;
+      device_context->access_module =
+          _access_module_create(device, access_binary);
       benchmark->commandListCreate(device, &device_context->command_list);
     }
   }
@@ -58,6 +74,9 @@ public:
     for (uint32_t i = 0; i < device_count; i++) {
       device_context_t *device_context = &device_contexts->at(i);
       benchmark->moduleDestroy(device_context->module);
+      if (device_context->access_module) {
+        benchmark->moduleDestroy(device_context->access_module);
+      }
       benchmark->commandQueueDestroy(device_context->command_queue);
       benchmark->commandListDestroy(device_context->command_list);
     }
@@ -69,6 +88,8 @@ public:
 
   void bandwidth(bool bidirectional, peer_transfer_t transfer_type);
   void latency(bool bidirectional, peer_transfer_t transfer_type);
+  void access_latency();
+  void atomic_throughput();
 
 private:
   ZeApp *benchmark;
@@ -85,8 +106,59 @@ private:
                             uint32_t &group_size_x, uint32_t &group_size_y,
                             uint32_t &group_size_z);
   void _copy_function_cleanup(ze_kernel_handle_t function);
+  ze_module_handle_t
+  _access_module_create(ze_device_handle_t device,
+                        std::vector<uint8_t> &access_binary);
+  bool _access_modules_loaded();
+  bool _can_access(uint32_t device_index, uint32_t peer_index);
+  long double _time_pointer_chase(device_context_t *device_context,
+                                  ze_kernel_handle_t function, void *chain,
+                                  uint32_t steps, void *result);
 };
 
+ze_module_handle_t
+ZePeer::_access_module_create(ze_device_handle_t device,
+                              std::vector<uint8_t> &access_binary) {
+  if (access_binary.empty())
+    return nullptr;
+
+  ze_module_desc_t module_description;
+  module_description.version = ZE_MODULE_DESC_VERSION_CURRENT;
+  module_description.format = ZE_MODULE_FORMAT_IL_SPIRV;
+  module_description.inputSize = access_binary.size();
+  module_description.pInputModule = access_binary.data();
+  module_description.pBuildFlags = nullptr;
+
+  ze_module_handle_t module = nullptr;
+  ze_result_t result =
+      zeModuleCreate(device, &module_description, &module, nullptr);
+  if (result) {
+    std::cerr << "WARNING : zeModuleCreate failed for ze_peer_access.spv : "
+              << result << std::endl;
+    return nullptr;
+  }
+  return module;
+}
+
+bool ZePeer::_access_modules_loaded() {
+  for (auto &device_context : *device_contexts) {
+    if (!device_context.access_module)
+      return false;
+  }
+  return true;
+}
+
+/* A device can always access its own memory */
+bool ZePeer::_can_access(uint32_t device_index, uint32_t peer_index) {
+  if (device_index == peer_index)
+    return true;
+
+  ze_bool_t can_access = false;
+  SUCCESS_OR_TERMINATE(zeDeviceCanAccessPeer(
+      devices->at(device_index), devices->at(peer_index), &can_access));
+  return can_access;
+}
+
 void ZePeer::_copy_function_setup(ze_module_handle_t module,
                                   ze_kernel_handle_t &function,
                                   const char *function_name,
@@ -406,6 +478,292 @@ void ZePeer::latency(bool bidirectional, peer_transfer_t transfer_type) {
   }
 }
 
+/* Average time of one launch of the single work-item chase kernel */
+long double ZePeer::_time_pointer_chase(device_context_t *device_context,
+                                        ze_kernel_handle_t function,
+                                        void *chain, uint32_t steps,
+                                        void *result) {
+  int number_iterations = 10;
+  int warm_up_iterations = 2;
+  ze_command_list_handle_t command_list = device_context->command_list;
+  ze_command_queue_handle_t command_queue = device_context->command_queue;
+  ze_group_count_t thread_group_dimensions = {1, 1, 1};
+  Timer<std::chrono::microseconds::period> timer;
+
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(function, 0, sizeof(chain), &chain));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(function, 1, sizeof(steps), &steps));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(function, 2, sizeof(result), &result));
+  SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+      command_list, function, &thread_group_dimensions, nullptr, 0, nullptr));
+  benchmark->commandListClose(command_list);
+
+  for (int i = 0; i < warm_up_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list);
+    benchmark->commandQueueSynchronize(command_queue);
+  }
+
+  timer.start();
+  for (int i = 0; i < number_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list);
+    benchmark->commandQueueSynchronize(command_queue);
+  }
+  timer.end();
+
+  benchmark->commandListReset(command_list);
+  return timer.period_minus_overhead() /
+         static_cast<long double>(number_iterations);
+}
+
+/*
+ * Load-to-use latency of device i reading device j's memory. A single
+ * work-item follows a random cycle through 64 byte nodes, so every load
+ * depends on the previous one and neither prefetching nor coalescing can
+ * hide it. Launch overhead cancels out of the difference between a chase of
+ * 2 * steps and one of steps.
+ */
+void ZePeer::access_latency() {
+  const size_t node_stride = 64 / sizeof(uint32_t);
+  const size_t min_size = 64 * 1024;
+  const size_t max_size = 256 * 1024 * 1024;
+  const uint32_t steps = 1 << 14;
+  std::vector<void *> chains(device_count, nullptr);
+  std::vector<void *> results(device_count, nullptr);
+  std::vector<ze_kernel_handle_t> functions(device_count, nullptr);
+  void *host_chain = nullptr;
+  std::mt19937 random_engine(0);
+
+  if (!_access_modules_loaded())
+    return;
+
+  for (uint32_t i = 0; i < device_count; i++) {
+    device_context_t *device_context = &device_contexts->at(i);
+    benchmark->memoryAlloc(driver, device_context->device, max_size,
+                           &chains[i]);
+    benchmark->memoryAlloc(driver, device_context->device, sizeof(uint32_t),
+                           &results[i]);
+    benchmark->functionCreate(device_context->access_module, &functions[i],
+                              "peer_pointer_chase");
+    /* One work-item in one group, a larger default group would run
+     * several overlapping chases */
+    SUCCESS_OR_TERMINATE(zeKernelSetGroupSize(functions[i], 1, 1, 1));
+  }
+  benchmark->memoryAllocHost(driver, max_size, &host_chain);
+
+  for (size_t size = min_size; size <= max_size; size *= 8) {
+    /* Sattolo's shuffle, the nodes form a single cycle */
+    const size_t nodes = size / (node_stride * sizeof(uint32_t));
+    std::vector<uint32_t> next(nodes);
+    for (size_t k = 0; k < nodes; k++) {
+      next[k] = static_cast<uint32_t>(k);
+    }
+    for (size_t k = nodes - 1; k > 0; k--) {
+      std::uniform_int_distribution<size_t> distribution(0, k - 1);
+      std::swap(next[k], next[distribution(random_engine)]);
+    }
+
+    uint32_t *chain = static_cast<uint32_t *>(host_chain);
+    for (size_t k = 0; k < nodes; k++) {
+      chain[k * node_stride] = static_cast<uint32_t>(next[k] * node_stride);
+    }
+
+    for (uint32_t j = 0; j < device_count; j++) {
+      device_context_t *device_context_j = &device_contexts->at(j);
+      benchmark->commandListAppendMemoryCopy(device_context_j->command_list,
+                                             chains[j], host_chain, size);
+      benchmark->commandListClose(device_context_j->command_list);
+      benchmark->commandQueueExecuteCommandList(
+          device_context_j->command_queue, 1, &device_context_j->command_list);
+      benchmark->commandQueueSynchronize(device_context_j->command_queue);
+      benchmark->commandListReset(device_context_j->command_list);
+    }
+
+    for (uint32_t i = 0; i < device_count; i++) {
+      device_context_t *device_context_i = &device_contexts->at(i);
+
+      for (uint32_t j = 0; j < device_count; j++) {
+        std::cout << std::setw(12) << size << " bytes Device(" << i
+                  << ")<-Device(" << j << "): ";
+        if (!_can_access(i, j)) {
+          std::cout << "no peer access" << std::endl;
+          continue;
+        }
+
+        const long double single_usec = _time_pointer_chase(
+            device_context_i, functions[i], chains[j], steps, results[i]);
+        const long double double_usec = _time_pointer_chase(
+            device_context_i, functions[i], chains[j], 2 * steps, results[i]);
+        const long double latency_nsec =
+            (double_usec - single_usec) * 1000 / steps;
+        std::cout << std::setprecision(6) << latency_nsec << " nS"
+                  << std::endl;
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < device_count; i++) {
+    _copy_function_cleanup(functions[i]);
+    benchmark->memoryFree(driver, chains[i]);
+    benchmark->memoryFree(driver, results[i]);
+  }
+  benchmark->memoryFree(driver, host_chain);
+}
+
+/*
+ * Atomic add throughput on a single counter in device j's memory while a
+ * growing number of devices, starting with j's peers and ending with j
+ * itself, add to it concurrently from a growing number of work-items each.
+ * The final counter is checked against the number of adds issued.
+ */
+void ZePeer::atomic_throughput() {
+  int number_iterations = 5;
+  int warm_up_iterations = 1;
+  uint32_t adds_per_work_item = 64;
+  const uint32_t work_item_counts[] = {1, 64, 4096, 65536};
+  std::vector<void *> counters(device_count, nullptr);
+  std::vector<ze_kernel_handle_t> functions(device_count, nullptr);
+  uint32_t *host_counter = nullptr;
+
+  if (!_access_modules_loaded())
+    return;
+
+  for (uint32_t i = 0; i < device_count; i++) {
+    device_context_t *device_context = &device_contexts->at(i);
+    benchmark->memoryAlloc(driver, device_context->device, sizeof(uint32_t),
+                           &counters[i]);
+    benchmark->functionCreate(device_context->access_module, &functions[i],
+                              "peer_atomic_add");
+  }
+  benchmark->memoryAllocHost(driver, sizeof(uint32_t),
+                             reinterpret_cast<void **>(&host_counter));
+
+  for (uint32_t j = 0; j < device_count; j++) {
+    device_context_t *device_context_j = &device_contexts->at(j);
+    void *counter = counters[j];
+
+    for (uint32_t contenders = 1; contenders <= device_count; contenders++) {
+      std::vector<uint32_t> contender_indices;
+      bool all_can_access = true;
+      for (uint32_t c = 0; c < contenders; c++) {
+        const uint32_t i = (j + 1 + c) % device_count;
+        contender_indices.push_back(i);
+        all_can_access = all_can_access && _can_access(i, j);
+      }
+      if (!all_can_access) {
+        std::cout << " " << contenders << " device(s)->Device(" << j
+                  << "): no peer access" << std::endl;
+        continue;
+      }
+
+      for (uint32_t work_items : work_item_counts) {
+        Timer<std::chrono::microseconds::period> timer;
+        uint64_t launched_work_items = 0;
+
+        *host_counter = 0;
+        benchmark->commandListAppendMemoryCopy(device_context_j->command_list,
+                                               counter, host_counter,
+                                               sizeof(uint32_t));
+        benchmark->commandListClose(device_context_j->command_list);
+        benchmark->commandQueueExecuteCommandList(
+            device_context_j->command_queue, 1,
+            &device_context_j->command_list);
+        benchmark->commandQueueSynchronize(device_context_j->command_queue);
+        benchmark->commandListReset(device_context_j->command_list);
+
+        for (uint32_t i : contender_indices) {
+          device_context_t *device_context_i = &device_contexts->at(i);
+          uint32_t group_size_x = 0;
+          uint32_t group_size_y = 0;
+          uint32_t group_size_z = 0;
+          SUCCESS_OR_TERMINATE(
+              zeKernelSuggestGroupSize(functions[i], work_items, 1, 1,
+                                       &group_size_x, &group_size_y,
+                                       &group_size_z));
+          SUCCESS_OR_TERMINATE(zeKernelSetGroupSize(
+              functions[i], group_size_x, group_size_y, group_size_z));
+          SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(
+              functions[i], 0, sizeof(counter), &counter));
+          SUCCESS_OR_TERMINATE(
+              zeKernelSetArgumentValue(functions[i], 1,
+                                       sizeof(adds_per_work_item),
+                                       &adds_per_work_item));
+
+          ze_group_count_t thread_group_dimensions;
+          thread_group_dimensions.groupCountX = work_items / group_size_x;
+          thread_group_dimensions.groupCountY = 1;
+          thread_group_dimensions.groupCountZ = 1;
+          launched_work_items +=
+              thread_group_dimensions.groupCountX * group_size_x;
+
+          SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+              device_context_i->command_list, functions[i],
+              &thread_group_dimensions, nullptr, 0, nullptr));
+          benchmark->commandListClose(device_context_i->command_list);
+        }
+
+        /* Every contender is submitted before any is waited on */
+        for (int iteration = 0;
+             iteration < warm_up_iterations + number_iterations;
+             iteration++) {
+          if (iteration == warm_up_iterations) {
+            timer.start();
+          }
+          for (uint32_t i : contender_indices) {
+            device_context_t *device_context_i = &device_contexts->at(i);
+            benchmark->commandQueueExecuteCommandList(
+                device_context_i->command_queue, 1,
+                &device_context_i->command_list);
+          }
+          for (uint32_t i : contender_indices) {
+            benchmark->commandQueueSynchronize(
+                device_contexts->at(i).command_queue);
+          }
+        }
+        timer.end();
+
+        for (uint32_t i : contender_indices) {
+          benchmark->commandListReset(device_contexts->at(i).command_list);
+        }
+
+        benchmark->commandListAppendMemoryCopy(device_context_j->command_list,
+                                               host_counter, counter,
+                                               sizeof(uint32_t));
+        benchmark->commandListClose(device_context_j->command_list);
+        benchmark->commandQueueExecuteCommandList(
+            device_context_j->command_queue, 1,
+            &device_context_j->command_list);
+        benchmark->commandQueueSynchronize(device_context_j->command_queue);
+        benchmark->commandListReset(device_context_j->command_list);
+
+        const uint64_t adds_per_launch =
+            launched_work_items * adds_per_work_item;
+        const uint64_t expected =
+            adds_per_launch * (warm_up_iterations + number_iterations);
+        const long double total_time_usec = timer.period_minus_overhead();
+        const long double giga_adds_per_second =
+            (adds_per_launch * number_iterations) / total_time_usec / 1e3;
+
+        std::cout << " " << contenders << " device(s)->Device(" << j << "), "
+                  << std::setw(6) << work_items
+                  << " work-items each: " << std::setprecision(6)
+                  << giga_adds_per_second << " Gatomics/s" << std::endl;
+        if (*host_counter != static_cast<uint32_t>(expected)) {
+          std::cerr << "WARNING : counter is " << *host_counter
+                    << ", expected " << expected << std::endl;
+        }
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < device_count; i++) {
+    _copy_function_cleanup(functions[i]);
+    benchmark->memoryFree(driver, counters[i]);
+  }
+  benchmark->memoryFree(driver, host_counter);
+}
+
 int main(int argc, char **argv) {
   ZePeer peer;
 
@@ -433,5 +791,14 @@ int main(int argc, char **argv) {
   peer.latency(true /* bidirectional */, PEER_NONE);
   std::cout << std::endl;
 
+  std::cout << "P2P Access Latency (pointer chasing)" << std::endl;
+  peer.access_latency();
+  std::cout << std::endl;
+
+  std::cout << "P2P Atomic Throughput (atomic_add on one counter)"
+            << std::endl;
+  peer.atomic_throughput();
+  std::cout << std::endl;
+
   return 0;
 }
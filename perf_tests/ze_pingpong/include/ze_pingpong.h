@@ -17,6 +17,7 @@
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <atomic>
 #include <math.h>
 #include <numeric>
 #include <stdio.h>
@@ -36,9 +37,67 @@ enum TestType {
   SHARED_MEM_MAP
 };
 
+/*
+ * How the host submits the kernel and learns that it has completed.
+ * Every mode runs the same host memory round trip, so the differences
+ * between them are the cost of the submission and completion path alone.
+ */
+enum SubmitMode {
+  QUEUE_SYNCHRONOUS,
+  QUEUE_SYNCHRONIZE,
+  QUEUE_EVENT_WAIT,
+  QUEUE_BUSY_POLL,
+  IMMEDIATE_SYNCHRONOUS,
+  IMMEDIATE_EVENT_WAIT,
+  IMMEDIATE_BUSY_POLL
+};
+
+struct LatencyDistribution {
+  double min = 0;
+  double mean = 0;
+  double p50 = 0;
+  double p90 = 0;
+  double p99 = 0;
+  double p999 = 0;
+  double max = 0;
+};
+
+/*
+ * Each persistent kernel mailbox spans two cache lines by default, with the
+ * host written request at the start of the first and the device written
+ * response at the start of the second.
+ */
+const int mailbox_stride = 32;
+const int mailbox_response_offset = 16;
+const uint32_t max_mailboxes = 64;
+
+/*
+ * Placement of the persistent kernel mailboxes, in ints: mailbox m has its
+ * request at m * stride and its response response_offset ints later.
+ */
+struct MailboxLayout {
+  const char *name;
+  int stride;
+  int response_offset;
+  uint32_t count;
+
+  size_t size() const { return count * stride * sizeof(int); }
+};
+
+struct MailboxResult {
+  LatencyDistribution latency;
+  double round_trips_per_sec = 0;
+};
+
 struct L0Context {
   ze_command_queue_handle_t command_queue = nullptr;
   ze_command_list_handle_t command_list = nullptr;
+  ze_command_queue_handle_t async_command_queue = nullptr;
+  ze_command_list_handle_t event_command_list = nullptr;
+  ze_command_list_handle_t immediate_command_list = nullptr;
+  ze_command_list_handle_t async_immediate_command_list = nullptr;
+  ze_event_pool_handle_t event_pool = nullptr;
+  ze_event_handle_t event = nullptr;
   ze_module_handle_t module = nullptr;
   ze_driver_handle_t driver = nullptr;
   ze_device_handle_t device = nullptr;
@@ -73,6 +132,17 @@ public:
   void reset_commandlist(L0Context &context);
   void synchronize_command_queue(L0Context &context);
   void verify_result(int result);
+  void submit_and_wait(L0Context &context, enum SubmitMode mode,
+                       volatile int *flag);
+  LatencyDistribution measure_latency(L0Context &context,
+                                      enum SubmitMode mode);
+  LatencyDistribution compute_distribution(std::vector<double> &samples);
+  void run_submit_mode_test(L0Context &context);
+  MailboxResult measure_mailboxes(L0Context &context, ze_kernel_handle_t kernel,
+                                  volatile int *mailboxes,
+                                  const MailboxLayout &layout, int rounds);
+  void run_persistent_kernel_test(L0Context &context);
+  void run_placement_test(L0Context &context, ze_kernel_handle_t kernel);
 };
 
 #endif /* ZE_PINGPONG_H */
@@ -11,3 +11,24 @@ kPingPong(__global int *buf) {
   if (get_global_id(0) == 0)
     (*buf)++;
 }
+
+/*
+ * Persistent ping-pong: every work-item owns one mailbox and spins on its
+ * request slot until the host posts round trip i, then answers by writing
+ * i to its response slot. A negative request stops the kernel early.
+ */
+__kernel __attribute__((reqd_work_group_size(1, 1, 1))) void
+kPersistentPingPong(__global volatile int *mailboxes, int stride,
+                    int response_offset, int iterations) {
+  __global volatile int *request = mailboxes + get_global_id(0) * stride;
+  __global volatile int *response = request + response_offset;
+
+  for (int i = 1; i <= iterations; i++) {
+    int value;
+    while ((value = atomic_add(request, 0)) != i) {
+      if (value < 0)
+        return;
+    }
+    atomic_xchg(response, i);
+  }
+}
@@ -81,6 +81,60 @@ void L0Context::init() {
                              std::to_string(result));
   }
 
+  /* Submission mode experiments wait for completion explicitly */
+  command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS;
+  result = zeCommandQueueCreate(device, &command_queue_description,
+                                &async_command_queue);
+  if (result) {
+    throw std::runtime_error("zeDeviceCreateCommandQueue failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeCommandListCreate(device, &command_list_description,
+                               &event_command_list);
+  if (result) {
+    throw std::runtime_error("zeDeviceCreateCommandList failed: " +
+                             std::to_string(result));
+  }
+
+  command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS;
+  result = zeCommandListCreateImmediate(device, &command_queue_description,
+                                        &immediate_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListCreateImmediate failed: " +
+                             std::to_string(result));
+  }
+
+  command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS;
+  result = zeCommandListCreateImmediate(device, &command_queue_description,
+                                        &async_immediate_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListCreateImmediate failed: " +
+                             std::to_string(result));
+  }
+
+  ze_event_pool_desc_t event_pool_description;
+  event_pool_description.version = ZE_EVENT_POOL_DESC_VERSION_CURRENT;
+  event_pool_description.flags = ZE_EVENT_POOL_FLAG_HOST_VISIBLE;
+  event_pool_description.count = 1;
+  result = zeEventPoolCreate(driver, &event_pool_description, 1, &device,
+                             &event_pool);
+  if (result) {
+    throw std::runtime_error("zeEventPoolCreate failed: " +
+                             std::to_string(result));
+  }
+
+  ze_event_desc_t event_description;
+  event_description.version = ZE_EVENT_DESC_VERSION_CURRENT;
+  event_description.index = 0;
+  event_description.signal = ZE_EVENT_SCOPE_FLAG_HOST;
+  event_description.wait = ZE_EVENT_SCOPE_FLAG_HOST;
+  result = zeEventCreate(event_pool, &event_description, &event);
+  if (result) {
+    throw std::runtime_error("zeEventCreate failed: " +
+                             std::to_string(result));
+  }
+
   ze_device_mem_alloc_desc_t device_desc;
   device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
   device_desc.ordinal = 0;
@@ -137,6 +191,42 @@ void L0Context::destroy() {
                              std::to_string(result));
   }
 
+  result = zeCommandQueueDestroy(async_command_queue);
+  if (result) {
+    throw std::runtime_error("zeCommandQueueDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeCommandListDestroy(event_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeCommandListDestroy(immediate_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeCommandListDestroy(async_immediate_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeEventDestroy(event);
+  if (result) {
+    throw std::runtime_error("zeEventDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeEventPoolDestroy(event_pool);
+  if (result) {
+    throw std::runtime_error("zeEventPoolDestroy failed: " +
+                             std::to_string(result));
+  }
+
   result = zeDriverFreeMem(driver, device_input);
   if (result) {
     throw std::runtime_error("zeDriverFreeMem failed: " +
@@ -407,6 +497,602 @@ double ZePingPong::measure_benchmark(L0Context &context, enum TestType test) {
   return elapsed_time;
 }
 
+static const char *to_string(enum SubmitMode mode) {
+  switch (mode) {
+  case QUEUE_SYNCHRONOUS:
+    return "QUEUE_SYNCHRONOUS";
+  case QUEUE_SYNCHRONIZE:
+    return "QUEUE_SYNCHRONIZE";
+  case QUEUE_EVENT_WAIT:
+    return "QUEUE_EVENT_WAIT";
+  case QUEUE_BUSY_POLL:
+    return "QUEUE_BUSY_POLL";
+  case IMMEDIATE_SYNCHRONOUS:
+    return "IMMEDIATE_SYNCHRONOUS";
+  case IMMEDIATE_EVENT_WAIT:
+    return "IMMEDIATE_EVENT_WAIT";
+  case IMMEDIATE_BUSY_POLL:
+    return "IMMEDIATE_BUSY_POLL";
+  }
+  return "UNKNOWN";
+}
+
+//---------------------------------------------------------------------
+// Utility function to launch the kernel once in the given submission mode
+// and return only after the host has observed its completion. The busy
+// poll modes spin on the host memory integer the kernel increments.
+// On error, an exception will be thrown describing the failure.
+//---------------------------------------------------------------------
+void ZePingPong::submit_and_wait(L0Context &context, enum SubmitMode mode,
+                                 volatile int *flag) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+
+  switch (mode) {
+  case QUEUE_SYNCHRONOUS:
+    run_command_queue(context);
+    break;
+
+  case QUEUE_SYNCHRONIZE:
+  case QUEUE_BUSY_POLL:
+    result = zeCommandQueueExecuteCommandLists(
+        context.async_command_queue, 1, &context.command_list, nullptr);
+    if (result) {
+      throw std::runtime_error("zeCommandQueueExecuteCommandLists failed: " +
+                               std::to_string(result));
+    }
+    if (mode == QUEUE_BUSY_POLL) {
+      while (*flag == 0) {
+      }
+      break;
+    }
+    result = zeCommandQueueSynchronize(context.async_command_queue, UINT32_MAX);
+    if (result) {
+      throw std::runtime_error("zeCommandQueueSynchronize failed: " +
+                               std::to_string(result));
+    }
+    break;
+
+  case QUEUE_EVENT_WAIT:
+    result = zeCommandQueueExecuteCommandLists(
+        context.async_command_queue, 1, &context.event_command_list, nullptr);
+    if (result) {
+      throw std::runtime_error("zeCommandQueueExecuteCommandLists failed: " +
+                               std::to_string(result));
+    }
+    break;
+
+  case IMMEDIATE_SYNCHRONOUS:
+    result = zeCommandListAppendLaunchKernel(
+        context.immediate_command_list, context.function,
+        &context.thread_group_dimensions, nullptr, 0, nullptr);
+    if (result) {
+      throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
+                               std::to_string(result));
+    }
+    break;
+
+  case IMMEDIATE_EVENT_WAIT:
+  case IMMEDIATE_BUSY_POLL:
+    result = zeCommandListAppendLaunchKernel(
+        context.async_immediate_command_list, context.function,
+        &context.thread_group_dimensions,
+        (mode == IMMEDIATE_EVENT_WAIT) ? context.event : nullptr, 0, nullptr);
+    if (result) {
+      throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
+                               std::to_string(result));
+    }
+    if (mode == IMMEDIATE_BUSY_POLL) {
+      while (*flag == 0) {
+      }
+    }
+    break;
+  }
+
+  if ((mode == QUEUE_EVENT_WAIT) || (mode == IMMEDIATE_EVENT_WAIT)) {
+    result = zeEventHostSynchronize(context.event, UINT32_MAX);
+    if (result) {
+      throw std::runtime_error("zeEventHostSynchronize failed: " +
+                               std::to_string(result));
+    }
+    result = zeEventHostReset(context.event);
+    if (result) {
+      throw std::runtime_error("zeEventHostReset failed: " +
+                               std::to_string(result));
+    }
+  }
+}
+
+LatencyDistribution
+ZePingPong::compute_distribution(std::vector<double> &samples) {
+  LatencyDistribution distribution;
+
+  if (samples.empty())
+    return distribution;
+
+  std::sort(samples.begin(), samples.end());
+  auto percentile = [&samples](double fraction) {
+    size_t index = static_cast<size_t>(fraction * samples.size());
+    return samples[std::min(index, samples.size() - 1)];
+  };
+
+  distribution.min = samples.front();
+  distribution.mean =
+      std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+  distribution.p50 = percentile(0.50);
+  distribution.p90 = percentile(0.90);
+  distribution.p99 = percentile(0.99);
+  distribution.p999 = percentile(0.999);
+  distribution.max = samples.back();
+  return distribution;
+}
+
+//---------------------------------------------------------------------
+// Times every round trip of the host memory ping-pong individually:
+// the kernel increments the integer, the host waits for completion in
+// the given mode and decrements it again. Returns latencies in usec.
+//---------------------------------------------------------------------
+LatencyDistribution ZePingPong::measure_latency(L0Context &context,
+                                                enum SubmitMode mode) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  volatile int *pong = static_cast<volatile int *>(context.host_output);
+  std::vector<double> samples(num_execute);
+
+  pong[0] = 0;
+  // Warm-up
+  for (int i = 0; i < num_execute / 10; i++) {
+    submit_and_wait(context, mode, pong);
+    pong[0]--;
+  }
+
+  for (int i = 0; i < num_execute; i++) {
+    auto clk_begin = std::chrono::high_resolution_clock::now();
+    submit_and_wait(context, mode, pong);
+    pong[0]--;
+    auto clk_end = std::chrono::high_resolution_clock::now();
+    samples[i] =
+        static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(clk_end -
+                                                                 clk_begin)
+                .count()) /
+        1000.0;
+  }
+
+  // Busy polling only observes the kernel's store, so retire the
+  // outstanding work before the command lists are reused.
+  if (mode == QUEUE_BUSY_POLL) {
+    result = zeCommandQueueSynchronize(context.async_command_queue, UINT32_MAX);
+    if (result) {
+      throw std::runtime_error("zeCommandQueueSynchronize failed: " +
+                               std::to_string(result));
+    }
+  } else if (mode == IMMEDIATE_BUSY_POLL) {
+    result = zeCommandListAppendBarrier(context.async_immediate_command_list,
+                                        context.event, 0, nullptr);
+    if (result) {
+      throw std::runtime_error("zeCommandListAppendExecutionBarrier failed: " +
+                               std::to_string(result));
+    }
+    result = zeEventHostSynchronize(context.event, UINT32_MAX);
+    if (result) {
+      throw std::runtime_error("zeEventHostSynchronize failed: " +
+                               std::to_string(result));
+    }
+    result = zeEventHostReset(context.event);
+    if (result) {
+      throw std::runtime_error("zeEventHostReset failed: " +
+                               std::to_string(result));
+    }
+  }
+
+  verify_result(pong[0]);
+  return compute_distribution(samples);
+}
+
+void ZePingPong::run_submit_mode_test(L0Context &context) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  int *pong = static_cast<int *>(context.host_output);
+  const SubmitMode modes[] = {QUEUE_SYNCHRONOUS,    QUEUE_SYNCHRONIZE,
+                              QUEUE_EVENT_WAIT,     QUEUE_BUSY_POLL,
+                              IMMEDIATE_SYNCHRONOUS, IMMEDIATE_EVENT_WAIT,
+                              IMMEDIATE_BUSY_POLL};
+
+  set_argument_value(context, 0, sizeof(pong), &pong);
+  reset_commandlist(context);
+  setup_commandlist(context, HOST_MEM_KERNEL_ONLY);
+
+  result = zeCommandListReset(context.event_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListReset failed: " +
+                             std::to_string(result));
+  }
+  result = zeCommandListAppendLaunchKernel(
+      context.event_command_list, context.function,
+      &context.thread_group_dimensions, context.event, 0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
+                             std::to_string(result));
+  }
+  result = zeCommandListClose(context.event_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListClose failed: " +
+                             std::to_string(result));
+  }
+
+  std::cout << "\n"
+            << "SUBMISSION MODE EXPERIMENTS: HOST MEMORY ROUND TRIP, "
+            << "USEC PER LOOP\n\n";
+  std::cout << std::left << std::setw(23) << "Mode" << std::setw(8) << ""
+            << std::right << std::setw(9) << "min" << std::setw(9) << "mean"
+            << std::setw(9) << "p50" << std::setw(9) << "p90" << std::setw(9)
+            << "p99" << std::setw(9) << "p99.9" << std::setw(9) << "max"
+            << "\n";
+
+  SubmitMode fastest = QUEUE_SYNCHRONOUS;
+  double fastest_p50 = 0;
+  for (auto mode : modes) {
+    std::cout << std::left << std::setw(23) << to_string(mode) << std::right;
+    LatencyDistribution distribution = measure_latency(context, mode);
+    std::cout << std::fixed << std::setprecision(2) << std::setw(9)
+              << distribution.min << std::setw(9) << distribution.mean
+              << std::setw(9) << distribution.p50 << std::setw(9)
+              << distribution.p90 << std::setw(9) << distribution.p99
+              << std::setw(9) << distribution.p999 << std::setw(9)
+              << distribution.max << "\n";
+
+    if ((mode == modes[0]) || (distribution.p50 < fastest_p50)) {
+      fastest = mode;
+      fastest_p50 = distribution.p50;
+    }
+  }
+  std::cout << "\n"
+            << "Lowest median round trip: " << to_string(fastest) << " ("
+            << fastest_p50 << " usec)\n";
+}
+
+//---------------------------------------------------------------------
+// Launches the persistent kernel with one work-group per mailbox and
+// times each round in which the host posts a request to every mailbox
+// and polls until all of them have answered. No kernel is launched
+// between rounds, so this is the host <-> device coherence latency alone.
+// On error, an exception will be thrown describing the failure.
+//---------------------------------------------------------------------
+MailboxResult ZePingPong::measure_mailboxes(L0Context &context,
+                                            ze_kernel_handle_t kernel,
+                                            volatile int *mailboxes,
+                                            const MailboxLayout &layout,
+                                            int rounds) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  const int warm_up_iterations = rounds / 10;
+  const int iterations = warm_up_iterations + rounds;
+  const auto timeout = std::chrono::seconds(10);
+  ze_group_count_t group_count = {layout.count, 1, 1};
+  std::vector<double> samples;
+  MailboxResult mailbox_result;
+
+  for (size_t i = 0; i < layout.size() / sizeof(int); i++)
+    mailboxes[i] = 0;
+
+  void *mailbox_buffer = const_cast<int *>(mailboxes);
+  const int kernel_args[] = {layout.stride, layout.response_offset,
+                             iterations};
+  result = zeKernelSetArgumentValue(kernel, 0, sizeof(mailbox_buffer),
+                                    &mailbox_buffer);
+  for (uint32_t i = 0; (i < 3) && !result; i++) {
+    result = zeKernelSetArgumentValue(kernel, i + 1, sizeof(int),
+                                      &kernel_args[i]);
+  }
+  if (result) {
+    throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                             std::to_string(result));
+  }
+
+  reset_commandlist(context);
+  result = zeCommandListAppendLaunchKernel(context.command_list, kernel,
+                                           &group_count, nullptr, 0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
+                             std::to_string(result));
+  }
+  result = zeCommandListClose(context.command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListClose failed: " +
+                             std::to_string(result));
+  }
+  result = zeCommandQueueExecuteCommandLists(
+      context.async_command_queue, 1, &context.command_list, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandQueueExecuteCommandLists failed: " +
+                             std::to_string(result));
+  }
+
+  samples.reserve(rounds);
+  auto measure_begin = std::chrono::high_resolution_clock::now();
+  for (int i = 1; i <= iterations; i++) {
+    if (i == warm_up_iterations + 1)
+      measure_begin = std::chrono::high_resolution_clock::now();
+
+    auto clk_begin = std::chrono::high_resolution_clock::now();
+    for (uint32_t m = 0; m < layout.count; m++)
+      mailboxes[m * layout.stride] = i;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    for (uint32_t m = 0; m < layout.count; m++) {
+      volatile int *response =
+          mailboxes + m * layout.stride + layout.response_offset;
+      for (uint32_t spin = 1; *response != i; spin++) {
+        /* A work-group that never got scheduled would spin us forever */
+        if ((spin % (1 << 20) == 0) &&
+            (std::chrono::high_resolution_clock::now() - clk_begin >
+             timeout)) {
+          for (uint32_t n = 0; n < layout.count; n++)
+            mailboxes[n * layout.stride] = -1;
+          zeCommandQueueSynchronize(context.async_command_queue, UINT32_MAX);
+          throw std::runtime_error(
+              "persistent kernel stopped answering mailbox " +
+              std::to_string(m) + " of " + std::to_string(layout.count));
+        }
+      }
+    }
+    auto clk_end = std::chrono::high_resolution_clock::now();
+
+    if (i > warm_up_iterations) {
+      samples.push_back(
+          static_cast<double>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(clk_end -
+                                                                   clk_begin)
+                  .count()) /
+          1000.0);
+    }
+  }
+  auto measure_end = std::chrono::high_resolution_clock::now();
+
+  result = zeCommandQueueSynchronize(context.async_command_queue, UINT32_MAX);
+  if (result) {
+    throw std::runtime_error("zeCommandQueueSynchronize failed: " +
+                             std::to_string(result));
+  }
+
+  auto elapsed_sec =
+      std::chrono::duration<double>(measure_end - measure_begin).count();
+  if (elapsed_sec > 0) {
+    mailbox_result.round_trips_per_sec =
+        static_cast<double>(layout.count) * rounds / elapsed_sec;
+  }
+  mailbox_result.latency = compute_distribution(samples);
+  return mailbox_result;
+}
+
+//---------------------------------------------------------------------
+// Runs the persistent kernel mailbox round trip with the request and
+// response flags in the same cache line, in neighbouring cache lines and
+// in different pages, and with several mailboxes packed into one cache
+// line against padded ones. Each layout is measured in host memory and in
+// shared memory allocated at several alignments, the latter also with
+// each memory advice hint applied to the whole allocation.
+//---------------------------------------------------------------------
+void ZePingPong::run_placement_test(L0Context &context,
+                                    ze_kernel_handle_t kernel) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  const int cache_line = 64 / sizeof(int);
+  const int page = 4096 / sizeof(int);
+  const MailboxLayout layouts[] = {
+      {"same_line", cache_line, 1, 1},
+      {"next_line", 2 * cache_line, cache_line, 1},
+      {"next_page", 2 * page, page, 1},
+      {"packed_x4", 2, 1, 4},
+      {"padded_x4", 2 * cache_line, cache_line, 4}};
+  const size_t alignments[] = {64, 4096, 2 * 1024 * 1024};
+
+  struct MemoryPlacement {
+    const char *name;
+    bool shared;
+    bool advise;
+    ze_memory_advice_t advice;
+  };
+  const MemoryPlacement placements[] = {
+      {"HOST_MEM", false, false, ZE_MEMORY_ADVICE_BIAS_CACHED},
+      {"SHARED_MEM", true, false, ZE_MEMORY_ADVICE_BIAS_CACHED},
+      {"SHARED_MEM_BIAS_CACHED", true, true, ZE_MEMORY_ADVICE_BIAS_CACHED},
+      {"SHARED_MEM_BIAS_UNCACHED", true, true,
+       ZE_MEMORY_ADVICE_BIAS_UNCACHED},
+      {"SHARED_MEM_PREFERRED_DEV", true, true,
+       ZE_MEMORY_ADVICE_SET_PREFERRED_LOCATION},
+      {"SHARED_MEM_ACCESSED_BY", true, true,
+       ZE_MEMORY_ADVICE_SET_ACCESSED_BY}};
+
+  size_t buffer_size = 0;
+  for (const auto &layout : layouts)
+    buffer_size = std::max(buffer_size, layout.size());
+
+  std::cout << "\n"
+            << "PLACEMENT EXPERIMENTS: MAILBOX ROUND TRIP P50 USEC BY FLAG "
+            << "PLACEMENT\n\n";
+  std::cout << std::left << std::setw(25) << "Memory" << std::right
+            << std::setw(8) << "Align";
+  for (const auto &layout : layouts)
+    std::cout << std::setw(11) << layout.name;
+  std::cout << std::setw(11) << "line_cost" << std::setw(11) << "mbox_cost"
+            << "\n";
+
+  for (const auto &placement : placements) {
+    for (auto alignment : alignments) {
+      void *buffer = nullptr;
+      ze_host_mem_alloc_desc_t host_desc;
+      host_desc.version = ZE_HOST_MEM_ALLOC_DESC_VERSION_CURRENT;
+      host_desc.flags = ZE_HOST_MEM_ALLOC_FLAG_DEFAULT;
+
+      if (placement.shared) {
+        ze_device_mem_alloc_desc_t device_desc;
+        device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+        device_desc.ordinal = 0;
+        device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+        result = zeDriverAllocSharedMem(context.driver, &device_desc,
+                                        &host_desc, buffer_size, alignment,
+                                        context.device, &buffer);
+      } else {
+        result = zeDriverAllocHostMem(context.driver, &host_desc, buffer_size,
+                                      alignment, &buffer);
+      }
+      if (result) {
+        std::cout << std::left << std::setw(25) << placement.name
+                  << std::right << std::setw(8) << alignment
+                  << "  allocation failed (" << result << ")\n";
+        continue;
+      }
+
+      if (placement.advise) {
+        reset_commandlist(context);
+        result = zeCommandListAppendMemAdvise(context.command_list,
+                                              context.device, buffer,
+                                              buffer_size, placement.advice);
+        if (result) {
+          throw std::runtime_error("zeCommandListAppendMemAdvise failed: " +
+                                   std::to_string(result));
+        }
+        result = zeCommandListClose(context.command_list);
+        if (result) {
+          throw std::runtime_error("zeCommandListClose failed: " +
+                                   std::to_string(result));
+        }
+        run_command_queue(context);
+      }
+
+      std::vector<double> p50;
+      for (const auto &layout : layouts) {
+        MailboxResult mailbox_result = measure_mailboxes(
+            context, kernel, static_cast<volatile int *>(buffer), layout,
+            num_execute / 10);
+        p50.push_back(mailbox_result.latency.p50);
+      }
+
+      /* Cost of sharing a line: same_line over next_line, packed over
+       * padded mailboxes */
+      std::cout << std::left << std::setw(25) << placement.name << std::right
+                << std::setw(8) << alignment << std::fixed
+                << std::setprecision(2);
+      for (auto value : p50)
+        std::cout << std::setw(11) << value;
+      std::cout << std::setw(10) << ((p50[1] > 0) ? p50[0] / p50[1] : 0)
+                << "x" << std::setw(10)
+                << ((p50[4] > 0) ? p50[3] / p50[4] : 0) << "x\n";
+
+      result = zeDriverFreeMem(context.driver, buffer);
+      if (result) {
+        throw std::runtime_error("zeDriverFreeMem failed: " +
+                                 std::to_string(result));
+      }
+    }
+  }
+}
+
+void ZePingPong::run_persistent_kernel_test(L0Context &context) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  ze_kernel_handle_t kernel = nullptr;
+  ze_kernel_desc_t function_description;
+  const size_t buffer_size = max_mailboxes * mailbox_stride * sizeof(int);
+  const size_t alignment = mailbox_stride * sizeof(int);
+  void *host_mailboxes = nullptr;
+  void *shared_mailboxes = nullptr;
+
+  function_description.version = ZE_KERNEL_DESC_VERSION_CURRENT;
+  function_description.flags = ZE_KERNEL_FLAG_NONE;
+  function_description.pKernelName = "kPersistentPingPong";
+  result = zeKernelCreate(context.module, &function_description, &kernel);
+  if (result) {
+    std::cout << "\n"
+              << "kPersistentPingPong not available (" << result
+              << "), skipping persistent kernel experiments\n";
+    return;
+  }
+
+  result = zeKernelSetGroupSize(kernel, 1, 1, 1);
+  if (result) {
+    throw std::runtime_error("zeKernelSetGroupSize failed: " +
+                             std::to_string(result));
+  }
+
+  ze_host_mem_alloc_desc_t host_desc;
+  host_desc.version = ZE_HOST_MEM_ALLOC_DESC_VERSION_CURRENT;
+  host_desc.flags = ZE_HOST_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocHostMem(context.driver, &host_desc, buffer_size,
+                                alignment, &host_mailboxes);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocHostMem failed: " +
+                             std::to_string(result));
+  }
+
+  ze_device_mem_alloc_desc_t shared_device_desc;
+  shared_device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  shared_device_desc.ordinal = 0;
+  shared_device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  result = zeDriverAllocSharedMem(context.driver, &shared_device_desc,
+                                  &host_desc, buffer_size, alignment,
+                                  context.device, &shared_mailboxes);
+  if (result) {
+    throw std::runtime_error("zeDriverAllocSharedMem failed: " +
+                             std::to_string(result));
+  }
+
+  /* Every mailbox needs its own resident hardware thread to make progress */
+  const ze_device_properties_t &props = context.device_property;
+  uint32_t mailbox_limit = max_mailboxes;
+  uint32_t hardware_threads = props.numThreadsPerEU * props.numEUsPerSubslice *
+                              props.numSubslicesPerSlice * props.numSlices;
+  if (hardware_threads)
+    mailbox_limit = std::min(mailbox_limit, hardware_threads);
+
+  std::cout << "\n"
+            << "PERSISTENT KERNEL EXPERIMENTS: MAILBOX ROUND TRIP WITHOUT "
+            << "KERNEL LAUNCH, USEC PER ROUND\n\n";
+  std::cout << std::left << std::setw(13) << "Memory" << std::right
+            << std::setw(10) << "Mailboxes" << std::setw(9) << "min"
+            << std::setw(9) << "p50" << std::setw(9) << "p99" << std::setw(9)
+            << "max" << std::setw(20) << "round trips/sec"
+            << "\n";
+
+  const std::pair<const char *, void *> memory_types[] = {
+      {"HOST_MEM", host_mailboxes}, {"SHARED_MEM", shared_mailboxes}};
+  for (const auto &memory_type : memory_types) {
+    for (uint32_t count = 1; count <= mailbox_limit; count *= 2) {
+      const MailboxLayout layout = {"", mailbox_stride,
+                                    mailbox_response_offset, count};
+      MailboxResult mailbox_result = measure_mailboxes(
+          context, kernel, static_cast<volatile int *>(memory_type.second),
+          layout, num_execute);
+      std::cout << std::left << std::setw(13) << memory_type.first
+                << std::right << std::setw(10) << count << std::fixed
+                << std::setprecision(2) << std::setw(9)
+                << mailbox_result.latency.min << std::setw(9)
+                << mailbox_result.latency.p50 << std::setw(9)
+                << mailbox_result.latency.p99 << std::setw(9)
+                << mailbox_result.latency.max << std::setprecision(0)
+                << std::setw(20) << mailbox_result.round_trips_per_sec
+                << "\n";
+    }
+  }
+  std::cout << std::setprecision(2);
+
+  result = zeDriverFreeMem(context.driver, host_mailboxes);
+  if (result) {
+    throw std::runtime_error("zeDriverFreeMem failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeDriverFreeMem(context.driver, shared_mailboxes);
+  if (result) {
+    throw std::runtime_error("zeDriverFreeMem failed: " +
+                             std::to_string(result));
+  }
+
+  run_placement_test(context, kernel);
+
+  result = zeKernelDestroy(kernel);
+  if (result) {
+    throw std::runtime_error("zeKernelDestroy failed: " +
+                             std::to_string(result));
+  }
+}
+
 void ZePingPong::run_test(L0Context &context) {
 
   ze_result_t result = ZE_RESULT_SUCCESS;
@@ -531,6 +1217,9 @@ void ZePingPong::run_test(L0Context &context) {
             << "%"
             << "\n";
 
+  run_submit_mode_test(context);
+  run_persistent_kernel_test(context);
+
   result = zeKernelDestroy(context.function);
   if (result) {
     throw std::runtime_error("zeKernelDestroy failed: " +
@@ -0,0 +1,66 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_RESIDENCY_HPP_
+#define _ZE_RESIDENCY_HPP_
+
+#include <level_zero/ze_api.h>
+#include "common.hpp"
+#include "ze_app.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ResidencyCallResult {
+  long double resident_usec_per_call = 0;
+  long double resident_gbps = 0;
+  long double evict_usec_per_call = 0;
+  long double evict_gbps = 0;
+};
+
+struct WorkingSetResult {
+  long double gbps = 0;
+  /* Share of the time spent in make resident and evict calls */
+  long double residency_fraction = 0;
+};
+
+class ZeResidency {
+public:
+  ZeResidency();
+  ~ZeResidency();
+  int parse_command_line(int argc, char **argv);
+  uint64_t device_memory_size();
+  bool allocate(size_t size, void **ptr);
+  void release(void *ptr) { benchmark->memoryFree(ptr); }
+  ResidencyCallResult measure_calls(const std::vector<void *> &buffers,
+                                    size_t size);
+  WorkingSetResult measure_working_set(const std::vector<void *> &chunks,
+                                       size_t window_chunks,
+                                       bool explicit_calls);
+
+  size_t min_size = 4096;
+  size_t max_size = (1u << 28);
+  uint32_t max_count = 256;
+  uint32_t num_iterations = 10;
+  bool run_calls = true;
+  bool run_working_set = true;
+  double working_set_factor = 1.5;
+  size_t chunk_size = (1u << 26);
+  uint32_t window_chunks = 0;
+  uint32_t cycles = 3;
+  std::string json_file_name;
+
+private:
+  ZeApp *benchmark;
+  ze_command_queue_handle_t command_queue;
+  ze_command_list_handle_t command_list;
+  void *staging_buffer = nullptr;
+};
+
+#endif /* _ZE_RESIDENCY_HPP_ */
@@ -0,0 +1,67 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_residency.hpp"
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+int ZeResidency::parse_command_line(int argc, char **argv) {
+  std::string scenario = "all";
+
+  po::options_description desc("Allowed options");
+  desc.add_options()("help", "produce help message")(
+      "scenario", po::value<std::string>(&scenario),
+      "measurements to run, calls/working-set/all")(
+      "min-size", po::value<size_t>(&min_size)->default_value(4096),
+      "smallest allocation size in bytes, multiplied by 4 up to max-size")(
+      "max-size", po::value<size_t>(&max_size)->default_value(1u << 28),
+      "largest allocation size in bytes")(
+      "max-count", po::value<uint32_t>(&max_count)->default_value(256),
+      "largest number of allocations, counts go up by 4 from 1")(
+      "num-iter", po::value<uint32_t>(&num_iterations)->default_value(10),
+      "set number of iterations of the calls sweep")(
+      "working-set-factor",
+      po::value<double>(&working_set_factor)->default_value(1.5),
+      "working set size as a multiple of device memory")(
+      "chunk-size", po::value<size_t>(&chunk_size)->default_value(1u << 26),
+      "size in bytes of each allocation of the working set")(
+      "window-chunks", po::value<uint32_t>(&window_chunks)->default_value(0),
+      "chunks resident at a time, 0 for half of device memory")(
+      "cycles", po::value<uint32_t>(&cycles)->default_value(3),
+      "timed passes over the working set")(
+      "json-output-file", po::value<std::string>(&json_file_name),
+      "test output format file name to be specified");
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  run_calls = (scenario == "all") || (scenario == "calls");
+  run_working_set = (scenario == "all") || (scenario == "working-set");
+
+  if (vm.count("help")) {
+    std::cout << desc << std::endl;
+    return 1;
+  } else if (!run_calls && !run_working_set) {
+    std::cout << "unknown scenario" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if (!min_size || !max_count || !chunk_size) {
+    std::cout << "sizes and counts must be at least 1" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if (!num_iterations || !cycles) {
+    std::cout << "number of iterations and cycles must be at least 1"
+              << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  }
+  return 0;
+}
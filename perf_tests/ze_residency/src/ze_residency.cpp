@@ -0,0 +1,320 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_residency.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+namespace pt = boost::property_tree;
+
+ZeResidency::ZeResidency() {
+  benchmark = new ZeApp();
+  benchmark->singleDeviceInit();
+
+  benchmark->commandQueueCreate(0, &command_queue);
+  benchmark->commandListCreate(&command_list);
+}
+
+ZeResidency::~ZeResidency() {
+  if (staging_buffer) {
+    benchmark->memoryFree(staging_buffer);
+  }
+  benchmark->commandListDestroy(command_list);
+  benchmark->commandQueueDestroy(command_queue);
+  benchmark->singleDeviceCleanup();
+
+  delete benchmark;
+}
+
+uint64_t ZeResidency::device_memory_size() {
+  uint32_t count = 0;
+  SUCCESS_OR_TERMINATE(
+      zeDeviceGetMemoryProperties(benchmark->device, &count, nullptr));
+
+  std::vector<ze_device_memory_properties_t> properties(count);
+  for (auto &property : properties) {
+    property.version = ZE_DEVICE_MEMORY_PROPERTIES_VERSION_CURRENT;
+  }
+  SUCCESS_OR_TERMINATE(zeDeviceGetMemoryProperties(benchmark->device, &count,
+                                                   properties.data()));
+
+  uint64_t total_size = 0;
+  for (const auto &property : properties) {
+    total_size = std::max(total_size, property.totalSize);
+  }
+  return total_size;
+}
+
+/* Unlike ZeApp, a failed allocation is reported so the sweeps can stop at
+ * the most memory the driver accepts */
+bool ZeResidency::allocate(size_t size, void **ptr) {
+  ze_device_mem_alloc_desc_t device_desc;
+  device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  device_desc.ordinal = 0;
+  device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+
+  return (zeDriverAllocDeviceMem(benchmark->driver, &device_desc, size, 1,
+                                 benchmark->device,
+                                 ptr) == ZE_RESULT_SUCCESS);
+}
+
+/* Times making every buffer resident and evicting it again, one call per
+ * buffer */
+ResidencyCallResult
+ZeResidency::measure_calls(const std::vector<void *> &buffers, size_t size) {
+  Timer<std::chrono::microseconds::period> timer;
+  long double resident_usec = 0;
+  long double evict_usec = 0;
+
+  for (uint32_t i = 0; i < num_iterations; i++) {
+    timer.start();
+    for (auto buffer : buffers) {
+      SUCCESS_OR_TERMINATE(
+          zeDeviceMakeMemoryResident(benchmark->device, buffer, size));
+    }
+    timer.end();
+    resident_usec += timer.period_minus_overhead();
+
+    timer.start();
+    for (auto buffer : buffers) {
+      SUCCESS_OR_TERMINATE(
+          zeDeviceEvictMemory(benchmark->device, buffer, size));
+    }
+    timer.end();
+    evict_usec += timer.period_minus_overhead();
+  }
+
+  const long double calls =
+      static_cast<long double>(buffers.size()) * num_iterations;
+  const long double gigabytes = calls * size / 1e9L;
+  ResidencyCallResult result;
+  result.resident_usec_per_call = resident_usec / calls;
+  result.resident_gbps = gigabytes / (resident_usec / 1e6L);
+  result.evict_usec_per_call = evict_usec / calls;
+  result.evict_gbps = gigabytes / (evict_usec / 1e6L);
+  return result;
+}
+
+/*
+ * Streams the working set through the device one window of chunks at a
+ * time, uploading every chunk of the window from a host staging buffer as
+ * an out-of-core application would. With explicit calls the previous
+ * window is evicted and the next one made resident first; without them
+ * paging is left to the driver. The first pass over the working set is a
+ * warm up.
+ */
+WorkingSetResult
+ZeResidency::measure_working_set(const std::vector<void *> &chunks,
+                                 size_t window_chunks, bool explicit_calls) {
+  if (!staging_buffer) {
+    benchmark->memoryAllocHost(chunk_size, &staging_buffer);
+  }
+
+  Timer<std::chrono::microseconds::period> timer;
+  long double residency_usec = 0;
+  long double upload_usec = 0;
+  size_t previous_begin = 0;
+  size_t previous_end = 0;
+
+  for (uint32_t cycle = 0; cycle <= cycles; cycle++) {
+    long double cycle_residency_usec = 0;
+    long double cycle_upload_usec = 0;
+
+    for (size_t begin = 0; begin < chunks.size(); begin += window_chunks) {
+      const size_t end = std::min(chunks.size(), begin + window_chunks);
+
+      if (explicit_calls) {
+        timer.start();
+        for (size_t i = previous_begin; i < previous_end; i++) {
+          SUCCESS_OR_TERMINATE(
+              zeDeviceEvictMemory(benchmark->device, chunks[i], chunk_size));
+        }
+        for (size_t i = begin; i < end; i++) {
+          SUCCESS_OR_TERMINATE(zeDeviceMakeMemoryResident(
+              benchmark->device, chunks[i], chunk_size));
+        }
+        timer.end();
+        cycle_residency_usec += timer.period_minus_overhead();
+        previous_begin = begin;
+        previous_end = end;
+      }
+
+      for (size_t i = begin; i < end; i++) {
+        benchmark->commandListAppendMemoryCopy(command_list, chunks[i],
+                                               staging_buffer, chunk_size);
+      }
+      benchmark->commandListClose(command_list);
+      timer.start();
+      benchmark->commandQueueExecuteCommandList(command_queue, 1,
+                                                &command_list);
+      benchmark->commandQueueSynchronize(command_queue);
+      timer.end();
+      benchmark->commandListReset(command_list);
+      cycle_upload_usec += timer.period_minus_overhead();
+    }
+
+    if (cycle > 0) {
+      residency_usec += cycle_residency_usec;
+      upload_usec += cycle_upload_usec;
+    }
+  }
+
+  if (explicit_calls) {
+    for (size_t i = previous_begin; i < previous_end; i++) {
+      SUCCESS_OR_TERMINATE(
+          zeDeviceEvictMemory(benchmark->device, chunks[i], chunk_size));
+    }
+  }
+
+  const long double total_usec = residency_usec + upload_usec;
+  const long double gigabytes =
+      static_cast<long double>(chunks.size()) * chunk_size * cycles / 1e9L;
+  WorkingSetResult result;
+  result.gbps = gigabytes / (total_usec / 1e6L);
+  result.residency_fraction = residency_usec / total_usec;
+  return result;
+}
+
+static pt::ptree run_calls_sweep(ZeResidency &residency) {
+  pt::ptree row_array;
+
+  std::cout << "zeDeviceMakeMemoryResident and zeDeviceEvictMemory cost, one "
+               "call per device allocation"
+            << std::endl
+            << std::right << std::setw(12) << "Size" << std::setw(8)
+            << "Count" << std::setw(14) << "Resident us" << std::setw(14)
+            << "Resident GBPS" << std::setw(12) << "Evict us"
+            << std::setw(12) << "Evict GBPS" << std::endl;
+
+  for (size_t size = residency.min_size; size <= residency.max_size;
+       size *= 4) {
+    for (uint32_t count = 1; count <= residency.max_count; count *= 4) {
+      std::vector<void *> buffers;
+      for (uint32_t i = 0; i < count; i++) {
+        void *buffer = nullptr;
+        if (!residency.allocate(size, &buffer))
+          break;
+        buffers.push_back(buffer);
+      }
+
+      if (buffers.size() == count) {
+        const ResidencyCallResult result =
+            residency.measure_calls(buffers, size);
+        std::cout << std::setw(12) << size << std::setw(8) << count
+                  << std::fixed << std::setprecision(2) << std::setw(14)
+                  << result.resident_usec_per_call << std::setw(14)
+                  << result.resident_gbps << std::setw(12)
+                  << result.evict_usec_per_call << std::setw(12)
+                  << result.evict_gbps << std::endl;
+
+        pt::ptree row;
+        row.put("Size", size);
+        row.put("Count", count);
+        row.put("Resident usec per call", result.resident_usec_per_call);
+        row.put("Resident GBPS", result.resident_gbps);
+        row.put("Evict usec per call", result.evict_usec_per_call);
+        row.put("Evict GBPS", result.evict_gbps);
+        row_array.push_back(std::make_pair("", row));
+      } else {
+        std::cout << std::setw(12) << size << std::setw(8) << count
+                  << "  allocation failed" << std::endl;
+      }
+
+      for (auto buffer : buffers) {
+        residency.release(buffer);
+      }
+      if (buffers.size() != count)
+        break;
+    }
+  }
+  return row_array;
+}
+
+static pt::ptree run_working_set(ZeResidency &residency) {
+  pt::ptree working_set_ptree;
+  const uint64_t device_size = residency.device_memory_size();
+  const size_t wanted_chunks = static_cast<size_t>(
+      device_size * residency.working_set_factor / residency.chunk_size);
+
+  /* By default a window is half of device memory */
+  size_t window_chunks = residency.window_chunks;
+  if (!window_chunks) {
+    window_chunks = std::max<size_t>(
+        1, static_cast<size_t>(device_size / 2 / residency.chunk_size));
+  }
+
+  std::vector<void *> chunks;
+  for (size_t i = 0; i < wanted_chunks; i++) {
+    void *chunk = nullptr;
+    if (!residency.allocate(residency.chunk_size, &chunk))
+      break;
+    chunks.push_back(chunk);
+  }
+
+  const uint64_t working_set_size =
+      static_cast<uint64_t>(chunks.size()) * residency.chunk_size;
+  std::cout << std::endl
+            << "Working set of " << working_set_size << " bytes on a "
+            << device_size << " byte device, " << chunks.size()
+            << " chunks of " << residency.chunk_size << " bytes, windows of "
+            << window_chunks << " chunks" << std::endl;
+  if (chunks.size() < wanted_chunks) {
+    std::cout << "  only " << chunks.size() << " of " << wanted_chunks
+              << " chunks could be allocated" << std::endl;
+  }
+
+  if (chunks.size() > window_chunks) {
+    std::cout << std::right << std::setw(12) << "Residency" << std::setw(10)
+              << "GBPS" << std::setw(14) << "In calls %" << std::endl;
+    for (auto explicit_calls : {false, true}) {
+      const WorkingSetResult result =
+          residency.measure_working_set(chunks, window_chunks, explicit_calls);
+      const std::string name = explicit_calls ? "explicit" : "driver";
+      std::cout << std::setw(12) << name << std::fixed
+                << std::setprecision(2) << std::setw(10) << result.gbps
+                << std::setw(14) << (result.residency_fraction * 100)
+                << std::endl;
+      working_set_ptree.put(name + ".GBPS", result.gbps);
+      working_set_ptree.put(name + ".Residency fraction",
+                            result.residency_fraction);
+    }
+    working_set_ptree.put("Working set size", working_set_size);
+    working_set_ptree.put("Device memory size", device_size);
+    working_set_ptree.put("Chunk size", residency.chunk_size);
+    working_set_ptree.put("Window chunks", window_chunks);
+  } else {
+    std::cout << "  the working set fits in one window, skipped" << std::endl;
+  }
+
+  for (auto chunk : chunks) {
+    residency.release(chunk);
+  }
+  return working_set_ptree;
+}
+
+int main(int argc, char **argv) {
+  ZeResidency residency;
+  SUCCESS_OR_TERMINATE(residency.parse_command_line(argc, argv));
+
+  pt::ptree main_tree;
+  if (residency.run_calls) {
+    main_tree.put_child("Calls", run_calls_sweep(residency));
+  }
+  if (residency.run_working_set) {
+    main_tree.put_child("Working set", run_working_set(residency));
+  }
+
+  if (!residency.json_file_name.empty()) {
+    pt::write_json(residency.json_file_name, main_tree);
+  }
+  return 0;
+}
@@ -0,0 +1,78 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_USM_MIGRATION_HPP_
+#define _ZE_USM_MIGRATION_HPP_
+
+#include <level_zero/ze_api.h>
+#include "common.hpp"
+#include "ze_app.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Order the measured side touches the buffer in, values match the kernel */
+enum class MigrationAccess { sequential = 0, random = 1, page = 2 };
+
+/* Side that populates the buffer before the other side's timed access */
+enum class FirstTouch { host, device };
+
+enum class MigrationHint { none, prefetch, advise };
+
+std::string to_string(const MigrationAccess access);
+std::string to_string(const FirstTouch first_touch);
+std::string to_string(const MigrationHint hint);
+
+struct MigrationResult {
+  bool measured = false;
+  long double gbps = 0;
+  long double usec_per_page = 0;
+};
+
+class ZeUsmMigration {
+public:
+  ZeUsmMigration();
+  ~ZeUsmMigration();
+  int parse_command_line(int argc, char **argv);
+  bool allocate_shared(size_t size, void **ptr);
+  void release(void *ptr);
+  MigrationResult measure_shared(void *buffer, size_t size,
+                                 MigrationAccess access,
+                                 FirstTouch first_touch, MigrationHint hint);
+  MigrationResult measure_explicit(size_t size, FirstTouch first_touch);
+
+  std::vector<MigrationAccess> accesses = {MigrationAccess::sequential,
+                                           MigrationAccess::random,
+                                           MigrationAccess::page};
+  std::vector<FirstTouch> first_touches = {FirstTouch::host,
+                                           FirstTouch::device};
+  std::vector<MigrationHint> hints = {
+      MigrationHint::none, MigrationHint::prefetch, MigrationHint::advise};
+  size_t min_size = (1u << 16);
+  size_t max_size = (1u << 28);
+  size_t page_size = 4096;
+  uint32_t num_iterations = 10;
+  std::string json_file_name;
+
+private:
+  void append_touch(void *buffer, size_t size, MigrationAccess access,
+                    uint64_t value);
+  void host_touch(void *buffer, size_t size, MigrationAccess access,
+                  uint64_t value);
+  void advise(void *buffer, size_t size, ze_memory_advice_t advice);
+  long double run_command_list();
+
+  ZeApp *benchmark;
+  ze_command_queue_handle_t command_queue;
+  ze_command_list_handle_t command_list;
+  ze_kernel_handle_t touch_kernel = nullptr;
+  uint32_t max_group_count = 1;
+};
+
+#endif /* _ZE_USM_MIGRATION_HPP_ */
@@ -0,0 +1,34 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+/* Access orders, matching MigrationAccess on the host */
+#define ACCESS_SEQUENTIAL 0
+#define ACCESS_RANDOM 1
+#define ACCESS_PAGE 2
+
+/*
+ * Read-modify-write elements of a shared buffer of count elements so every
+ * page touched faults in on the device. Sequential and random touch every
+ * element, random by an odd multiplicative hash which is a permutation for
+ * the power of two counts the host uses. Page touches the first element of
+ * every page only.
+ */
+__kernel void touch_memory(__global ulong *buffer, ulong count, uint access,
+                           ulong page_elements, ulong value) {
+  const size_t stride = get_global_size(0);
+  const ulong touches = (access == ACCESS_PAGE) ? count / page_elements : count;
+
+  for (size_t i = get_global_id(0); i < touches; i += stride) {
+    ulong index = i;
+    if (access == ACCESS_RANDOM)
+      index = (i * 0x9e3779b97f4a7c15UL) & (count - 1);
+    else if (access == ACCESS_PAGE)
+      index = i * page_elements;
+    buffer[index] += value;
+  }
+}
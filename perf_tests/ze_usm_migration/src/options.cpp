@@ -0,0 +1,107 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_usm_migration.hpp"
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+static bool is_power_of_two(size_t value) {
+  return value && !(value & (value - 1));
+}
+
+int ZeUsmMigration::parse_command_line(int argc, char **argv) {
+  std::string access = "all";
+  std::string first_touch = "all";
+  std::string hint = "all";
+
+  po::options_description desc("Allowed options");
+  desc.add_options()("help", "produce help message")(
+      "access", po::value<std::string>(&access),
+      "order the timed side touches the buffer in, "
+      "sequential/random/page/all")(
+      "first-touch", po::value<std::string>(&first_touch),
+      "side that populates the buffer before the other side's timed "
+      "access, host/device/all")(
+      "hint", po::value<std::string>(&hint),
+      "migration hint given before the timed access, "
+      "none/prefetch/advise/all")(
+      "min-size", po::value<size_t>(&min_size)->default_value(1u << 16),
+      "smallest buffer size in bytes, multiplied by 4 up to max-size")(
+      "max-size", po::value<size_t>(&max_size)->default_value(1u << 28),
+      "largest buffer size in bytes")(
+      "page-size", po::value<size_t>(&page_size)->default_value(4096),
+      "page size in bytes, the stride of the page access order")(
+      "num-iter", po::value<uint32_t>(&num_iterations)->default_value(10),
+      "set number of iterations")(
+      "json-output-file", po::value<std::string>(&json_file_name),
+      "test output format file name to be specified");
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  if (access == "sequential") {
+    accesses = {MigrationAccess::sequential};
+  } else if (access == "random") {
+    accesses = {MigrationAccess::random};
+  } else if (access == "page") {
+    accesses = {MigrationAccess::page};
+  }
+
+  if (first_touch == "host") {
+    first_touches = {FirstTouch::host};
+  } else if (first_touch == "device") {
+    first_touches = {FirstTouch::device};
+  }
+
+  if (hint == "none") {
+    hints = {MigrationHint::none};
+  } else if (hint == "prefetch") {
+    hints = {MigrationHint::prefetch};
+  } else if (hint == "advise") {
+    hints = {MigrationHint::advise};
+  }
+
+  if (vm.count("help")) {
+    std::cout << desc << std::endl;
+    return 1;
+  } else if ((access != "all") && (access != "sequential") &&
+             (access != "random") && (access != "page")) {
+    std::cout << "unknown access" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if ((first_touch != "all") && (first_touch != "host") &&
+             (first_touch != "device")) {
+    std::cout << "unknown first touch" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if ((hint != "all") && (hint != "none") && (hint != "prefetch") &&
+             (hint != "advise")) {
+    std::cout << "unknown hint" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if (!is_power_of_two(page_size) || (page_size < sizeof(uint64_t))) {
+    std::cout << "page-size must be a power of two" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if (!is_power_of_two(min_size) || (min_size < page_size)) {
+    /* The random access order is only a permutation for power of two
+     * element counts */
+    std::cout << "min-size must be a power of two of at least page-size"
+              << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  } else if (!num_iterations) {
+    std::cout << "number of iterations must be at least 1" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  }
+  return 0;
+}
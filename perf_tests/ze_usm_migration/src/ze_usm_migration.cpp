@@ -0,0 +1,364 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_usm_migration.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+namespace pt = boost::property_tree;
+
+/* Odd multiplier of the random access order, the same as in the kernel */
+static const uint64_t random_multiplier = 0x9e3779b97f4a7c15ull;
+
+std::string to_string(const MigrationAccess access) {
+  switch (access) {
+  case MigrationAccess::sequential:
+    return "sequential";
+  case MigrationAccess::random:
+    return "random";
+  case MigrationAccess::page:
+    return "page";
+  }
+  return "unknown";
+}
+
+std::string to_string(const FirstTouch first_touch) {
+  switch (first_touch) {
+  case FirstTouch::host:
+    return "host";
+  case FirstTouch::device:
+    return "device";
+  }
+  return "unknown";
+}
+
+std::string to_string(const MigrationHint hint) {
+  switch (hint) {
+  case MigrationHint::none:
+    return "none";
+  case MigrationHint::prefetch:
+    return "prefetch";
+  case MigrationHint::advise:
+    return "advise";
+  }
+  return "unknown";
+}
+
+ZeUsmMigration::ZeUsmMigration() {
+  benchmark = new ZeApp("ze_usm_migration.spv");
+  benchmark->singleDeviceInit();
+
+  benchmark->commandQueueCreate(0, &command_queue);
+  benchmark->commandListCreate(&command_list);
+
+  ze_device_properties_t device_properties;
+  device_properties.version = ZE_DEVICE_PROPERTIES_VERSION_CURRENT;
+  SUCCESS_OR_TERMINATE(
+      zeDeviceGetProperties(benchmark->device, &device_properties));
+  max_group_count = std::max(
+      1u, device_properties.numSlices * device_properties.numSubslicesPerSlice *
+              device_properties.numEUsPerSubslice *
+              device_properties.numThreadsPerEU);
+
+  benchmark->functionCreate(&touch_kernel, "touch_memory");
+}
+
+ZeUsmMigration::~ZeUsmMigration() {
+  benchmark->functionDestroy(touch_kernel);
+  benchmark->commandListDestroy(command_list);
+  benchmark->commandQueueDestroy(command_queue);
+  benchmark->singleDeviceCleanup();
+
+  delete benchmark;
+}
+
+/* Unlike ZeApp, a failed allocation is reported so the sweep can stop at
+ * the largest buffer the driver accepts */
+bool ZeUsmMigration::allocate_shared(size_t size, void **ptr) {
+  ze_device_mem_alloc_desc_t device_desc;
+  device_desc.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  device_desc.ordinal = 0;
+  device_desc.flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  ze_host_mem_alloc_desc_t host_desc;
+  host_desc.version = ZE_HOST_MEM_ALLOC_DESC_VERSION_CURRENT;
+  host_desc.flags = ZE_HOST_MEM_ALLOC_FLAG_DEFAULT;
+
+  return (zeDriverAllocSharedMem(benchmark->driver, &device_desc, &host_desc,
+                                 size, page_size, benchmark->device,
+                                 ptr) == ZE_RESULT_SUCCESS);
+}
+
+void ZeUsmMigration::release(void *ptr) { benchmark->memoryFree(ptr); }
+
+void ZeUsmMigration::append_touch(void *buffer, size_t size,
+                                  MigrationAccess access, uint64_t value) {
+  const uint64_t count = size / sizeof(uint64_t);
+  const uint32_t access_value = static_cast<uint32_t>(access);
+  const uint64_t page_elements = page_size / sizeof(uint64_t);
+  const uint64_t touches =
+      (access == MigrationAccess::page) ? count / page_elements : count;
+
+  uint32_t group_size_x = 1;
+  uint32_t group_size_y = 1;
+  uint32_t group_size_z = 1;
+  SUCCESS_OR_TERMINATE(zeKernelSuggestGroupSize(
+      touch_kernel, static_cast<uint32_t>(std::min<uint64_t>(touches, 256)),
+      1, 1, &group_size_x, &group_size_y, &group_size_z));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetGroupSize(touch_kernel, group_size_x, 1, 1));
+
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(touch_kernel, 0, sizeof(buffer), &buffer));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(touch_kernel, 1, sizeof(count), &count));
+  SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(
+      touch_kernel, 2, sizeof(access_value), &access_value));
+  SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(
+      touch_kernel, 3, sizeof(page_elements), &page_elements));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(touch_kernel, 4, sizeof(value), &value));
+
+  /* Enough groups to occupy the device, the kernel strides over the rest */
+  const uint64_t groups_needed = (touches + group_size_x - 1) / group_size_x;
+  ze_group_count_t group_count = {
+      static_cast<uint32_t>(std::max<uint64_t>(
+          1, std::min<uint64_t>(groups_needed, max_group_count))),
+      1, 1};
+  SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+      command_list, touch_kernel, &group_count, nullptr, 0, nullptr));
+}
+
+/* Host side of the kernel's access orders */
+void ZeUsmMigration::host_touch(void *buffer, size_t size,
+                                MigrationAccess access, uint64_t value) {
+  uint64_t *data = static_cast<uint64_t *>(buffer);
+  const uint64_t count = size / sizeof(uint64_t);
+  const uint64_t page_elements = page_size / sizeof(uint64_t);
+
+  switch (access) {
+  case MigrationAccess::sequential:
+    for (uint64_t i = 0; i < count; i++)
+      data[i] += value;
+    break;
+  case MigrationAccess::random:
+    for (uint64_t i = 0; i < count; i++)
+      data[(i * random_multiplier) & (count - 1)] += value;
+    break;
+  case MigrationAccess::page:
+    for (uint64_t i = 0; i < count; i += page_elements)
+      data[i] += value;
+    break;
+  }
+}
+
+void ZeUsmMigration::advise(void *buffer, size_t size,
+                            ze_memory_advice_t advice) {
+  SUCCESS_OR_TERMINATE(zeCommandListAppendMemAdvise(
+      command_list, benchmark->device, buffer, size, advice));
+  run_command_list();
+}
+
+/* Runs and resets the command list, returning its time in usec */
+long double ZeUsmMigration::run_command_list() {
+  Timer<std::chrono::microseconds::period> timer;
+
+  benchmark->commandListClose(command_list);
+  timer.start();
+  benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list);
+  benchmark->commandQueueSynchronize(command_queue);
+  timer.end();
+  benchmark->commandListReset(command_list);
+
+  return timer.period_minus_overhead();
+}
+
+/*
+ * Every iteration first populates the whole buffer on the first touch
+ * side, untimed, then times the other side's access to it. Every page is
+ * migrated whichever order it is touched in, so the bandwidth is always
+ * over the whole buffer.
+ */
+MigrationResult ZeUsmMigration::measure_shared(void *buffer, size_t size,
+                                               MigrationAccess access,
+                                               FirstTouch first_touch,
+                                               MigrationHint hint) {
+  MigrationResult result;
+
+  /* There is no prefetch to the host */
+  if ((first_touch == FirstTouch::device) &&
+      (hint == MigrationHint::prefetch)) {
+    return result;
+  }
+
+  if (hint == MigrationHint::advise) {
+    advise(buffer, size, ZE_MEMORY_ADVICE_SET_PREFERRED_LOCATION);
+  }
+
+  long double total_time_usec = 0;
+  for (uint32_t i = 0; i < num_iterations; i++) {
+    if (first_touch == FirstTouch::host) {
+      host_touch(buffer, size, MigrationAccess::sequential, 1);
+
+      if (hint == MigrationHint::prefetch) {
+        SUCCESS_OR_TERMINATE(
+            zeCommandListAppendMemoryPrefetch(command_list, buffer, size));
+      }
+      append_touch(buffer, size, access, 1);
+      total_time_usec += run_command_list();
+    } else {
+      append_touch(buffer, size, MigrationAccess::sequential, 1);
+      run_command_list();
+
+      Timer<std::chrono::microseconds::period> timer;
+      timer.start();
+      host_touch(buffer, size, access, 1);
+      timer.end();
+      total_time_usec += timer.period_minus_overhead();
+    }
+  }
+
+  if (hint == MigrationHint::advise) {
+    advise(buffer, size, ZE_MEMORY_ADVICE_CLEAR_PREFERRED_LOCATION);
+  }
+
+  const long double pages =
+      static_cast<long double>(size / page_size) * num_iterations;
+  result.measured = true;
+  result.gbps =
+      (static_cast<long double>(size) * num_iterations / 1e9L) /
+      (total_time_usec / 1e6L);
+  result.usec_per_page = total_time_usec / pages;
+  return result;
+}
+
+/* The same transfer through an explicit device allocation and a copy */
+MigrationResult ZeUsmMigration::measure_explicit(size_t size,
+                                                 FirstTouch first_touch) {
+  MigrationResult result;
+  void *device_buffer = nullptr;
+  void *host_buffer = nullptr;
+  benchmark->memoryAlloc(size, &device_buffer);
+  benchmark->memoryAllocHost(size, &host_buffer);
+
+  long double total_time_usec = 0;
+  for (uint32_t i = 0; i < num_iterations; i++) {
+    if (first_touch == FirstTouch::host) {
+      host_touch(host_buffer, size, MigrationAccess::sequential, 1);
+      benchmark->commandListAppendMemoryCopy(command_list, device_buffer,
+                                             host_buffer, size);
+    } else {
+      benchmark->commandListAppendMemoryCopy(command_list, host_buffer,
+                                             device_buffer, size);
+    }
+    total_time_usec += run_command_list();
+  }
+
+  benchmark->memoryFree(host_buffer);
+  benchmark->memoryFree(device_buffer);
+
+  const long double pages =
+      static_cast<long double>(size / page_size) * num_iterations;
+  result.measured = true;
+  result.gbps =
+      (static_cast<long double>(size) * num_iterations / 1e9L) /
+      (total_time_usec / 1e6L);
+  result.usec_per_page = total_time_usec / pages;
+  return result;
+}
+
+static void print_row(size_t size, FirstTouch first_touch,
+                      const std::string &access, const std::string &hint,
+                      const MigrationResult &result) {
+  std::cout << std::right << std::setw(12) << size << std::setw(8)
+            << to_string(first_touch) << std::setw(12) << access
+            << std::setw(10) << hint;
+  if (result.measured) {
+    std::cout << std::setw(10) << std::fixed << std::setprecision(2)
+              << result.gbps << std::setw(12) << std::setprecision(3)
+              << result.usec_per_page;
+  } else {
+    std::cout << std::setw(10) << "-" << std::setw(12) << "-";
+  }
+  std::cout << std::endl;
+}
+
+static pt::ptree to_ptree(size_t size, FirstTouch first_touch,
+                          const std::string &access, const std::string &hint,
+                          const MigrationResult &result) {
+  pt::ptree row;
+  row.put("Size", size);
+  row.put("First touch", to_string(first_touch));
+  row.put("Access", access);
+  row.put("Hint", hint);
+  row.put("GBPS", result.gbps);
+  row.put("Usec per page", result.usec_per_page);
+  return row;
+}
+
+int main(int argc, char **argv) {
+  ZeUsmMigration migration;
+  SUCCESS_OR_TERMINATE(migration.parse_command_line(argc, argv));
+
+  std::cout << "Shared memory migration, timed on the side that did not "
+               "first touch the buffer"
+            << std::endl
+            << "  copy rows move the same data through an explicit device "
+               "allocation"
+            << std::endl
+            << std::endl
+            << std::right << std::setw(12) << "Size" << std::setw(8)
+            << "First" << std::setw(12) << "Access" << std::setw(10)
+            << "Hint" << std::setw(10) << "GBPS" << std::setw(12)
+            << "usec/page" << std::endl;
+
+  pt::ptree row_array;
+  for (size_t size = migration.min_size; size <= migration.max_size;
+       size *= 4) {
+    void *buffer = nullptr;
+    if (!migration.allocate_shared(size, &buffer)) {
+      std::cout << std::setw(12) << size
+                << "  allocation failed, largest buffer reached"
+                << std::endl;
+      break;
+    }
+
+    for (auto first_touch : migration.first_touches) {
+      const MigrationResult copy =
+          migration.measure_explicit(size, first_touch);
+      print_row(size, first_touch, "copy", "explicit", copy);
+      row_array.push_back(std::make_pair(
+          "", to_ptree(size, first_touch, "copy", "explicit", copy)));
+
+      for (auto access : migration.accesses) {
+        for (auto hint : migration.hints) {
+          const MigrationResult result =
+              migration.measure_shared(buffer, size, access, first_touch, hint);
+          print_row(size, first_touch, to_string(access), to_string(hint),
+                    result);
+          if (result.measured) {
+            row_array.push_back(std::make_pair(
+                "", to_ptree(size, first_touch, to_string(access),
+                             to_string(hint), result)));
+          }
+        }
+      }
+    }
+    migration.release(buffer);
+  }
+
+  if (!migration.json_file_name.empty()) {
+    pt::ptree main_tree;
+    main_tree.put_child("Results", row_array);
+    pt::write_json(migration.json_file_name, main_tree);
+  }
+  return 0;
+}
@@ -9,11 +9,87 @@
 #ifndef level_zero_tests_IMAGE_HPP
 #define level_zero_tests_IMAGE_HPP
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace level_zero_tests {
+// Pixel memory of an image. Pixels are either owned in a vector or adopted
+// from the caller, e.g. USM host memory that device image copies can read
+// and write directly. Copies always deep copy into owned storage.
+template <typename T> class PixelStorage {
+public:
+  typedef std::function<void(T *)> release_function;
+
+  PixelStorage() = default;
+  explicit PixelStorage(const size_t count) : owned_(count) {}
+  explicit PixelStorage(const std::vector<T> &data) : owned_(data) {}
+  // Adopts count pixels at memory; release is called with memory once the
+  // storage no longer uses it, or never if release is empty
+  PixelStorage(T *memory, const size_t count, release_function release)
+      : external_(memory), external_count_(count),
+        release_(std::move(release)) {}
+  PixelStorage(const PixelStorage &other)
+      : owned_(other.data(), other.data() + other.size()) {}
+  PixelStorage(PixelStorage &&other) { swap(other); }
+  ~PixelStorage() { release(); }
+
+  PixelStorage &operator=(PixelStorage other) {
+    swap(other);
+    return *this;
+  }
+
+  void swap(PixelStorage &other) {
+    owned_.swap(other.owned_);
+    std::swap(external_, other.external_);
+    std::swap(external_count_, other.external_count_);
+    std::swap(release_, other.release_);
+  }
+
+  // Adopted memory is kept as long as it already holds count pixels
+  void resize(const size_t count) {
+    if (is_external() && count == external_count_)
+      return;
+    release();
+    owned_.resize(count);
+  }
+
+  bool is_external() const { return external_ != nullptr; }
+  size_t size() const {
+    return is_external() ? external_count_ : owned_.size();
+  }
+  T *data() { return is_external() ? external_ : owned_.data(); }
+  const T *data() const { return is_external() ? external_ : owned_.data(); }
+  T &operator[](const size_t i) { return data()[i]; }
+  const T &operator[](const size_t i) const { return data()[i]; }
+  std::vector<T> to_vector() const {
+    return std::vector<T>(data(), data() + size());
+  }
+
+  bool operator==(const PixelStorage &rhs) const {
+    return size() == rhs.size() &&
+           std::equal(data(), data() + size(), rhs.data());
+  }
+
+private:
+  void release() {
+    if (release_)
+      release_(external_);
+    external_ = nullptr;
+    external_count_ = 0;
+    release_ = nullptr;
+  }
+
+  std::vector<T> owned_;
+  T *external_ = nullptr;
+  size_t external_count_ = 0;
+  release_function release_;
+};
+
 template <typename T> class Image {
 public:
   virtual ~Image() = default;
@@ -35,14 +111,24 @@ public:
   virtual const T *raw_data() const = 0;
 };
 
+// Codec used to read and write PNG files. libpng decodes rows straight into
+// the pixel buffer, GIL goes through an intermediate rgba8 image.
+enum class PNGCodec { libpng, gil };
+
 template <typename T> class ImagePNG : public Image<T> {
 public:
   ImagePNG();
   ImagePNG(const std::string &image_path);
   ImagePNG(const int width, const int height);
   ImagePNG(const int width, const int height, const std::vector<T> &data);
+  // Uses width * height pixels at memory in place instead of allocating;
+  // release, if given, is called with memory when the image is destroyed
+  ImagePNG(const int width, const int height, T *memory,
+           typename PixelStorage<T>::release_function release = nullptr);
   bool read(const std::string &image_path) override;
+  bool read(const std::string &image_path, const PNGCodec codec);
   bool write(const std::string &image_path) override;
+  bool write(const std::string &image_path, const PNGCodec codec);
   bool write(const std::string &image_path, const T *data) override;
   int width() const override;
   int height() const override;
@@ -59,22 +145,39 @@ public:
   const T *raw_data() const override;
 
   bool operator==(const ImagePNG &rhs) const;
+  bool uses_external_memory() const;
   void dump_image() const;
 
 private:
-  std::vector<T> pixels_;
+  PixelStorage<T> pixels_;
   int width_;
   int height_;
 };
 
 typedef ImagePNG<uint32_t> ImagePNG32Bit;
 
+// Reads the PNG files at image_paths on up to thread_count threads, 0 meaning
+// one thread per hardware thread
+std::vector<ImagePNG32Bit>
+read_png_images(const std::vector<std::string> &image_paths,
+                unsigned thread_count = 0);
+
+// Returns the decoded image shared by every reader of image_path. The file is
+// decoded again only once its modification time changes.
+std::shared_ptr<const ImagePNG32Bit>
+read_png_image_cached(const std::string &image_path);
+void clear_png_image_cache();
+
 template <typename T> class ImageBMP : public Image<T> {
 public:
   ImageBMP();
   ImageBMP(const std::string &image_path);
   ImageBMP(const int width, const int height);
   ImageBMP(const int width, const int height, const std::vector<T> &data);
+  // Uses width * height pixels at memory in place instead of allocating;
+  // release, if given, is called with memory when the image is destroyed
+  ImageBMP(const int width, const int height, T *memory,
+           typename PixelStorage<T>::release_function release = nullptr);
   bool read(const std::string &image_path) override;
   bool write(const std::string &image_path) override;
   bool write(const std::string &image_path, const T *data) override;
@@ -93,9 +196,10 @@ public:
   const T *raw_data() const override;
 
   bool operator==(const ImageBMP &rhs) const;
+  bool uses_external_memory() const;
 
 private:
-  std::vector<T> pixels_;
+  PixelStorage<T> pixels_;
   int width_;
   int height_;
 };
@@ -9,6 +9,18 @@
 #include "image/image.hpp"
 #include "logging/logging.hpp"
 
+#include <atomic>
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <png.h>
+
 #define png_infopp_NULL (png_infopp) NULL
 #define int_p_NULL (int *)NULL
 
@@ -21,6 +33,8 @@
 #define BOOST_GIL_IO_PNG_168_API
 #endif
 
+// Without it gil throws on gray+alpha files, libpng reads them
+#define BOOST_GIL_IO_ENABLE_GRAY_ALPHA
 #ifdef BOOST_GIL_IO_PNG_168_API
 #include <boost/gil/extension/io/png.hpp>
 #else
@@ -47,9 +61,135 @@ ImagePNG<T>::ImagePNG(const int width, const int height)
 template <typename T>
 ImagePNG<T>::ImagePNG(const int width, const int height,
                       const std::vector<T> &data)
-    : width_(width), height_(height), pixels_(data) {}
+    : pixels_(data), width_(width), height_(height) {}
+
+template <typename T>
+ImagePNG<T>::ImagePNG(const int width, const int height, T *memory,
+                      typename PixelStorage<T>::release_function release)
+    : pixels_(memory, static_cast<size_t>(width) * height, std::move(release)),
+      width_(width), height_(height) {}
+
+// Packs an RGBA byte quadruple into the 0xRRGGBBAA layout of ImagePNG32Bit
+static inline uint32_t pack_rgba(const uint8_t *rgba) {
+  return (static_cast<uint32_t>(rgba[0]) << 24) |
+         (static_cast<uint32_t>(rgba[1]) << 16) |
+         (static_cast<uint32_t>(rgba[2]) << 8) | rgba[3];
+}
+
+static inline void unpack_rgba(const uint32_t pixel, uint8_t *rgba) {
+  rgba[0] = (pixel >> 24) & 0xFF;
+  rgba[1] = (pixel >> 16) & 0xFF;
+  rgba[2] = (pixel >> 8) & 0xFF;
+  rgba[3] = pixel & 0xFF;
+}
+
+// libpng reports errors by longjmp back to the setjmp below, so every object
+// with a destructor is created before it and outlives the libpng calls
+static bool read_png_libpng(const std::string &image_path,
+                            PixelStorage<uint32_t> &pixels, int &width,
+                            int &height) {
+  FILE *file = std::fopen(image_path.c_str(), "rb");
+  if (file == nullptr) {
+    LOG_ERROR << "Failed to open PNG file " << image_path;
+    return true;
+  }
+  png_structp png =
+      png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+  png_infop info = png ? png_create_info_struct(png) : nullptr;
+  std::vector<png_bytep> rows;
+  bool error = true;
+
+  if (info != nullptr && !setjmp(png_jmpbuf(png))) {
+    png_init_io(png, file);
+    png_read_info(png, info);
+    // Convert every color type and bit depth to 8 bit RGBA, like GIL's
+    // read_and_convert_image to rgba8
+    png_set_palette_to_rgb(png);
+    png_set_expand_gray_1_2_4_to_8(png);
+    png_set_tRNS_to_alpha(png);
+    png_set_scale_16(png);
+    png_set_gray_to_rgb(png);
+    png_set_add_alpha(png, 0xFF, PNG_FILLER_AFTER);
+    png_set_interlace_handling(png);
+    png_read_update_info(png, info);
+
+    width = static_cast<int>(png_get_image_width(png, info));
+    height = static_cast<int>(png_get_image_height(png, info));
+    pixels.resize(static_cast<size_t>(width) * height);
+    // Each RGBA row is exactly as wide as a row of packed pixels, so rows are
+    // decoded in place and packed afterwards
+    rows.resize(height);
+    for (int y = 0; y < height; ++y) {
+      rows[y] = reinterpret_cast<png_bytep>(pixels.data() + y * width);
+    }
+    png_read_image(png, rows.data());
+    png_read_end(png, nullptr);
+    error = false;
+  }
+  png_destroy_read_struct(&png, &info, nullptr);
+  std::fclose(file);
+
+  if (error) {
+    LOG_ERROR << "Failed to decode PNG file " << image_path;
+    width = 0;
+    height = 0;
+    pixels.resize(0);
+    return true;
+  }
+  for (size_t i = 0; i < pixels.size(); ++i) {
+    uint8_t rgba[4];
+    std::memcpy(rgba, &pixels[i], sizeof(rgba));
+    pixels[i] = pack_rgba(rgba);
+  }
+  return false;
+}
+
+static bool write_png_libpng(const std::string &image_path,
+                             const uint32_t *pixels, const int width,
+                             const int height) {
+  FILE *file = std::fopen(image_path.c_str(), "wb");
+  if (file == nullptr) {
+    LOG_ERROR << "Failed to open PNG file " << image_path;
+    return true;
+  }
+  png_structp png =
+      png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+  png_infop info = png ? png_create_info_struct(png) : nullptr;
+  std::vector<png_byte> row(static_cast<size_t>(width) * 4);
+  bool error = true;
+
+  if (info != nullptr && !setjmp(png_jmpbuf(png))) {
+    png_init_io(png, file);
+    png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_RGBA,
+                 PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+                 PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(png, info);
+    for (int y = 0; y < height; ++y) {
+      const uint32_t *src = pixels + static_cast<size_t>(y) * width;
+      for (int x = 0; x < width; ++x) {
+        unpack_rgba(src[x], &row[x * 4]);
+      }
+      png_write_row(png, row.data());
+    }
+    png_write_end(png, nullptr);
+    error = false;
+  }
+  png_destroy_write_struct(&png, &info);
+  std::fclose(file);
+
+  if (error) {
+    LOG_ERROR << "Failed to encode PNG file " << image_path;
+  }
+  return error;
+}
+
+template <>
+bool ImagePNG<uint32_t>::read(const std::string &image_path,
+                              const PNGCodec codec) {
+  if (codec == PNGCodec::libpng) {
+    return read_png_libpng(image_path, pixels_, width_, height_);
+  }
 
-template <> bool ImagePNG<uint32_t>::read(const std::string &image_path) {
   gil::rgba8_image_t image;
 #ifdef BOOST_GIL_IO_PNG_168_API
   gil::read_and_convert_image(image_path, image, gil::png_tag());
@@ -57,28 +197,31 @@ template <> bool ImagePNG<uint32_t>::read(const std::string &image_path) {
   gil::png_read_and_convert_image(image_path, image);
 #endif
   gil::rgba8_view_t view = gil::view(image);
-  for (gil::rgba8_pixel_t pixel : view) {
-    uint32_t raw_pixel =
-        (pixel[0] << 24) + (pixel[1] << 16) + (pixel[2] << 8) + pixel[3];
-    pixels_.push_back(raw_pixel);
-  }
   width_ = static_cast<int>(view.width());
   height_ = static_cast<int>(view.height());
+  // Decode straight into adopted memory when it already fits the image
+  pixels_.resize(size());
+  int id = 0;
+  for (gil::rgba8_pixel_t pixel : view) {
+    const uint8_t rgba[4] = {pixel[0], pixel[1], pixel[2], pixel[3]};
+    pixels_[id++] = pack_rgba(rgba);
+  }
   return false;
 }
 
-template <> bool ImagePNG<uint32_t>::write(const std::string &image_path) {
+template <>
+bool ImagePNG<uint32_t>::write(const std::string &image_path,
+                               const PNGCodec codec) {
+  if (codec == PNGCodec::libpng) {
+    return write_png_libpng(image_path, pixels_.data(), width(), height());
+  }
+
   gil::rgba8_image_t image(width(), height());
-  std::vector<gil::rgba8_pixel_t> channels;
   gil::rgba8_view_t view = gil::view(image);
   for (int id = 0; id < static_cast<int>(pixels_.size()); ++id) {
-    uint32_t raw_pixel = pixels_[id];
-    gil::rgba8_pixel_t pixel;
-    pixel[3] = raw_pixel & 0xFF;
-    pixel[2] = (raw_pixel >> 8) & 0xFF;
-    pixel[1] = (raw_pixel >> 16) & 0xFF;
-    pixel[0] = (raw_pixel >> 24) & 0xFF;
-    view[id] = pixel;
+    uint8_t rgba[4];
+    unpack_rgba(pixels_[id], rgba);
+    view[id] = gil::rgba8_pixel_t(rgba[0], rgba[1], rgba[2], rgba[3]);
   }
 #ifdef BOOST_GIL_IO_PNG_168_API
   gil::write_view(image_path, view, gil::png_tag());
@@ -88,6 +231,14 @@ template <> bool ImagePNG<uint32_t>::write(const std::string &image_path) {
   return false;
 }
 
+template <> bool ImagePNG<uint32_t>::read(const std::string &image_path) {
+  return read(image_path, PNGCodec::libpng);
+}
+
+template <> bool ImagePNG<uint32_t>::write(const std::string &image_path) {
+  return write(image_path, PNGCodec::libpng);
+}
+
 template <typename T>
 bool ImagePNG<T>::write(const std::string &image_path, const T *data) {
   copy_raw_data(data);
@@ -127,11 +278,11 @@ void ImagePNG<T>::set_pixel(const int x, const int y, const T data) {
 
 template <typename T>
 std::vector<T> level_zero_tests::ImagePNG<T>::get_pixels() const {
-  return pixels_;
+  return pixels_.to_vector();
 }
 
 template <typename T> void ImagePNG<T>::copy_raw_data(const T *data) {
-  std::copy(data, data + size(), std::begin(pixels_));
+  std::copy(data, data + size(), pixels_.data());
 }
 
 template <typename T> T *ImagePNG<T>::raw_data() { return pixels_.data(); }
@@ -140,6 +291,10 @@ template <typename T> const T *ImagePNG<T>::raw_data() const {
   return pixels_.data();
 }
 
+template <typename T> bool ImagePNG<T>::uses_external_memory() const {
+  return pixels_.is_external();
+}
+
 template <typename T>
 bool ImagePNG<T>::operator==(const ImagePNG<T> &rhs) const {
   return pixels_ == rhs.pixels_;
@@ -157,6 +312,67 @@ template <typename T> void ImagePNG<T>::dump_image() const {
 
 template class ImagePNG<uint32_t>;
 
+std::vector<ImagePNG32Bit>
+read_png_images(const std::vector<std::string> &image_paths,
+                unsigned thread_count) {
+  std::vector<ImagePNG32Bit> images(image_paths.size());
+  if (thread_count == 0) {
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  }
+  thread_count = static_cast<unsigned>(
+      std::min<size_t>(thread_count, image_paths.size()));
+
+  std::atomic<size_t> next_image(0);
+  auto decode = [&]() {
+    for (size_t i = next_image++; i < image_paths.size(); i = next_image++) {
+      images[i].read(image_paths[i]);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned t = 1; t < thread_count; ++t) {
+    threads.emplace_back(decode);
+  }
+  decode();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return images;
+}
+
+namespace {
+struct cached_png_image {
+  time_t modification_time;
+  std::shared_ptr<const ImagePNG32Bit> image;
+};
+
+std::mutex png_image_cache_mutex;
+std::map<std::string, cached_png_image> png_image_cache;
+} // namespace
+
+std::shared_ptr<const ImagePNG32Bit>
+read_png_image_cached(const std::string &image_path) {
+  struct stat file_status;
+  if (stat(image_path.c_str(), &file_status) != 0) {
+    // Let the decoder report the missing file, there is nothing to cache
+    return std::make_shared<const ImagePNG32Bit>(image_path);
+  }
+
+  std::lock_guard<std::mutex> lock(png_image_cache_mutex);
+  auto entry = png_image_cache.find(image_path);
+  if (entry != png_image_cache.end() &&
+      entry->second.modification_time == file_status.st_mtime) {
+    return entry->second.image;
+  }
+  auto image = std::make_shared<const ImagePNG32Bit>(image_path);
+  png_image_cache[image_path] = {file_status.st_mtime, image};
+  return image;
+}
+
+void clear_png_image_cache() {
+  std::lock_guard<std::mutex> lock(png_image_cache_mutex);
+  png_image_cache.clear();
+}
+
 template <typename T> ImageBMP<T>::ImageBMP() : width_(0), height_(0) {}
 
 template <typename T> ImageBMP<T>::ImageBMP(const std::string &image_path) {
@@ -172,28 +388,34 @@ ImageBMP<T>::ImageBMP(const int width, const int height)
 template <typename T>
 ImageBMP<T>::ImageBMP(const int width, const int height,
                       const std::vector<T> &data)
-    : width_(width), height_(height), pixels_(data) {}
+    : pixels_(data), width_(width), height_(height) {}
+
+template <typename T>
+ImageBMP<T>::ImageBMP(const int width, const int height, T *memory,
+                      typename PixelStorage<T>::release_function release)
+    : pixels_(memory, static_cast<size_t>(width) * height, std::move(release)),
+      width_(width), height_(height) {}
 
 template <typename T> bool ImageBMP<T>::read(const std::string &image_path) {
-  std::unique_ptr<uint8_t> data = nullptr;
+  std::unique_ptr<uint8_t[]> data = nullptr;
   uint8_t *tmp = nullptr;
   int pitch = 0;
   uint16_t bits_per_pixel = 0;
   bool error = !BmpUtils::load_bmp_image(tmp, width_, height_, pitch,
                                          bits_per_pixel, image_path.c_str());
   data.reset(tmp);
-  pixels_.resize(size(), 0);
+  pixels_.resize(size());
   copy_raw_data(reinterpret_cast<T *>(data.get()));
   return error;
 }
 
 template <> bool ImageBMP<uint8_t>::read(const std::string &image_path) {
-  std::unique_ptr<uint8_t> data = nullptr;
+  std::unique_ptr<uint8_t[]> data = nullptr;
   uint8_t *tmp = nullptr;
   bool error =
       !BmpUtils::load_bmp_image_8u(tmp, width_, height_, image_path.c_str());
   data.reset(tmp);
-  pixels_.resize(size(), 0);
+  pixels_.resize(size());
   copy_raw_data(data.get());
   return error;
 }
@@ -246,11 +468,11 @@ void ImageBMP<T>::set_pixel(const int x, const int y, const T data) {
 }
 
 template <typename T> std::vector<T> ImageBMP<T>::get_pixels() const {
-  return pixels_;
+  return pixels_.to_vector();
 }
 
 template <typename T> void ImageBMP<T>::copy_raw_data(const T *data) {
-  std::copy(data, data + size(), std::begin(pixels_));
+  std::copy(data, data + size(), pixels_.data());
 }
 
 template <typename T> T *ImageBMP<T>::raw_data() { return pixels_.data(); }
@@ -259,6 +481,10 @@ template <typename T> const T *ImageBMP<T>::raw_data() const {
   return pixels_.data();
 }
 
+template <typename T> bool ImageBMP<T>::uses_external_memory() const {
+  return pixels_.is_external();
+}
+
 template <typename T> bool ImageBMP<T>::operator==(const ImageBMP &rhs) const {
   return pixels_ == rhs.pixels_;
 }
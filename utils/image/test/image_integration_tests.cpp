@@ -41,6 +41,102 @@ TEST(ImageIntegrationTests, WritesPNGFile) {
   EXPECT_EQ(image.get_pixels(), pixels);
 }
 
+TEST(ImageIntegrationTests, PNGCodecsDecodeTheSamePixels) {
+  // One file per color type the codecs convert to 8-bit RGBA
+  const std::vector<std::pair<std::string, std::vector<uint32_t>>> files = {
+      {"rgb_brg_3x2.png",
+       {0xFF0000FF, 0x00FF00FF, 0x0000FFFF, 0x0000FFFF, 0xFF0000FF,
+        0x00FF00FF}},
+      {"rgb_brg_3x2_rgb.png",
+       {0xFF0000FF, 0x00FF00FF, 0x0000FFFF, 0x0000FFFF, 0xFF0000FF,
+        0x00FF00FF}},
+      {"rgb_brg_3x2_rgba.png",
+       {0xFF0000FF, 0x00FF0080, 0x0000FF00, 0x0000FF40, 0xFF0000C0,
+        0x00FF00FF}},
+      {"rgb_brg_3x2_rgba16.png",
+       {0xFF0000FF, 0x00FF0080, 0x0000FF00, 0x0000FF40, 0xFF0000BF,
+        0x00FF00FF}},
+      {"rgb_brg_3x2_palette.png",
+       {0xFF0000FF, 0x00FF0080, 0x0000FFFF, 0x0000FFFF, 0xFF0000FF,
+        0x00FF0080}},
+      {"kgw_wkg_3x2_gray.png",
+       {0x000000FF, 0x808080FF, 0xFFFFFFFF, 0xFFFFFFFF, 0x000000FF,
+        0x808080FF}},
+      {"kgw_wkg_3x2_gray_alpha.png",
+       {0x000000FF, 0x80808080, 0xFFFFFF00, 0xFFFFFF40, 0x000000C0,
+        0x808080FF}}};
+
+  for (const auto &file : files) {
+    SCOPED_TRACE(file.first);
+    level_zero_tests::ImagePNG32Bit libpng_image;
+    level_zero_tests::ImagePNG32Bit gil_image;
+    EXPECT_FALSE(
+        libpng_image.read(file.first, level_zero_tests::PNGCodec::libpng));
+    EXPECT_FALSE(gil_image.read(file.first, level_zero_tests::PNGCodec::gil));
+    EXPECT_EQ(libpng_image.width(), 3);
+    EXPECT_EQ(libpng_image.height(), 2);
+    EXPECT_EQ(libpng_image.width(), gil_image.width());
+    EXPECT_EQ(libpng_image.height(), gil_image.height());
+    EXPECT_EQ(libpng_image.get_pixels(), file.second);
+    EXPECT_TRUE(libpng_image == gil_image);
+  }
+}
+
+TEST(ImageIntegrationTests, PNGCodecsEncodeCompatibleFiles) {
+  const std::vector<uint32_t> pixels = {
+      0x12345678, //
+      0x9ABCDEF0, //
+      0x00FF00FF, //
+      0xFF00FF00  //
+  };
+  level_zero_tests::ImagePNG32Bit image(2, 2, pixels);
+  image.write("output.png", level_zero_tests::PNGCodec::libpng);
+
+  level_zero_tests::ImagePNG32Bit output;
+  output.read("output.png", level_zero_tests::PNGCodec::gil);
+  EXPECT_EQ(output.get_pixels(), pixels);
+  std::remove("output.png");
+}
+
+TEST(ImageIntegrationTests, ReadsPNGFileIntoExternalMemory) {
+  std::vector<uint32_t> memory(6);
+  level_zero_tests::ImagePNG32Bit image(3, 2, memory.data());
+  image.read("rgb_brg_3x2.png");
+  EXPECT_TRUE(image.uses_external_memory());
+  EXPECT_EQ(memory,
+            level_zero_tests::ImagePNG32Bit("rgb_brg_3x2.png").get_pixels());
+}
+
+TEST(ImageIntegrationTests, ReportsMissingPNGFile) {
+  level_zero_tests::ImagePNG32Bit image;
+  EXPECT_TRUE(image.read("missing.png"));
+  EXPECT_EQ(image.size(), 0);
+}
+
+TEST(ImageIntegrationTests, ReadsPNGFilesInParallel) {
+  const std::vector<std::string> paths(16, "rgb_brg_3x2.png");
+  const level_zero_tests::ImagePNG32Bit expected("rgb_brg_3x2.png");
+  auto images = level_zero_tests::read_png_images(paths, 4);
+  ASSERT_EQ(images.size(), paths.size());
+  for (const auto &image : images) {
+    EXPECT_TRUE(image == expected);
+  }
+}
+
+TEST(ImageIntegrationTests, CachesDecodedPNGFiles) {
+  level_zero_tests::clear_png_image_cache();
+  auto first = level_zero_tests::read_png_image_cached("rgb_brg_3x2.png");
+  auto second = level_zero_tests::read_png_image_cached("rgb_brg_3x2.png");
+  EXPECT_EQ(first, second);
+  EXPECT_TRUE(*first ==
+              level_zero_tests::ImagePNG32Bit("rgb_brg_3x2.png"));
+
+  level_zero_tests::clear_png_image_cache();
+  auto third = level_zero_tests::read_png_image_cached("rgb_brg_3x2.png");
+  EXPECT_NE(first, third);
+  EXPECT_TRUE(*first == *third);
+}
+
 TEST(ImageIntegrationTests, ReadsGrayscaleBMPFile) {
   level_zero_tests::ImageBMP8Bit image("kwkw_wwkk_4x2_mono.bmp");
   const std::vector<uint8_t> pixels = {
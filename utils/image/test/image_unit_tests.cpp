@@ -141,3 +141,51 @@ TYPED_TEST(SizeInBytes, MultiplePixels) {
   const TypeParam image(2, 2);
   EXPECT_EQ(image.size_in_bytes(), level_zero_tests::size_in_bytes(image));
 }
+
+template <typename T> class ExternalMemory : public testing::Test {};
+TYPED_TEST_CASE(ExternalMemory, ImageTypes);
+
+TYPED_TEST(ExternalMemory, PixelsAreSharedWithMemory) {
+  typedef decltype(TypeParam().get_pixel(0, 0)) pixel_t;
+  std::vector<pixel_t> memory = {1, 2, 3, 4, 5, 6};
+  TypeParam image(3, 2, memory.data());
+  EXPECT_TRUE(image.uses_external_memory());
+  EXPECT_EQ(image.raw_data(), memory.data());
+  EXPECT_EQ(image.size_in_bytes(), static_cast<int>(6 * sizeof(pixel_t)));
+  EXPECT_EQ(image.get_pixel(2, 1), 6);
+
+  image.set_pixel(1, 0, 7);
+  EXPECT_EQ(memory[1], 7);
+  memory[3] = 8;
+  EXPECT_EQ(image.get_pixel(0, 1), 8);
+}
+
+TYPED_TEST(ExternalMemory, ReleaseIsCalledOnDestruction) {
+  typedef decltype(TypeParam().get_pixel(0, 0)) pixel_t;
+  std::vector<pixel_t> memory(4);
+  int released = 0;
+  {
+    TypeParam image(2, 2, memory.data(), [&](pixel_t *p) {
+      EXPECT_EQ(p, memory.data());
+      released++;
+    });
+    TypeParam moved(std::move(image));
+    EXPECT_TRUE(moved.uses_external_memory());
+    EXPECT_EQ(moved.raw_data(), memory.data());
+    EXPECT_EQ(released, 0);
+  }
+  EXPECT_EQ(released, 1);
+}
+
+TYPED_TEST(ExternalMemory, CopyOwnsItsPixels) {
+  typedef decltype(TypeParam().get_pixel(0, 0)) pixel_t;
+  std::vector<pixel_t> memory = {1, 2, 3, 4};
+  const TypeParam image(2, 2, memory.data());
+  TypeParam copy(image);
+  EXPECT_FALSE(copy.uses_external_memory());
+  EXPECT_NE(copy.raw_data(), memory.data());
+  EXPECT_TRUE(copy == image);
+
+  copy.set_pixel(0, 0, 9);
+  EXPECT_EQ(memory[0], 1);
+}
@@ -0,0 +1,208 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "logging/logging.hpp"
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <streambuf>
+#include <thread>
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+namespace lzt = level_zero_tests;
+
+// Discards everything written to it, so the benchmark measures the cost of
+// the logging calls rather than of the console
+class null_buffer : public std::streambuf {
+protected:
+  int overflow(int c) override { return c; }
+  std::streamsize xsputn(const char *, std::streamsize n) override {
+    return n;
+  }
+};
+
+// CPU time consumed by the calling thread. The background thread of the
+// asynchronous sink may preempt the logging thread, so wall time would charge
+// its formatting to the caller on machines with few cores.
+static double thread_cpu_ns() {
+#ifndef _WIN32
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return now.tv_sec * 1e9 + now.tv_nsec;
+#else
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+enum class record_kind { logged, filtered, compiled_out };
+
+static void log_records(const record_kind kind, const uint32_t iterations) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    if (kind == record_kind::logged) {
+      LOG_INFO << "Benchmark record " << i << " of " << iterations;
+    } else if (kind == record_kind::filtered) {
+      LOG_DEBUG << "Benchmark record " << i << " of " << iterations;
+    } else {
+#pragma push_macro("LZT_LOG_MIN_LEVEL")
+#undef LZT_LOG_MIN_LEVEL
+#define LZT_LOG_MIN_LEVEL 2
+      LOG_DEBUG << "Benchmark record " << i << " of " << iterations;
+#pragma pop_macro("LZT_LOG_MIN_LEVEL")
+    }
+  }
+}
+
+struct call_cost {
+  double wall_ns;
+  double cpu_ns;
+};
+
+// Returns the average time a logging call takes on the calling thread, the
+// time the background thread needs to drain the queue is not included
+static call_cost measure_ns_per_call(const lzt::LoggingSettings &settings,
+                                  const record_kind kind,
+                                  const uint32_t iterations,
+                                  const uint32_t thread_count) {
+  lzt::init_logging(settings);
+
+  std::vector<call_cost> thread_cost(thread_count);
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < thread_count; t++) {
+    threads.emplace_back([&, t]() {
+      auto start = std::chrono::steady_clock::now();
+      double start_cpu = thread_cpu_ns();
+      log_records(kind, iterations);
+      thread_cost[t].cpu_ns = thread_cpu_ns() - start_cpu;
+      thread_cost[t].wall_ns = std::chrono::duration<double, std::nano>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count();
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  lzt::stop_logging();
+
+  call_cost total = {0, 0};
+  for (auto cost : thread_cost) {
+    total.wall_ns += cost.wall_ns;
+    total.cpu_ns += cost.cpu_ns;
+  }
+  const double calls = static_cast<double>(iterations) * thread_count;
+  return {total.wall_ns / calls, total.cpu_ns / calls};
+}
+
+int main(int argc, char **argv) {
+  uint32_t iterations = 0;
+  uint32_t thread_count = 0;
+  uint32_t repetitions = 0;
+  size_t queue_size = 0;
+  std::string log_file;
+
+  po::options_description desc("Allowed options");
+  desc.add_options()("help", "produce help message")(
+      "iterations", po::value<uint32_t>(&iterations)->default_value(100000),
+      "records logged by each thread")(
+      "threads", po::value<uint32_t>(&thread_count)->default_value(1),
+      "number of threads logging concurrently")(
+      "repetitions", po::value<uint32_t>(&repetitions)->default_value(5),
+      "runs of each case, the fastest is reported")(
+      "queue-size", po::value<size_t>(&queue_size)->default_value(4096),
+      "records each thread may queue for asynchronous logging, 0 for "
+      "unbounded")(
+      "log-file", po::value<std::string>(&log_file),
+      "write the records to this file instead of discarding them");
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+  if (vm.count("help") || (iterations == 0) || (thread_count == 0) ||
+      (repetitions == 0)) {
+    std::cout << desc << std::endl;
+    return vm.count("help") ? 0 : 1;
+  }
+
+  null_buffer discard;
+  std::filebuf file;
+  if (!log_file.empty() && !file.open(log_file, std::ios::out)) {
+    std::cerr << "Failed to open " << log_file << std::endl;
+    return 1;
+  }
+  std::streambuf *console =
+      std::clog.rdbuf(log_file.empty() ? static_cast<std::streambuf *>(&discard)
+                                       : &file);
+
+  struct benchmark_case {
+    std::string name;
+    bool asynchronous;
+    lzt::logging_overflow overflow;
+    record_kind kind;
+  };
+  const std::vector<benchmark_case> cases = {
+      {"compiled out", false, lzt::logging_overflow::block,
+       record_kind::compiled_out},
+      {"filtered at run time", false, lzt::logging_overflow::block,
+       record_kind::filtered},
+      {"synchronous", false, lzt::logging_overflow::block,
+       record_kind::logged},
+      {"asynchronous, block", true, lzt::logging_overflow::block,
+       record_kind::logged},
+      {"asynchronous, drop", true, lzt::logging_overflow::drop,
+       record_kind::logged},
+  };
+
+  std::vector<call_cost> results;
+  std::vector<uint64_t> dropped;
+  for (const auto &c : cases) {
+    lzt::LoggingSettings settings;
+    settings.level = lzt::logging_level::info;
+    settings.asynchronous = c.asynchronous;
+    settings.queue_size = queue_size;
+    settings.overflow = c.overflow;
+    // Other processes and the sink's own thread add noise that only ever
+    // makes a run slower, so the fastest run is the closest to the real cost
+    call_cost best = {0, 0};
+    uint64_t best_dropped = 0;
+    for (uint32_t r = 0; r < repetitions; r++) {
+      const uint64_t dropped_before = lzt::dropped_log_records();
+      const call_cost cost =
+          measure_ns_per_call(settings, c.kind, iterations, thread_count);
+      if ((r == 0) || (cost.cpu_ns < best.cpu_ns)) {
+        best = cost;
+        best_dropped = lzt::dropped_log_records() - dropped_before;
+      }
+    }
+    results.push_back(best);
+    dropped.push_back(best_dropped);
+  }
+
+  std::clog.rdbuf(console);
+  std::cout << "Logging cost on the calling thread, " << thread_count
+            << " thread(s), " << iterations << " records each, best of "
+            << repetitions << std::endl;
+  std::cout << std::left << std::setw(24) << "" << std::right << std::setw(14)
+            << "wall ns/call" << std::setw(14) << "cpu ns/call" << std::endl;
+  for (size_t i = 0; i < cases.size(); i++) {
+    std::cout << std::left << std::setw(24) << cases[i].name << std::right
+              << std::fixed << std::setprecision(1) << std::setw(14)
+              << results[i].wall_ns << std::setw(14) << results[i].cpu_ns;
+    if (dropped[i]) {
+      std::cout << "  (" << dropped[i] << " dropped)";
+    }
+    std::cout << std::endl;
+  }
+  return 0;
+}
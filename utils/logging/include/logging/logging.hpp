@@ -9,6 +9,8 @@
 #ifndef level_zero_tests_LOGGING_HPP
 #define level_zero_tests_LOGGING_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -19,12 +21,26 @@
 
 namespace level_zero_tests {
 
-#define LOG_TRACE BOOST_LOG_TRIVIAL(trace)
-#define LOG_DEBUG BOOST_LOG_TRIVIAL(debug)
-#define LOG_INFO BOOST_LOG_TRIVIAL(info)
-#define LOG_WARNING BOOST_LOG_TRIVIAL(warning)
-#define LOG_ERROR BOOST_LOG_TRIVIAL(error)
-#define LOG_FATAL BOOST_LOG_TRIVIAL(fatal)
+// Records below this level are compiled out, their arguments are never
+// evaluated. Levels count from 0 for trace up to 5 for fatal, so building with
+// -DLZT_LOG_MIN_LEVEL=2 removes LOG_TRACE and LOG_DEBUG.
+#ifndef LZT_LOG_MIN_LEVEL
+#define LZT_LOG_MIN_LEVEL 0
+#endif
+
+// A loop rather than if/else, so an unbraced if around a log statement
+// does not get an ambiguous else
+#define LZT_LOG(level_number, severity)                                        \
+  for (bool lzt_log_enabled = (LZT_LOG_MIN_LEVEL <= level_number);             \
+       lzt_log_enabled; lzt_log_enabled = false)                               \
+  BOOST_LOG_TRIVIAL(severity)
+
+#define LOG_TRACE LZT_LOG(0, trace)
+#define LOG_DEBUG LZT_LOG(1, debug)
+#define LOG_INFO LZT_LOG(2, info)
+#define LOG_WARNING LZT_LOG(3, warning)
+#define LOG_ERROR LZT_LOG(4, error)
+#define LOG_FATAL LZT_LOG(5, fatal)
 
 #define LOG_ENTER_FUNCTION LOG_TRACE << "Enter function: " << __func__;
 #define LOG_EXIT_FUNCTION LOG_TRACE << "Exit function: " << __func__;
@@ -33,17 +49,33 @@ enum class logging_format { simple, precise };
 std::ostream &operator<<(std::ostream &os, const logging_format &f);
 std::istream &operator>>(std::istream &is, logging_format &f);
 
+// What a full asynchronous queue does with a new record
+enum class logging_overflow { block, drop };
+std::ostream &operator<<(std::ostream &os, const logging_overflow &o);
+std::istream &operator>>(std::istream &is, logging_overflow &o);
+
 using logging_level = boost::log::trivial::severity_level;
 
 struct LoggingSettings {
   logging_format format = logging_format::precise;
   logging_level level = logging_level::info;
+  // Format and write records on a background thread, the logging thread
+  // only queues them
+  bool asynchronous = false;
+  // Records each logging thread may have queued before overflow applies, 0
+  // for an unbounded queue
+  size_t queue_size = 4096;
+  logging_overflow overflow = logging_overflow::block;
 };
 
 void init_logging();
 void init_logging(const LoggingSettings settings);
 void init_logging(std::vector<std::string> &command_line);
 void stop_logging();
+// Waits until every queued record is written
+void flush_logging();
+// Records discarded by a full asynchronous queue since logging started
+uint64_t dropped_log_records();
 void add_stream(const boost::shared_ptr<std::ostream> &stream);
 LoggingSettings parse_command_line(std::vector<std::string> &command_line);
 
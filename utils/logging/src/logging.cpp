@@ -8,13 +8,24 @@
 
 #include "logging/logging.hpp"
 
+#include <boost/core/null_deleter.hpp>
 #include <boost/log/core.hpp>
 #include <boost/log/expressions.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
 #include <boost/log/sinks/sync_frontend.hpp>
 #include <boost/log/sinks/text_ostream_backend.hpp>
 #include <boost/log/utility/setup/common_attributes.hpp>
 #include <boost/log/utility/setup/console.hpp>
 #include <boost/log/support/date_time.hpp>
+#include <boost/smart_ptr/make_shared_object.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace logging = boost::log;
 namespace sinks = boost::log::sinks;
@@ -25,8 +36,352 @@ namespace po = boost::program_options;
 
 namespace level_zero_tests {
 
-typedef sinks::synchronous_sink<sinks::text_ostream_backend> text_sink;
+// Records of one logging thread, in segments of records_per_segment. The
+// logging thread appends to the last segment and the feeding thread takes
+// from the first, each side only writes its own counter, so neither takes a
+// lock. The segment the feeding thread emptied last is kept for the logging
+// thread to reuse, a queue that keeps up allocates nothing.
+class thread_record_queue {
+public:
+  static const size_t records_per_segment = 256;
+
+  thread_record_queue() : head_(new segment), tail_(head_) {}
+
+  ~thread_record_queue() {
+    while (head_) {
+      segment *next = head_->next.load(std::memory_order_relaxed);
+      delete head_;
+      head_ = next;
+    }
+    delete spare_.load(std::memory_order_relaxed);
+  }
+
+  // Logging thread. Only reads the feeding thread's counter when the queue
+  // may be full.
+  bool full(const size_t capacity) {
+    if (capacity == 0 || pushed_ - consumed_cache_ < capacity) {
+      return false;
+    }
+    consumed_cache_ = consumed_.load(std::memory_order_seq_cst);
+    return pushed_ - consumed_cache_ >= capacity;
+  }
+
+  uint64_t backlog() {
+    consumed_cache_ = consumed_.load(std::memory_order_seq_cst);
+    return pushed_ - consumed_cache_;
+  }
+
+  void push(const logging::record_view &record) {
+    if (tail_index_ == records_per_segment) {
+      segment *next = spare_.exchange(nullptr, std::memory_order_acquire);
+      if (!next) {
+        next = new segment;
+      }
+      tail_->next.store(next, std::memory_order_release);
+      tail_ = next;
+      tail_index_ = 0;
+    }
+    tail_->records[tail_index_++] = record;
+    published_.store(++pushed_, std::memory_order_release);
+  }
+
+  // Feeding thread
+  bool empty() {
+    return consumed_count_ == published_.load(std::memory_order_acquire);
+  }
+
+  uint64_t feed_backlog() {
+    return published_.load(std::memory_order_acquire) - consumed_count_;
+  }
+
+  bool pop(logging::record_view &record) {
+    if (consumed_count_ == published_cache_) {
+      published_cache_ = published_.load(std::memory_order_acquire);
+      if (consumed_count_ == published_cache_) {
+        return false;
+      }
+    }
+    if (head_index_ == records_per_segment) {
+      segment *emptied = head_;
+      head_ = head_->next.load(std::memory_order_acquire);
+      head_index_ = 0;
+      emptied->next.store(nullptr, std::memory_order_relaxed);
+      emptied = spare_.exchange(emptied, std::memory_order_release);
+      delete emptied;
+    }
+    record = std::move(head_->records[head_index_++]);
+    consumed_.store(++consumed_count_, std::memory_order_seq_cst);
+    return true;
+  }
+
+  // Set once the logging thread exits or logs to another sink, the feeding
+  // thread forgets the queue when it is also empty
+  std::atomic<bool> abandoned{false};
+
+private:
+  struct segment {
+    std::atomic<segment *> next{nullptr};
+    logging::record_view records[records_per_segment];
+  };
+
+  // Padding keeps the members each thread writes on separate cache lines
+  char padding0_[64];
+  segment *head_;
+  size_t head_index_ = 0;
+  uint64_t consumed_count_ = 0;
+  uint64_t published_cache_ = 0;
+  std::atomic<uint64_t> consumed_{0};
+  char padding1_[64];
+  segment *tail_;
+  size_t tail_index_ = 0;
+  uint64_t pushed_ = 0;
+  uint64_t consumed_cache_ = 0;
+  std::atomic<uint64_t> published_{0};
+  char padding2_[64];
+  std::atomic<segment *> spare_{nullptr};
+};
+
+// Queueing strategy of the asynchronous sink. Each logging thread has a
+// thread_record_queue of its own, so logging threads never wait for each
+// other or for the feeding thread, unless their queue is full and the
+// overflow policy blocks. The records of one thread are written in order,
+// records of different threads may be written in any order. Unlike Boost's
+// bounded_fifo_queue, the capacity and the overflow policy are chosen at run
+// time, and the capacity applies to each thread.
+//
+// The feeding thread sleeps when every queue is empty. The logging threads
+// only wake it up once a queue holds half its capacity, or a segment when
+// unbounded, otherwise it picks the records up within feed_interval, so most
+// logging calls make no system call.
+class bounded_record_queue {
+public:
+  // Before the sink is added to the logging core
+  void configure(const size_t capacity, const logging_overflow overflow) {
+    capacity_ = capacity;
+    overflow_ = overflow;
+    resume_backlog_ = capacity / 2;
+    wakeup_backlog_ =
+        capacity ? std::max<size_t>(capacity / 2, 1)
+                 : thread_record_queue::records_per_segment;
+  }
+
+  uint64_t dropped_records() const { return dropped_; }
+
+protected:
+  bounded_record_queue() : id_(++last_id_) {}
+  template <typename ArgsT>
+  explicit bounded_record_queue(const ArgsT &) : id_(++last_id_) {}
+
+  void enqueue(const logging::record_view &record) {
+    thread_record_queue &queue = this_thread_queue();
+    if (queue.full(capacity_)) {
+      if (overflow_ == logging_overflow::drop) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      wait_not_full(queue);
+    }
+    push(queue, record);
+  }
+
+  bool try_enqueue(const logging::record_view &record) {
+    thread_record_queue &queue = this_thread_queue();
+    if (queue.full(capacity_)) {
+      return false;
+    }
+    push(queue, record);
+    return true;
+  }
+
+  bool try_dequeue_ready(logging::record_view &record) {
+    return try_dequeue(record);
+  }
+
+  // Boost dequeues from one thread at a time
+  bool try_dequeue(logging::record_view &record) {
+    if (registry_version_.load(std::memory_order_acquire) != feed_version_) {
+      refresh_feed_queues();
+    }
+    bool abandoned_empty = false;
+    for (size_t i = 0; i < feed_queues_.size(); i++) {
+      // Start after the queue served last so that no thread is starved
+      thread_record_queue &queue =
+          *feed_queues_[(next_queue_ + i) % feed_queues_.size()];
+      if (queue.pop(record)) {
+        next_queue_ = (next_queue_ + i + 1) % feed_queues_.size();
+        if (blocked_producers_.load(std::memory_order_seq_cst) &&
+            queue.feed_backlog() == resume_backlog_) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          not_full_.notify_all();
+        }
+        return true;
+      }
+      abandoned_empty = abandoned_empty ||
+                        queue.abandoned.load(std::memory_order_acquire);
+    }
+    if (abandoned_empty) {
+      forget_abandoned_queues();
+    }
+    return false;
+  }
+
+  bool dequeue_ready(logging::record_view &record) {
+    if (try_dequeue(record)) {
+      return true;
+    }
+    // Whoever wakes the feeding thread takes the lock first, so the records
+    // queued before the wakeup are seen here
+    std::unique_lock<std::mutex> lock(mutex_);
+    feeder_waiting_.store(true, std::memory_order_seq_cst);
+    not_empty_.wait_for(lock, feed_interval,
+                        [this] { return interrupted_ || has_records(); });
+    feeder_waiting_.store(false, std::memory_order_relaxed);
+    if (interrupted_) {
+      interrupted_ = false;
+      return false;
+    }
+    lock.unlock();
+    return try_dequeue(record);
+  }
+
+  void interrupt_dequeue() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    interrupted_ = true;
+    not_empty_.notify_all();
+  }
+
+private:
+  // Most calls find the queue of the calling thread on the first check
+  struct thread_slot {
+    uint64_t queue_id = 0;
+    std::shared_ptr<thread_record_queue> queue;
+
+    ~thread_slot() {
+      if (queue) {
+        queue->abandoned.store(true, std::memory_order_release);
+      }
+    }
+  };
+
+  thread_record_queue &this_thread_queue() {
+    static thread_local thread_slot slot;
+    if (slot.queue_id != id_) {
+      if (slot.queue) {
+        slot.queue->abandoned.store(true, std::memory_order_release);
+      }
+      slot.queue = std::make_shared<thread_record_queue>();
+      slot.queue_id = id_;
+      std::lock_guard<std::mutex> lock(registry_mutex_);
+      registry_.push_back(slot.queue);
+      registry_version_.fetch_add(1, std::memory_order_release);
+    }
+    return *slot.queue;
+  }
+
+  void push(thread_record_queue &queue, const logging::record_view &record) {
+    queue.push(record);
+    if (feeder_waiting_.load(std::memory_order_relaxed) &&
+        queue.backlog() >= wakeup_backlog_) {
+      wake_feeder();
+    }
+  }
+
+  void wake_feeder() {
+    if (feeder_waiting_.exchange(false, std::memory_order_seq_cst)) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      not_empty_.notify_one();
+    }
+  }
+
+  // A blocked thread resumes once its queue is down to half, not after every
+  // record, so that it does not wake up for each one. The feeding thread
+  // checks blocked_producers_ after taking the record that gets the queue
+  // there, and the queue is checked again after it is incremented, so
+  // either that record is seen here or the feeding thread wakes this thread.
+  void wait_not_full(thread_record_queue &queue) {
+    blocked_producers_.fetch_add(1, std::memory_order_seq_cst);
+    std::unique_lock<std::mutex> lock(mutex_);
+    feeder_waiting_.store(false, std::memory_order_relaxed);
+    not_empty_.notify_one();
+    not_full_.wait(lock,
+                   [&] { return queue.backlog() <= resume_backlog_; });
+    lock.unlock();
+    blocked_producers_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  bool has_records() {
+    if (registry_version_.load(std::memory_order_acquire) != feed_version_) {
+      refresh_feed_queues();
+    }
+    for (auto &queue : feed_queues_) {
+      if (!queue->empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void refresh_feed_queues() {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    feed_queues_ = registry_;
+    feed_version_ = registry_version_.load(std::memory_order_relaxed);
+  }
+
+  void forget_abandoned_queues() {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    registry_.erase(
+        std::remove_if(registry_.begin(), registry_.end(),
+                       [](const std::shared_ptr<thread_record_queue> &queue) {
+                         return queue->abandoned.load(
+                                    std::memory_order_acquire) &&
+                                queue->empty();
+                       }),
+        registry_.end());
+    feed_queues_ = registry_;
+    feed_version_ =
+        registry_version_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  static const std::chrono::milliseconds feed_interval;
+  static std::atomic<uint64_t> last_id_;
+
+  // Tells the queues of this sink apart from those of an earlier one
+  const uint64_t id_;
+  size_t capacity_ = 0;
+  size_t wakeup_backlog_ = thread_record_queue::records_per_segment;
+  size_t resume_backlog_ = 0;
+  logging_overflow overflow_ = logging_overflow::block;
+  std::atomic<uint64_t> dropped_{0};
+
+  std::mutex registry_mutex_;
+  std::vector<std::shared_ptr<thread_record_queue>> registry_;
+  std::atomic<uint64_t> registry_version_{0};
+
+  // Only used by the feeding thread
+  std::vector<std::shared_ptr<thread_record_queue>> feed_queues_;
+  uint64_t feed_version_ = 0;
+  size_t next_queue_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::atomic<bool> feeder_waiting_{false};
+  std::atomic<uint32_t> blocked_producers_{0};
+  bool interrupted_ = false;
+};
+
+const size_t thread_record_queue::records_per_segment;
+const std::chrono::milliseconds bounded_record_queue::feed_interval(10);
+std::atomic<uint64_t> bounded_record_queue::last_id_{0};
+
+typedef sinks::text_ostream_backend text_backend;
+typedef sinks::synchronous_sink<text_backend> text_sink;
+typedef sinks::asynchronous_sink<text_backend, bounded_record_queue>
+    async_text_sink;
+// Exactly one of the two sinks exists while logging is initialized
 static boost::shared_ptr<text_sink> sink;
+static boost::shared_ptr<async_text_sink> async_sink;
+static uint64_t dropped_records = 0;
 
 void set_format(const logging_format format) {
   logging::formatter formatter;
@@ -43,7 +398,11 @@ void set_format(const logging_format format) {
   } else {
     throw std::runtime_error("Unknown logging_format");
   }
-  sink->set_formatter(formatter);
+  if (async_sink) {
+    async_sink->set_formatter(formatter);
+  } else {
+    sink->set_formatter(formatter);
+  }
 }
 
 void set_min_level(const logging_level level) {
@@ -55,8 +414,22 @@ void init_logging() {
   logging::add_common_attributes();
 }
 
+static void init_async_logging(const LoggingSettings &settings) {
+  auto backend = boost::make_shared<text_backend>();
+  backend->add_stream(
+      boost::shared_ptr<std::ostream>(&std::clog, boost::null_deleter()));
+  async_sink = boost::make_shared<async_text_sink>(backend);
+  async_sink->configure(settings.queue_size, settings.overflow);
+  logging::core::get()->add_sink(async_sink);
+  logging::add_common_attributes();
+}
+
 void init_logging(const LoggingSettings settings) {
-  init_logging();
+  if (settings.asynchronous) {
+    init_async_logging(settings);
+  } else {
+    init_logging();
+  }
 
   set_format(settings.format);
   set_min_level(settings.level);
@@ -67,12 +440,37 @@ void init_logging(std::vector<std::string> &command_line) {
 }
 
 void stop_logging() {
-  logging::core::get()->remove_sink(sink);
-  sink.reset();
+  if (async_sink) {
+    // Write out everything queued before the sink goes away
+    logging::core::get()->remove_sink(async_sink);
+    async_sink->stop();
+    async_sink->flush();
+    dropped_records += async_sink->dropped_records();
+    async_sink.reset();
+  } else {
+    logging::core::get()->remove_sink(sink);
+    sink.reset();
+  }
+}
+
+void flush_logging() {
+  if (async_sink) {
+    async_sink->flush();
+  } else if (sink) {
+    sink->flush();
+  }
+}
+
+uint64_t dropped_log_records() {
+  return dropped_records + (async_sink ? async_sink->dropped_records() : 0);
 }
 
 void add_stream(const boost::shared_ptr<std::ostream> &stream) {
-  sink->locked_backend()->add_stream(stream);
+  if (async_sink) {
+    async_sink->locked_backend()->add_stream(stream);
+  } else {
+    sink->locked_backend()->add_stream(stream);
+  }
 }
 
 std::ostream &operator<<(std::ostream &os, const logging_format &f) {
@@ -99,6 +497,30 @@ std::istream &operator>>(std::istream &is, logging_format &f) {
   return is;
 }
 
+std::ostream &operator<<(std::ostream &os, const logging_overflow &o) {
+  if (o == logging_overflow::block) {
+    os << "block";
+  } else if (o == logging_overflow::drop) {
+    os << "drop";
+  } else {
+    throw std::runtime_error("Unknown logging_overflow");
+  }
+  return os;
+}
+
+std::istream &operator>>(std::istream &is, logging_overflow &o) {
+  std::string s = "";
+  is >> s;
+  if (s == "block") {
+    o = logging_overflow::block;
+  } else if (s == "drop") {
+    o = logging_overflow::drop;
+  } else {
+    is.setstate(std::ios_base::failbit);
+  }
+  return is;
+}
+
 LoggingSettings parse_command_line(std::vector<std::string> &command_line) {
   LoggingSettings settings;
 
@@ -110,6 +532,15 @@ LoggingSettings parse_command_line(std::vector<std::string> &command_line) {
   options("logging-level",
           po::value(&settings.level)->default_value(logging_level::info),
           "minimal logging level to print");
+  options("logging-async", po::bool_switch(&settings.asynchronous),
+          "format and write log records on a background thread");
+  options("logging-queue-size",
+          po::value(&settings.queue_size)->default_value(4096),
+          "records each thread may queue for asynchronous logging, 0 for "
+          "unbounded");
+  options("logging-overflow",
+          po::value(&settings.overflow)->default_value(logging_overflow::block),
+          "what a full asynchronous queue does with new records, block/drop");
 
   po::parsed_options parsed = po::command_line_parser(command_line)
                                   .options(desc)
@@ -14,7 +14,10 @@
 #include <boost/program_options.hpp>
 namespace po = boost::program_options;
 
+#include <algorithm>
+#include <cstdio>
 #include <regex>
+#include <thread>
 
 namespace lzt = level_zero_tests;
 
@@ -187,6 +190,102 @@ TEST_F(LoggingInitTest, WarningLevelFromSettings) {
   EXPECT_EQ("[warning] Message\n", logs->str());
 }
 
+TEST_F(LoggingInitTest, AsynchronousLoggingWritesAllRecordsInOrder) {
+  lzt::LoggingSettings settings;
+  settings.format = lzt::logging_format::simple;
+  settings.asynchronous = true;
+  settings.queue_size = 4;
+  settings.overflow = lzt::logging_overflow::block;
+  lzt::init_logging(settings);
+  lzt::add_stream(logs);
+
+  std::stringstream expected;
+  for (int i = 0; i < 100; i++) {
+    LOG_INFO << "Message " << i;
+    expected << "[info] Message " << i << "\n";
+  }
+  lzt::flush_logging();
+  EXPECT_EQ(expected.str(), logs->str());
+}
+
+TEST_F(LoggingInitTest,
+       AsynchronousLoggingWritesEachThreadsRecordsInOrder) {
+  lzt::LoggingSettings settings;
+  settings.format = lzt::logging_format::simple;
+  settings.asynchronous = true;
+  settings.queue_size = 4;
+  settings.overflow = lzt::logging_overflow::block;
+  lzt::init_logging(settings);
+  lzt::add_stream(logs);
+
+  // The threads exit before the flush, with records still queued
+  const int thread_count = 4;
+  const int record_count = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_count; t++) {
+    threads.emplace_back([t]() {
+      for (int i = 0; i < record_count; i++) {
+        LOG_INFO << t << " " << i;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  lzt::flush_logging();
+
+  std::vector<int> next(thread_count, 0);
+  std::string line;
+  while (std::getline(*logs, line)) {
+    int t = 0;
+    int i = 0;
+    ASSERT_EQ(2, std::sscanf(line.c_str(), "[info] %d %d", &t, &i)) << line;
+    ASSERT_LT(t, thread_count);
+    EXPECT_EQ(next[t]++, i);
+  }
+  EXPECT_EQ(std::vector<int>(thread_count, record_count), next);
+}
+
+TEST_F(LoggingInitTest, AsynchronousLoggingDropsRecordsWhenQueueIsFull) {
+  lzt::LoggingSettings settings;
+  settings.format = lzt::logging_format::simple;
+  settings.asynchronous = true;
+  settings.queue_size = 1;
+  settings.overflow = lzt::logging_overflow::drop;
+  const uint64_t dropped_before = lzt::dropped_log_records();
+  lzt::init_logging(settings);
+  lzt::add_stream(logs);
+
+  const int record_count = 10000;
+  for (int i = 0; i < record_count; i++) {
+    LOG_INFO << "Message";
+  }
+  lzt::stop_logging();
+
+  const std::string output = logs->str();
+  const auto written = std::count(output.begin(), output.end(), '\n');
+  const auto dropped = lzt::dropped_log_records() - dropped_before;
+  EXPECT_EQ(record_count, written + dropped);
+}
+
+#pragma push_macro("LZT_LOG_MIN_LEVEL")
+#undef LZT_LOG_MIN_LEVEL
+#define LZT_LOG_MIN_LEVEL 2
+
+TEST_F(LoggingTest, RecordsBelowCompileTimeLevelAreNotEvaluated) {
+  int evaluated = 0;
+  LOG_TRACE << "Message " << evaluated++;
+  LOG_DEBUG << "Message " << evaluated++;
+  EXPECT_EQ(0, evaluated);
+  EXPECT_EQ("", logs->str());
+
+  LOG_INFO << "Message " << evaluated++;
+  EXPECT_EQ(1, evaluated);
+  EXPECT_EQ("[info] Message 0\n", logs->str());
+}
+
+#pragma pop_macro("LZT_LOG_MIN_LEVEL")
+
 TEST(VectorToString, Empty) {
   const std::vector<int> x;
   EXPECT_EQ("[]", lzt::to_string(x));
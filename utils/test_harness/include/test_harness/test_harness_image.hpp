@@ -35,48 +35,6 @@ const auto image_format_types =
                       ZE_IMAGE_FORMAT_TYPE_UNORM, ZE_IMAGE_FORMAT_TYPE_SNORM,
                       ZE_IMAGE_FORMAT_TYPE_FLOAT);
 
-const std::vector<ze_image_format_layout_t> image_format_layout_uint = {
-    ZE_IMAGE_FORMAT_LAYOUT_8,           ZE_IMAGE_FORMAT_LAYOUT_8_8,
-    ZE_IMAGE_FORMAT_LAYOUT_8_8_8_8,     ZE_IMAGE_FORMAT_LAYOUT_16,
-    ZE_IMAGE_FORMAT_LAYOUT_16_16,       ZE_IMAGE_FORMAT_LAYOUT_16_16_16_16,
-    ZE_IMAGE_FORMAT_LAYOUT_32,          ZE_IMAGE_FORMAT_LAYOUT_32_32,
-    ZE_IMAGE_FORMAT_LAYOUT_32_32_32_32, ZE_IMAGE_FORMAT_LAYOUT_10_10_10_2};
-const std::vector<ze_image_format_layout_t> image_format_layout_sint = {
-    ZE_IMAGE_FORMAT_LAYOUT_8,           ZE_IMAGE_FORMAT_LAYOUT_8_8,
-    ZE_IMAGE_FORMAT_LAYOUT_8_8_8_8,     ZE_IMAGE_FORMAT_LAYOUT_16,
-    ZE_IMAGE_FORMAT_LAYOUT_16_16,       ZE_IMAGE_FORMAT_LAYOUT_16_16_16_16,
-    ZE_IMAGE_FORMAT_LAYOUT_32,          ZE_IMAGE_FORMAT_LAYOUT_32_32,
-    ZE_IMAGE_FORMAT_LAYOUT_32_32_32_32, ZE_IMAGE_FORMAT_LAYOUT_10_10_10_2};
-const std::vector<ze_image_format_layout_t> image_format_layout_unorm = {
-    ZE_IMAGE_FORMAT_LAYOUT_8,           ZE_IMAGE_FORMAT_LAYOUT_8_8,
-    ZE_IMAGE_FORMAT_LAYOUT_8_8_8_8,     ZE_IMAGE_FORMAT_LAYOUT_16,
-    ZE_IMAGE_FORMAT_LAYOUT_16_16,       ZE_IMAGE_FORMAT_LAYOUT_16_16_16_16,
-    ZE_IMAGE_FORMAT_LAYOUT_32,          ZE_IMAGE_FORMAT_LAYOUT_32_32,
-    ZE_IMAGE_FORMAT_LAYOUT_32_32_32_32, ZE_IMAGE_FORMAT_LAYOUT_10_10_10_2,
-    ZE_IMAGE_FORMAT_LAYOUT_5_6_5,       ZE_IMAGE_FORMAT_LAYOUT_5_5_5_1,
-    ZE_IMAGE_FORMAT_LAYOUT_4_4_4_4};
-const std::vector<ze_image_format_layout_t> image_format_layout_snorm = {
-    ZE_IMAGE_FORMAT_LAYOUT_8,           ZE_IMAGE_FORMAT_LAYOUT_8_8,
-    ZE_IMAGE_FORMAT_LAYOUT_8_8_8_8,     ZE_IMAGE_FORMAT_LAYOUT_16,
-    ZE_IMAGE_FORMAT_LAYOUT_16_16,       ZE_IMAGE_FORMAT_LAYOUT_16_16_16_16,
-    ZE_IMAGE_FORMAT_LAYOUT_32,          ZE_IMAGE_FORMAT_LAYOUT_32_32,
-    ZE_IMAGE_FORMAT_LAYOUT_32_32_32_32, ZE_IMAGE_FORMAT_LAYOUT_10_10_10_2};
-const std::vector<ze_image_format_layout_t> image_format_layout_float = {
-    ZE_IMAGE_FORMAT_LAYOUT_16,          ZE_IMAGE_FORMAT_LAYOUT_16_16,
-    ZE_IMAGE_FORMAT_LAYOUT_16_16_16_16, ZE_IMAGE_FORMAT_LAYOUT_32,
-    ZE_IMAGE_FORMAT_LAYOUT_32_32,       ZE_IMAGE_FORMAT_LAYOUT_32_32_32_32,
-    ZE_IMAGE_FORMAT_LAYOUT_10_10_10_2,  ZE_IMAGE_FORMAT_LAYOUT_11_11_10};
-
-const std::vector<ze_image_format_layout_t> image_format_media_layouts = {
-    ZE_IMAGE_FORMAT_LAYOUT_Y8,   ZE_IMAGE_FORMAT_LAYOUT_NV12,
-    ZE_IMAGE_FORMAT_LAYOUT_YUYV, ZE_IMAGE_FORMAT_LAYOUT_VYUY,
-    ZE_IMAGE_FORMAT_LAYOUT_YVYU, ZE_IMAGE_FORMAT_LAYOUT_UYVY,
-    ZE_IMAGE_FORMAT_LAYOUT_AYUV, ZE_IMAGE_FORMAT_LAYOUT_YUAV,
-    ZE_IMAGE_FORMAT_LAYOUT_P010, ZE_IMAGE_FORMAT_LAYOUT_Y410,
-    ZE_IMAGE_FORMAT_LAYOUT_P012, ZE_IMAGE_FORMAT_LAYOUT_Y16,
-    ZE_IMAGE_FORMAT_LAYOUT_P016, ZE_IMAGE_FORMAT_LAYOUT_Y216,
-    ZE_IMAGE_FORMAT_LAYOUT_P216, ZE_IMAGE_FORMAT_LAYOUT_P416};
-
 const std::vector<ze_image_format_swizzle_t> image_format_swizzles_all = {
     ZE_IMAGE_FORMAT_SWIZZLE_R, ZE_IMAGE_FORMAT_SWIZZLE_G,
     ZE_IMAGE_FORMAT_SWIZZLE_B, ZE_IMAGE_FORMAT_SWIZZLE_A,
@@ -96,8 +54,12 @@ void destroy_ze_image(ze_image_handle_t image);
 
 ze_image_properties_t get_ze_image_properties(ze_image_desc_t image_descriptor);
 
-void copy_image_from_mem(lzt::ImagePNG32Bit input, ze_image_handle_t output);
-void copy_image_to_mem(ze_image_handle_t input, lzt::ImagePNG32Bit output);
+// Host image backed by USM host memory, which image copies read and write
+// in place; the memory is freed with the image
+lzt::ImagePNG32Bit create_host_image(const int width, const int height);
+void copy_image_from_mem(const lzt::ImagePNG32Bit &input,
+                         ze_image_handle_t output);
+void copy_image_to_mem(ze_image_handle_t input, lzt::ImagePNG32Bit &output);
 
 class zeImageCreateCommon {
 public:
@@ -12,11 +12,22 @@
 #include "utils/utils.hpp"
 #include <level_zero/ze_api.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace lzt = level_zero_tests;
 
 namespace level_zero_tests {
 
-void copy_image_from_mem(lzt::ImagePNG32Bit input, ze_image_handle_t output) {
+lzt::ImagePNG32Bit create_host_image(const int width, const int height) {
+  auto memory = static_cast<uint32_t *>(lzt::allocate_host_memory(
+      static_cast<size_t>(width) * height * sizeof(uint32_t)));
+  return lzt::ImagePNG32Bit(width, height, memory,
+                            [](uint32_t *p) { lzt::free_memory(p); });
+}
+
+void copy_image_from_mem(const lzt::ImagePNG32Bit &input,
+                         ze_image_handle_t output) {
 
   auto command_list = lzt::create_command_list();
   EXPECT_EQ(ZE_RESULT_SUCCESS,
@@ -31,7 +42,7 @@ void copy_image_from_mem(lzt::ImagePNG32Bit input, ze_image_handle_t output) {
   lzt::destroy_command_list(command_list);
 }
 
-void copy_image_to_mem(ze_image_handle_t input, lzt::ImagePNG32Bit output) {
+void copy_image_to_mem(ze_image_handle_t input, lzt::ImagePNG32Bit &output) {
 
   auto command_list = lzt::create_command_list();
   EXPECT_EQ(ZE_RESULT_SUCCESS,
@@ -221,9 +232,80 @@ void write_image_data_pattern(lzt::ImagePNG32Bit &image, int8_t dp) {
                            image.height());
 }
 
-static inline uint32_t get_pixel(const uint32_t *image, int x, int y,
-                                 int row_width) {
-  return image[y * row_width + x];
+// Only the first few mismatching pixels of a failed comparison are logged
+static const size_t max_logged_mismatches = 16;
+
+struct pixel_mismatch {
+  int x1, y1, x2, y2;
+  uint32_t pixel1, pixel2;
+};
+
+struct compare_result {
+  int errCnt = 0;
+  std::vector<pixel_mismatch> mismatches;
+};
+
+// Moves the r, g, b and a channels of a pixel into fixed byte positions, so
+// two pixels in different swizzles can be compared with a single integer
+// compare. Channels without a position in both formats are masked out.
+struct channel_shuffle {
+  uint32_t shift[4];
+  uint32_t mask[4];
+
+  inline uint32_t apply(uint32_t pixel) const {
+    return (((pixel >> shift[0]) & mask[0]) << 0) |
+           (((pixel >> shift[1]) & mask[1]) << 8) |
+           (((pixel >> shift[2]) & mask[2]) << 16) |
+           (((pixel >> shift[3]) & mask[3]) << 24);
+  }
+};
+
+// Compares count pixels of two rows. The common case of identical rows is
+// settled by memcmp; rows that differ are counted without branching and only
+// walked again to record the first mismatches.
+static void compare_row(const uint32_t *row1, const uint32_t *row2, int count,
+                        const channel_shuffle *shuffle1,
+                        const channel_shuffle *shuffle2, int x1, int y1,
+                        int x2, int y2, compare_result &result) {
+  if (count <= 0)
+    return;
+  if (shuffle1 == nullptr &&
+      std::memcmp(row1, row2, count * sizeof(uint32_t)) == 0)
+    return;
+
+  int errors = 0;
+  if (shuffle1 == nullptr) {
+    for (int i = 0; i < count; i++)
+      errors += (row1[i] != row2[i]);
+  } else {
+    for (int i = 0; i < count; i++)
+      errors += (shuffle1->apply(row1[i]) != shuffle2->apply(row2[i]));
+  }
+  result.errCnt += errors;
+
+  for (int i = 0; errors && (i < count) &&
+                  (result.mismatches.size() < max_logged_mismatches);
+       i++) {
+    uint32_t pixel1 = shuffle1 ? shuffle1->apply(row1[i]) : row1[i];
+    uint32_t pixel2 = shuffle2 ? shuffle2->apply(row2[i]) : row2[i];
+    if (pixel1 != pixel2)
+      result.mismatches.push_back({x1 + i, y1, x2 + i, y2, row1[i], row2[i]});
+  }
+}
+
+static int report_compare_result(const compare_result &result) {
+  if (result.errCnt) {
+    LOG_WARNING << "image compare found " << std::dec << result.errCnt
+                << " mismatching pixels, first " << result.mismatches.size()
+                << ":";
+    for (auto &mismatch : result.mismatches) {
+      LOG_WARNING << " x1: " << std::dec << mismatch.x1
+                  << " y1: " << mismatch.y1 << " x2: " << mismatch.x2
+                  << " y2: " << mismatch.y2 << " pixel1: 0x" << std::hex
+                  << mismatch.pixel1 << " pixel2: 0x" << mismatch.pixel2;
+    }
+  }
+  return result.errCnt;
 }
 
 int compare_data_pattern(const lzt::ImagePNG32Bit &imagepng1,
@@ -237,15 +319,6 @@ int compare_data_pattern(const lzt::ImagePNG32Bit &imagepng1,
                               height1, origin2X, origin2Y, width2, height2);
 }
 
-static void decompose_pixel(uint32_t pixel, int8_t &r, uint8_t r_idx, int8_t &g,
-                            uint8_t g_idx, int8_t &b, uint8_t b_idx, int8_t &a,
-                            uint8_t a_idx) {
-  r = (pixel >> r_idx) & 0xff;
-  g = (pixel >> g_idx) & 0xff;
-  b = (pixel >> b_idx) & 0xff;
-  a = (pixel >> a_idx) & 0xff;
-}
-
 // Returns number of errors found, color order for both images are
 // define in the image_format parameters:
 int compare_data_pattern(const lzt::ImagePNG32Bit &imagepng1,
@@ -254,59 +327,58 @@ int compare_data_pattern(const lzt::ImagePNG32Bit &imagepng1,
                          const ze_image_format_desc_t &image2_format,
                          int origin1X, int origin1Y, int width1, int height1,
                          int origin2X, int origin2Y, int width2, int height2) {
-  uint8_t r1_idx = lookup_idx(ZE_IMAGE_FORMAT_SWIZZLE_R, image1_format);
-  uint8_t g1_idx = lookup_idx(ZE_IMAGE_FORMAT_SWIZZLE_G, image1_format);
-  uint8_t b1_idx = lookup_idx(ZE_IMAGE_FORMAT_SWIZZLE_B, image1_format);
-  uint8_t a1_idx = lookup_idx(ZE_IMAGE_FORMAT_SWIZZLE_A, image1_format);
-  uint8_t r2_idx = lookup_idx(ZE_IMAGE_FORMAT_SWIZZLE_R, image2_format);
-  uint8_t g2_idx = lookup_idx(ZE_IMAGE_FORMAT_SWIZZLE_G, image2_format);
-  uint8_t b2_idx = lookup_idx(ZE_IMAGE_FORMAT_SWIZZLE_B, image2_format);
-  uint8_t a2_idx = lookup_idx(ZE_IMAGE_FORMAT_SWIZZLE_A, image2_format);
-
-  const bool must_decompose_colors = (r1_idx != r2_idx) || (g1_idx != g2_idx) ||
-                                     (b1_idx != b2_idx) || (a1_idx != a2_idx);
+  const ze_image_format_swizzle_t channels[4] = {
+      ZE_IMAGE_FORMAT_SWIZZLE_R, ZE_IMAGE_FORMAT_SWIZZLE_G,
+      ZE_IMAGE_FORMAT_SWIZZLE_B, ZE_IMAGE_FORMAT_SWIZZLE_A};
+  channel_shuffle shuffle1, shuffle2;
+  bool must_decompose_colors = false;
+
+  for (int c = 0; c < 4; c++) {
+    uint8_t idx1 = lookup_idx(channels[c], image1_format);
+    uint8_t idx2 = lookup_idx(channels[c], image2_format);
+    bool known = (idx1 != UNKNOWN_IDX) && (idx2 != UNKNOWN_IDX);
+
+    must_decompose_colors = must_decompose_colors || (idx1 != idx2);
+    shuffle1.shift[c] = known ? idx1 : 0;
+    shuffle2.shift[c] = known ? idx2 : 0;
+    shuffle1.mask[c] = shuffle2.mask[c] = known ? 0xff : 0;
+  }
+
+  // Pixels at negative coordinates are skipped, and rows are addressed with
+  // the region width as the stride, as the callers pass full image regions
+  int skipX = std::max(0, std::max(-origin1X, -origin2X));
+  int skipY = std::max(0, std::max(-origin1Y, -origin2Y));
+  int columns = std::min(width1, width2) - skipX;
+  int rows = std::min(height1, height2);
+
   const uint32_t *image1 = imagepng1.raw_data();
   const uint32_t *image2 = imagepng2.raw_data();
-  int errCnt = 0, successCnt = 0;
-  for (int y1 = origin1Y, y2 = origin2Y;
-       (y1 < (origin1Y + height1)) && (y2 < (origin2Y + height2)); y1++, y2++) {
-    for (int x1 = origin1X, x2 = origin2X;
-         (x1 < (origin1X + width1)) && (x2 < (origin2X + width2)); x1++, x2++) {
-      if (x1 < 0 || y1 < 0 || x2 < 0 || y2 < 0)
-        continue;
-
-      uint32_t pixel1 = get_pixel(image1, x1, y1, width1);
-      uint32_t pixel2 = get_pixel(image2, x2, y2, width2);
-      bool correct;
-      if (must_decompose_colors) {
-        int8_t r1, g1, b1, a1;
-        int8_t r2, g2, b2, a2;
-        decompose_pixel(pixel1, r1, r1_idx, g1, g1_idx, b1, b1_idx, a1, a1_idx);
-        decompose_pixel(pixel2, r2, r2_idx, g2, g2_idx, b2, b2_idx, a2, a2_idx);
-        if ((r1 != r2) || (g1 != g2) || (b1 != b2) || (a1 != a2)) {
-          correct = false;
-        } else {
-          correct = true;
-        }
-      } else {
-        if (pixel1 != pixel2) {
-          correct = false;
-        } else {
-          correct = true;
-        }
-      }
-      if (!correct) {
-        LOG_DEBUG << "errCnt: " << errCnt << " successCnt: " << successCnt
-                  << " x1: " << x1 << " y1: " << y1 << " x2: " << x2
-                  << " y2: " << y2 << " pixel1: 0x" << std::hex << pixel1
-                  << " pixel2: 0x" << pixel2;
-        errCnt++;
-      } else {
-        successCnt++;
-      }
-    }
+  compare_result result;
+  for (int row = skipY; row < rows; row++) {
+    int x1 = origin1X + skipX, y1 = origin1Y + row;
+    int x2 = origin2X + skipX, y2 = origin2Y + row;
+    compare_row(&image1[y1 * width1 + x1], &image2[y2 * width2 + x2], columns,
+                must_decompose_colors ? &shuffle1 : nullptr,
+                must_decompose_colors ? &shuffle2 : nullptr, x1, y1, x2, y2,
+                result);
   }
-  return errCnt;
+  return report_compare_result(result);
+}
+
+// Compares the columns [begin, end) of one row of image against the same
+// pixels of expected. Pixels expected does not cover are counted as errors.
+static void compare_span(const lzt::ImagePNG32Bit &image,
+                         const lzt::ImagePNG32Bit &expected, int row,
+                         int begin, int end, compare_result &result) {
+  int covered_end =
+      (row < expected.height()) ? std::min(end, expected.width()) : begin;
+  covered_end = std::max(covered_end, begin);
+
+  compare_row(&image.raw_data()[row * image.width() + begin],
+              &expected.raw_data()[row * expected.width() + begin],
+              covered_end - begin, nullptr, nullptr, begin, row, begin, row,
+              result);
+  result.errCnt += end - covered_end;
 }
 
 int compare_data_pattern(
@@ -322,46 +394,32 @@ int compare_data_pattern(
   if (region == nullptr) {
     region = &full_image_region;
   }
-  int errCnt = 0;
-  LOG_DEBUG << "region: originX: " << region->originX
-            << " originY: " << region->originY
-            << " originZ: " << region->originZ << " width: " << region->width
-            << " height: " << region->height << std::endl;
-  for (unsigned row = 0; row < image.height(); row++) {
-    for (unsigned column = 0; column < image.width(); column++) {
-      uint32_t pixel = image.get_pixel(column, row);
-      const lzt::ImagePNG32Bit *expected_image;
-      LOG_DEBUG << "row: " << row << " and column: " << column
-                << " corresponds to the ";
-      if ((row >= region->originY &&
-           row < (region->originY + region->height)) &&
-          (column >= region->originX &&
-           column < (region->originX + region->width))) {
-        // The pixel is expected to be in the foreground image:
-        LOG_DEBUG << "foreground." << std::endl;
-        expected_image = &expected_fg;
-      } else {
-        // The pixel is expected to be in the background image:
-        LOG_DEBUG << "background." << std::endl;
-        expected_image = &expected_bg;
-      }
-      if (row > expected_image->height() || column > expected_image->width()) {
-        LOG_DEBUG << "expected image does not have a pixel for row: " << row
-                  << " and column: " << column << std::endl;
-        errCnt++;
-      } else {
-        if (pixel != expected_image->get_pixel(column, row)) {
-          LOG_DEBUG << "image's pixel: " << pixel
-                    << " does not match expected image's pixel: "
-                    << expected_image->get_pixel(column, row)
-                    << " for row: " << row << " and column: " << column
-                    << std::endl;
-          errCnt++;
-        }
-      }
+
+  // Every row splits into at most three spans: background left of the
+  // region, foreground inside it and background right of it
+  int width = image.width();
+  int fg_begin = std::min<int>(region->originX, width);
+  int fg_end = std::min<int>(region->originX + region->width, width);
+  compare_result result;
+  for (int row = 0; row < image.height(); row++) {
+    if ((uint32_t(row) >= region->originY) &&
+        (uint32_t(row) < region->originY + region->height)) {
+      compare_span(image, expected_bg, row, 0, fg_begin, result);
+      compare_span(image, expected_fg, row, fg_begin, fg_end, result);
+      compare_span(image, expected_bg, row, fg_end, width, result);
+    } else {
+      compare_span(image, expected_bg, row, 0, width, result);
     }
   }
-  return errCnt;
+
+  if (result.errCnt) {
+    LOG_WARNING << "region: originX: " << region->originX
+                << " originY: " << region->originY
+                << " originZ: " << region->originZ
+                << " width: " << region->width
+                << " height: " << region->height;
+  }
+  return report_compare_result(result);
 }
 
 }; // namespace level_zero_tests
@@ -7,6 +7,7 @@
  */
 
 #include "test_harness/test_harness.hpp"
+#include "usm_pool/usm_pool.hpp"
 #include "gtest/gtest.h"
 
 namespace lzt = level_zero_tests;
@@ -28,6 +29,15 @@ void *allocate_host_memory(const size_t size, const size_t alignment) {
 void *allocate_host_memory(const size_t size, const size_t alignment,
                            const ze_driver_handle_t driver) {
 
+  if (usm_pool_requested()) {
+    void *memory = get_usm_pool(ZE_MEMORY_TYPE_HOST, driver, nullptr, 0,
+                                ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT,
+                                ZE_HOST_MEM_ALLOC_FLAG_DEFAULT)
+                       .allocate(size, alignment);
+    EXPECT_NE(nullptr, memory);
+    return memory;
+  }
+
   ze_host_mem_alloc_desc_t host_desc;
   host_desc.flags = ZE_HOST_MEM_ALLOC_FLAG_DEFAULT;
   host_desc.version = ZE_HOST_MEM_ALLOC_DESC_VERSION_CURRENT;
@@ -70,6 +80,14 @@ void *allocate_device_memory(const size_t size, const size_t alignment,
                              const uint32_t ordinal,
                              ze_device_handle_t device_handle,
                              ze_driver_handle_t driver) {
+  if (usm_pool_requested()) {
+    void *memory = get_usm_pool(ZE_MEMORY_TYPE_DEVICE, driver, device_handle,
+                                ordinal, flags, ZE_HOST_MEM_ALLOC_FLAG_DEFAULT)
+                       .allocate(size, alignment);
+    EXPECT_NE(nullptr, memory);
+    return memory;
+  }
+
   void *memory = nullptr;
   ze_device_mem_alloc_desc_t device_desc;
   device_desc.ordinal = ordinal;
@@ -122,6 +140,14 @@ void *allocate_shared_memory(const size_t size, const size_t alignment,
 
   uint32_t ordinal = 0;
 
+  if (usm_pool_requested()) {
+    void *memory = get_usm_pool(ZE_MEMORY_TYPE_SHARED, driver, device, ordinal,
+                                dev_flags, host_flags)
+                       .allocate(size, alignment);
+    EXPECT_NE(nullptr, memory);
+    return memory;
+  }
+
   void *memory = nullptr;
   ze_device_mem_alloc_desc_t device_desc;
   device_desc.ordinal = ordinal;
@@ -160,6 +186,8 @@ void free_memory(const void *ptr) {
 }
 
 void free_memory(ze_driver_handle_t driver, const void *ptr) {
+  if (usm_pool_requested() && usm_pool_free(ptr))
+    return;
   EXPECT_EQ(ZE_RESULT_SUCCESS, zeDriverFreeMem(driver, (void *)ptr));
 }
 
@@ -13,6 +13,12 @@
 #include "gtest/gtest.h"
 #include "test_harness_sysman_init.hpp"
 
+#include <functional>
+#include <future>
+
+#define SYSMAN_WAIT_INITIAL_BACKOFF_MSEC 1
+#define SYSMAN_WAIT_MAX_BACKOFF_MSEC 128
+
 namespace level_zero_tests {
 
 zet_sysman_event_handle_t get_event_handle(zet_device_handle_t device);
@@ -29,6 +35,34 @@ ze_result_t listen_event(ze_driver_handle_t hDriver, uint32_t timeout,
                          uint32_t count, zet_sysman_event_handle_t *phEvents,
                          uint32_t *pEvents);
 
+// Polls condition with exponential backoff until it returns true or
+// timeout_msec expires. Returns the last value of condition.
+bool wait_for_condition(std::function<bool()> condition,
+                        uint32_t timeout_msec);
+
+std::future<bool> wait_for_condition_async(std::function<bool()> condition,
+                                           uint32_t timeout_msec);
+
+// Waits until any event in event_mask is set on hEvent, returning as soon as
+// it is delivered. The matching events are cleared and returned, 0 on
+// timeout. timeout_msec may be ZET_EVENT_WAIT_INFINITE.
+uint32_t wait_for_events(ze_driver_handle_t hDriver,
+                         zet_sysman_event_handle_t hEvent, uint32_t event_mask,
+                         uint32_t timeout_msec);
+
+std::future<uint32_t> wait_for_events_async(ze_driver_handle_t hDriver,
+                                            zet_sysman_event_handle_t hEvent,
+                                            uint32_t event_mask,
+                                            uint32_t timeout_msec);
+
+// Invokes callback with the received events (0 on timeout) from a worker
+// thread; the returned future completes once the callback has run.
+std::future<void>
+wait_for_events_async(ze_driver_handle_t hDriver,
+                      zet_sysman_event_handle_t hEvent, uint32_t event_mask,
+                      uint32_t timeout_msec,
+                      std::function<void(uint32_t events)> callback);
+
 } // namespace level_zero_tests
 
 #endif
@@ -13,7 +13,6 @@
 #include "gtest/gtest.h"
 #include "test_harness_sysman_init.hpp"
 
-#define IDLE_WAIT_TIMESTEP_MSEC 250
 #define IDLE_WAIT_TIMEOUT_MSEC 2500
 namespace level_zero_tests {
 
@@ -6,6 +6,9 @@
  *
  */
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
 #include "test_harness/test_harness.hpp"
 
 #include <level_zero/ze_api.h>
@@ -49,4 +52,89 @@ ze_result_t listen_event(ze_driver_handle_t hDriver, uint32_t timeout,
   return result;
 }
 
+bool wait_for_condition(std::function<bool()> condition,
+                        uint32_t timeout_msec) {
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(timeout_msec);
+  std::chrono::milliseconds backoff(SYSMAN_WAIT_INITIAL_BACKOFF_MSEC);
+
+  /* Check often right away so fast transitions are picked up early, then
+   * back off so slow ones do not burn the cpu */
+  while (!condition()) {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline)
+      return false;
+    auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+    std::this_thread::sleep_for(
+        std::min(backoff, remaining + std::chrono::milliseconds(1)));
+    backoff = std::min(backoff * 2, std::chrono::milliseconds(
+                                        SYSMAN_WAIT_MAX_BACKOFF_MSEC));
+  }
+  return true;
+}
+
+std::future<bool> wait_for_condition_async(std::function<bool()> condition,
+                                           uint32_t timeout_msec) {
+  return std::async(std::launch::async, wait_for_condition, condition,
+                    timeout_msec);
+}
+
+uint32_t wait_for_events(ze_driver_handle_t hDriver,
+                         zet_sysman_event_handle_t hEvent, uint32_t event_mask,
+                         uint32_t timeout_msec) {
+  bool infinite = (timeout_msec == ZET_EVENT_WAIT_INFINITE);
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(infinite ? 0 : timeout_msec);
+  uint32_t backoff = SYSMAN_WAIT_INITIAL_BACKOFF_MSEC;
+  uint32_t events = 0;
+
+  /* Events that fired before we started listening are latched in the event
+   * state, so check it first and after every listen slice. The listen call
+   * itself returns as soon as an event is delivered */
+  while (true) {
+    events = 0;
+    if (zetSysmanEventGetState(hEvent, false, &events) != ZE_RESULT_SUCCESS)
+      return 0;
+    if (events & event_mask) {
+      EXPECT_EQ(ZE_RESULT_SUCCESS,
+                zetSysmanEventGetState(hEvent, true, &events));
+      return events & event_mask;
+    }
+
+    uint32_t slice = backoff;
+    if (!infinite) {
+      auto now = std::chrono::steady_clock::now();
+      if (now >= deadline)
+        return 0;
+      uint32_t remaining = static_cast<uint32_t>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now)
+              .count());
+      slice = std::min(slice, remaining + 1);
+    }
+
+    uint32_t pending = 0;
+    zetSysmanEventListen(hDriver, slice, 1, &hEvent, &pending);
+    backoff = std::min(backoff * 2, (uint32_t)SYSMAN_WAIT_MAX_BACKOFF_MSEC);
+  }
+}
+
+std::future<uint32_t> wait_for_events_async(ze_driver_handle_t hDriver,
+                                            zet_sysman_event_handle_t hEvent,
+                                            uint32_t event_mask,
+                                            uint32_t timeout_msec) {
+  return std::async(std::launch::async, wait_for_events, hDriver, hEvent,
+                    event_mask, timeout_msec);
+}
+
+std::future<void>
+wait_for_events_async(ze_driver_handle_t hDriver,
+                      zet_sysman_event_handle_t hEvent, uint32_t event_mask,
+                      uint32_t timeout_msec,
+                      std::function<void(uint32_t events)> callback) {
+  return std::async(std::launch::async, [=]() {
+    callback(wait_for_events(hDriver, hEvent, event_mask, timeout_msec));
+  });
+}
+
 } // namespace level_zero_tests
\ No newline at end of file
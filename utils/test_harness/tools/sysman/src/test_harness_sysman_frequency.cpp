@@ -6,8 +6,6 @@
  *
  */
 
-#include <chrono>
-#include <thread>
 #include "test_harness/test_harness.hpp"
 
 #include <level_zero/ze_api.h>
@@ -119,31 +117,25 @@ void validate_freq_state(zet_sysman_freq_handle_t pFreqHandle,
 }
 
 void idle_check(zet_sysman_freq_handle_t pFreqHandle) {
-  int wait = 0;
+  zet_freq_properties_t property = get_freq_properties(pFreqHandle);
 
   /* Monitor frequencies until cur settles down to min, which should
    * happen within the allotted time */
-  do {
-    zet_freq_properties_t property = get_freq_properties(pFreqHandle);
-    zet_freq_state_t state = get_freq_state(pFreqHandle);
-    validate_freq_state(pFreqHandle, state);
-    if (state.actual == property.min)
-      break;
-    std::this_thread::sleep_for(
-        std::chrono::microseconds(1000 * IDLE_WAIT_TIMESTEP_MSEC));
-    wait += IDLE_WAIT_TIMESTEP_MSEC;
-  } while (wait < IDLE_WAIT_TIMEOUT_MSEC);
+  wait_for_condition(
+      [&]() {
+        zet_freq_state_t state = get_freq_state(pFreqHandle);
+        validate_freq_state(pFreqHandle, state);
+        return state.actual == property.min;
+      },
+      IDLE_WAIT_TIMEOUT_MSEC);
 }
 bool check_for_throttling(zet_sysman_freq_handle_t pFreqHandle) {
-  int wait = 0;
-  do {
-    zet_freq_state_t state = get_freq_state(pFreqHandle);
-    if (state.throttleReasons != ZET_FREQ_THROTTLE_REASONS_NONE)
-      return true;
-    std::this_thread::sleep_for(std::chrono::microseconds(1000 * 10));
-    wait += 10;
-  } while (wait < (IDLE_WAIT_TIMEOUT_MSEC * 2));
-  return false;
+  return wait_for_condition(
+      [&]() {
+        zet_freq_state_t state = get_freq_state(pFreqHandle);
+        return state.throttleReasons != ZET_FREQ_THROTTLE_REASONS_NONE;
+      },
+      IDLE_WAIT_TIMEOUT_MSEC * 2);
 }
 zet_freq_throttle_time_t
 get_throttle_time(zet_sysman_freq_handle_t pFreqHandle) {
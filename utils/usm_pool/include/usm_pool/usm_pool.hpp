@@ -0,0 +1,164 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef level_zero_tests_USM_POOL_HPP
+#define level_zero_tests_USM_POOL_HPP
+
+#include <level_zero/ze_api.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace level_zero_tests {
+
+// Where a UsmPool gets its memory from. allocate returns nullptr on failure.
+class UsmBackend {
+public:
+  virtual ~UsmBackend() = default;
+  virtual void *allocate(size_t size, size_t alignment) = 0;
+  virtual void free(void *ptr) = 0;
+};
+
+// Allocates one kind of USM memory from the driver.
+class ZeUsmBackend : public UsmBackend {
+public:
+  ZeUsmBackend(ze_memory_type_t type, ze_driver_handle_t driver,
+               ze_device_handle_t device, uint32_t ordinal,
+               ze_device_mem_alloc_flag_t device_flags,
+               ze_host_mem_alloc_flag_t host_flags);
+  void *allocate(size_t size, size_t alignment) override;
+  void free(void *ptr) override;
+
+private:
+  ze_memory_type_t type_;
+  ze_driver_handle_t driver_;
+  ze_device_handle_t device_;
+  ze_device_mem_alloc_desc_t device_desc_;
+  ze_host_mem_alloc_desc_t host_desc_;
+};
+
+struct UsmPoolSettings {
+  // Smallest size class, every size class is a power of two from here
+  size_t min_block_size = 64;
+  // Larger requests, or alignments that are not a power of two, go
+  // straight to the backend
+  size_t max_block_size = 1 << 20;
+  // Size of the blocks each size class is carved out of, at least
+  // max_block_size
+  size_t chunk_size = 2 << 20;
+  // Free blocks each thread keeps per size class before returning half of
+  // them to the shared free lists
+  size_t thread_cache_blocks = 16;
+};
+
+struct UsmPoolStatistics {
+  // Allocations served from a free list without calling the backend
+  uint64_t hits = 0;
+  // Allocations that called the backend, for a new chunk or a large block
+  uint64_t misses = 0;
+  // Free bytes held in chunks, ready to be handed out
+  uint64_t bytes_cached = 0;
+  // Bytes currently allocated from the backend, and the most ever
+  uint64_t bytes_reserved = 0;
+  uint64_t peak_bytes_reserved = 0;
+};
+
+// A caching allocator in front of a UsmBackend. Small requests are rounded
+// up to a power of two size class, at least their alignment, and carved out
+// of chunks aligned to that size class, so every block is aligned to its own
+// size. Freed blocks go to a per-thread cache first, then to free lists
+// shared by all threads. Chunks are only returned to the backend by trim(),
+// once none of their blocks are in use, or when the pool is destroyed.
+class UsmPool {
+public:
+  explicit UsmPool(std::unique_ptr<UsmBackend> backend,
+                   const UsmPoolSettings &settings = UsmPoolSettings());
+  ~UsmPool();
+  UsmPool(const UsmPool &) = delete;
+  UsmPool &operator=(const UsmPool &) = delete;
+
+  void *allocate(size_t size, size_t alignment);
+  // Returns false, without freeing anything, for pointers this pool did
+  // not allocate
+  bool free(void *ptr);
+  bool owns(const void *ptr) const;
+  // Returns every chunk without blocks in use to the backend
+  void trim();
+  UsmPoolStatistics statistics() const;
+
+private:
+  struct Chunk {
+    void *base;
+    size_t index;
+  };
+  struct Block {
+    void *ptr;
+    Chunk *chunk; // nullptr for large blocks allocated directly
+    size_t size;
+  };
+  typedef std::vector<Block> FreeList;
+  struct ThreadCache {
+    std::mutex mutex;
+    std::vector<FreeList> free_blocks;
+  };
+  struct LiveShard {
+    mutable std::mutex mutex;
+    std::unordered_map<const void *, Block> blocks;
+  };
+  static const size_t live_shard_count = 16;
+
+  size_t size_class_index(size_t size, size_t alignment) const;
+  size_t size_class(size_t index) const;
+  ThreadCache &thread_cache();
+  bool pop_shared(size_t index, Block &block, bool &missed);
+  bool add_chunk(size_t index);
+  void push_shared(FreeList &blocks);
+  void add_reserved(uint64_t size);
+  LiveShard &shard(const void *ptr) const;
+
+  std::unique_ptr<UsmBackend> backend_;
+  UsmPoolSettings settings_;
+  size_t class_count_;
+  uint64_t id_;
+
+  std::mutex mutex_; // guards free_blocks_, chunks_ and caches_
+  std::vector<FreeList> free_blocks_;
+  std::vector<std::unique_ptr<Chunk>> chunks_;
+  std::vector<std::unique_ptr<ThreadCache>> caches_;
+  mutable LiveShard live_[live_shard_count];
+
+  std::atomic<uint64_t> hits_;
+  std::atomic<uint64_t> misses_;
+  std::atomic<uint64_t> bytes_cached_;
+  std::atomic<uint64_t> bytes_reserved_;
+  std::atomic<uint64_t> peak_bytes_reserved_;
+};
+
+// True when the LZT_USM_POOL environment variable is set to 1, asking the
+// test harness and the benchmarks to allocate through shared UsmPools
+bool usm_pool_requested();
+
+// The process wide pool for one kind of driver allocation, created on first
+// use. These are what the test harness and ZeApp allocate from.
+UsmPool &get_usm_pool(ze_memory_type_t type, ze_driver_handle_t driver,
+                      ze_device_handle_t device, uint32_t ordinal,
+                      ze_device_mem_alloc_flag_t device_flags,
+                      ze_host_mem_alloc_flag_t host_flags);
+// Frees ptr if one of the process wide pools allocated it
+bool usm_pool_free(const void *ptr);
+// Trims every process wide pool
+void trim_usm_pools();
+
+} // namespace level_zero_tests
+
+#endif
@@ -0,0 +1,408 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "usm_pool/usm_pool.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <tuple>
+
+namespace level_zero_tests {
+
+namespace {
+
+bool is_power_of_two(size_t value) { return value && !(value & (value - 1)); }
+
+size_t round_up_power_of_two(size_t value) {
+  size_t result = 1;
+  while (result < value)
+    result <<= 1;
+  return result;
+}
+
+size_t log2_of_power_of_two(size_t value) {
+  size_t result = 0;
+  while (value > 1) {
+    value >>= 1;
+    result++;
+  }
+  return result;
+}
+
+// Pool ids are never reused, so a thread's cache entry for a destroyed pool
+// can never be found again
+std::atomic<uint64_t> next_pool_id(1);
+
+} // namespace
+
+ZeUsmBackend::ZeUsmBackend(ze_memory_type_t type, ze_driver_handle_t driver,
+                           ze_device_handle_t device, uint32_t ordinal,
+                           ze_device_mem_alloc_flag_t device_flags,
+                           ze_host_mem_alloc_flag_t host_flags)
+    : type_(type), driver_(driver), device_(device) {
+  device_desc_.version = ZE_DEVICE_MEM_ALLOC_DESC_VERSION_CURRENT;
+  device_desc_.ordinal = ordinal;
+  device_desc_.flags = device_flags;
+  host_desc_.version = ZE_HOST_MEM_ALLOC_DESC_VERSION_CURRENT;
+  host_desc_.flags = host_flags;
+}
+
+void *ZeUsmBackend::allocate(size_t size, size_t alignment) {
+  void *ptr = nullptr;
+  ze_result_t result = ZE_RESULT_SUCCESS;
+
+  switch (type_) {
+  case ZE_MEMORY_TYPE_HOST:
+    result = zeDriverAllocHostMem(driver_, &host_desc_, size, alignment, &ptr);
+    break;
+  case ZE_MEMORY_TYPE_DEVICE:
+    result = zeDriverAllocDeviceMem(driver_, &device_desc_, size, alignment,
+                                    device_, &ptr);
+    break;
+  case ZE_MEMORY_TYPE_SHARED:
+    result = zeDriverAllocSharedMem(driver_, &device_desc_, &host_desc_, size,
+                                    alignment, device_, &ptr);
+    break;
+  default:
+    return nullptr;
+  }
+  return (result == ZE_RESULT_SUCCESS) ? ptr : nullptr;
+}
+
+void ZeUsmBackend::free(void *ptr) { zeDriverFreeMem(driver_, ptr); }
+
+UsmPool::UsmPool(std::unique_ptr<UsmBackend> backend,
+                 const UsmPoolSettings &settings)
+    : backend_(std::move(backend)), settings_(settings),
+      id_(next_pool_id++), hits_(0), misses_(0), bytes_cached_(0),
+      bytes_reserved_(0), peak_bytes_reserved_(0) {
+  settings_.min_block_size =
+      round_up_power_of_two(std::max<size_t>(settings_.min_block_size, 1));
+  settings_.max_block_size = round_up_power_of_two(
+      std::max(settings_.max_block_size, settings_.min_block_size));
+  settings_.chunk_size = round_up_power_of_two(
+      std::max(settings_.chunk_size, settings_.max_block_size));
+  class_count_ = log2_of_power_of_two(settings_.max_block_size) -
+                 log2_of_power_of_two(settings_.min_block_size) + 1;
+  free_blocks_.resize(class_count_);
+}
+
+UsmPool::~UsmPool() {
+  for (auto &chunk : chunks_) {
+    backend_->free(chunk->base);
+  }
+  for (auto &live : live_) {
+    for (auto &entry : live.blocks) {
+      if (!entry.second.chunk)
+        backend_->free(entry.second.ptr);
+    }
+  }
+}
+
+size_t UsmPool::size_class_index(size_t size, size_t alignment) const {
+  const size_t needed =
+      std::max(std::max(size, alignment), settings_.min_block_size);
+  if (!is_power_of_two(alignment) || (needed > settings_.max_block_size))
+    return class_count_;
+  return log2_of_power_of_two(round_up_power_of_two(needed)) -
+         log2_of_power_of_two(settings_.min_block_size);
+}
+
+size_t UsmPool::size_class(size_t index) const {
+  return settings_.min_block_size << index;
+}
+
+UsmPool::LiveShard &UsmPool::shard(const void *ptr) const {
+  // Blocks are at least min_block_size apart, skip the bits they share
+  const size_t hash = std::hash<const void *>()(ptr) /
+                      static_cast<size_t>(settings_.min_block_size);
+  return live_[hash % live_shard_count];
+}
+
+UsmPool::ThreadCache &UsmPool::thread_cache() {
+  static thread_local std::unordered_map<uint64_t, ThreadCache *> caches;
+
+  auto found = caches.find(id_);
+  if (found != caches.end())
+    return *found->second;
+
+  std::unique_ptr<ThreadCache> cache(new ThreadCache);
+  cache->free_blocks.resize(class_count_);
+  ThreadCache *result = cache.get();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    caches_.push_back(std::move(cache));
+  }
+  caches[id_] = result;
+  return *result;
+}
+
+void UsmPool::add_reserved(uint64_t size) {
+  const uint64_t reserved = (bytes_reserved_ += size);
+  uint64_t peak = peak_bytes_reserved_.load();
+  while ((reserved > peak) &&
+         !peak_bytes_reserved_.compare_exchange_weak(peak, reserved)) {
+  }
+}
+
+// Called with mutex_ held
+bool UsmPool::add_chunk(size_t index) {
+  const size_t block_size = size_class(index);
+  void *base = backend_->allocate(settings_.chunk_size, block_size);
+  if (!base)
+    return false;
+
+  std::unique_ptr<Chunk> chunk(new Chunk);
+  chunk->base = base;
+  chunk->index = index;
+  for (size_t offset = 0; offset < settings_.chunk_size;
+       offset += block_size) {
+    Block block = {static_cast<char *>(base) + offset, chunk.get(),
+                   block_size};
+    free_blocks_[index].push_back(block);
+  }
+  chunks_.push_back(std::move(chunk));
+
+  bytes_cached_ += settings_.chunk_size;
+  add_reserved(settings_.chunk_size);
+  return true;
+}
+
+bool UsmPool::pop_shared(size_t index, Block &block, bool &missed) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  missed = free_blocks_[index].empty();
+  if (missed && !add_chunk(index))
+    return false;
+
+  block = free_blocks_[index].back();
+  free_blocks_[index].pop_back();
+  return true;
+}
+
+void UsmPool::push_shared(FreeList &blocks) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &block : blocks) {
+    free_blocks_[block.chunk->index].push_back(block);
+  }
+}
+
+void *UsmPool::allocate(size_t size, size_t alignment) {
+  size = std::max<size_t>(size, 1);
+  alignment = std::max<size_t>(alignment, 1);
+  const size_t index = size_class_index(size, alignment);
+
+  Block block = {nullptr, nullptr, size};
+  if (index == class_count_) {
+    block.ptr = backend_->allocate(size, alignment);
+    if (!block.ptr)
+      return nullptr;
+    misses_++;
+    add_reserved(size);
+  } else {
+    ThreadCache &cache = thread_cache();
+    {
+      std::lock_guard<std::mutex> lock(cache.mutex);
+      FreeList &cached = cache.free_blocks[index];
+      if (!cached.empty()) {
+        block = cached.back();
+        cached.pop_back();
+      }
+    }
+
+    if (block.ptr) {
+      hits_++;
+    } else {
+      bool missed = false;
+      if (!pop_shared(index, block, missed))
+        return nullptr;
+      (missed ? misses_ : hits_)++;
+    }
+    bytes_cached_ -= block.size;
+  }
+
+  LiveShard &live = shard(block.ptr);
+  std::lock_guard<std::mutex> lock(live.mutex);
+  live.blocks[block.ptr] = block;
+  return block.ptr;
+}
+
+bool UsmPool::free(void *ptr) {
+  Block block;
+  {
+    LiveShard &live = shard(ptr);
+    std::lock_guard<std::mutex> lock(live.mutex);
+    auto found = live.blocks.find(ptr);
+    if (found == live.blocks.end())
+      return false;
+    block = found->second;
+    live.blocks.erase(found);
+  }
+
+  if (!block.chunk) {
+    backend_->free(block.ptr);
+    bytes_reserved_ -= block.size;
+    return true;
+  }
+
+  bytes_cached_ += block.size;
+  FreeList overflow;
+  {
+    ThreadCache &cache = thread_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    FreeList &cached = cache.free_blocks[block.chunk->index];
+    cached.push_back(block);
+    if (cached.size() > settings_.thread_cache_blocks) {
+      const size_t keep = cached.size() / 2;
+      overflow.assign(cached.begin() + keep, cached.end());
+      cached.resize(keep);
+    }
+  }
+  if (!overflow.empty())
+    push_shared(overflow);
+  return true;
+}
+
+bool UsmPool::owns(const void *ptr) const {
+  LiveShard &live = shard(ptr);
+  std::lock_guard<std::mutex> lock(live.mutex);
+  return live.blocks.count(ptr) != 0;
+}
+
+// A chunk is unused when every one of its blocks is on a shared free list.
+// Blocks freed into a thread cache after it was drained keep their chunk.
+void UsmPool::trim() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (auto &cache : caches_) {
+    std::lock_guard<std::mutex> cache_lock(cache->mutex);
+    for (auto &cached : cache->free_blocks) {
+      for (auto &block : cached) {
+        free_blocks_[block.chunk->index].push_back(block);
+      }
+      cached.clear();
+    }
+  }
+
+  std::unordered_map<Chunk *, size_t> free_counts;
+  for (auto &free_list : free_blocks_) {
+    for (auto &block : free_list) {
+      free_counts[block.chunk]++;
+    }
+  }
+
+  std::vector<std::unique_ptr<Chunk>> kept;
+  for (auto &chunk : chunks_) {
+    const size_t blocks = settings_.chunk_size / size_class(chunk->index);
+    if (free_counts[chunk.get()] == blocks) {
+      Chunk *unused = chunk.get();
+      FreeList &free_list = free_blocks_[unused->index];
+      free_list.erase(std::remove_if(free_list.begin(), free_list.end(),
+                                     [unused](const Block &block) {
+                                       return block.chunk == unused;
+                                     }),
+                      free_list.end());
+      backend_->free(unused->base);
+      bytes_cached_ -= settings_.chunk_size;
+      bytes_reserved_ -= settings_.chunk_size;
+    } else {
+      kept.push_back(std::move(chunk));
+    }
+  }
+  chunks_.swap(kept);
+}
+
+UsmPoolStatistics UsmPool::statistics() const {
+  UsmPoolStatistics statistics;
+  statistics.hits = hits_;
+  statistics.misses = misses_;
+  statistics.bytes_cached = bytes_cached_;
+  statistics.bytes_reserved = bytes_reserved_;
+  statistics.peak_bytes_reserved = peak_bytes_reserved_;
+  return statistics;
+}
+
+bool usm_pool_requested() {
+  static const bool requested = [] {
+    const char *value = getenv("LZT_USM_POOL");
+    return (value != nullptr) && (strcmp(value, "1") == 0);
+  }();
+  return requested;
+}
+
+namespace {
+
+typedef std::tuple<int, ze_driver_handle_t, ze_device_handle_t, uint32_t, int,
+                   int>
+    PoolKey;
+
+struct PoolRegistry {
+  std::mutex mutex;
+  std::map<PoolKey, std::unique_ptr<UsmPool>> pools;
+};
+
+// Never destroyed, the driver may already be gone when static destructors
+// run and it reclaims the memory at exit anyway
+PoolRegistry &registry() {
+  static PoolRegistry *pools = new PoolRegistry;
+  return *pools;
+}
+
+} // namespace
+
+UsmPool &get_usm_pool(ze_memory_type_t type, ze_driver_handle_t driver,
+                      ze_device_handle_t device, uint32_t ordinal,
+                      ze_device_mem_alloc_flag_t device_flags,
+                      ze_host_mem_alloc_flag_t host_flags) {
+  // Host allocations do not depend on the device
+  if (type == ZE_MEMORY_TYPE_HOST) {
+    device = nullptr;
+    ordinal = 0;
+    device_flags = ZE_DEVICE_MEM_ALLOC_FLAG_DEFAULT;
+  }
+  const PoolKey key(type, driver, device, ordinal, device_flags, host_flags);
+
+  PoolRegistry &pools = registry();
+  std::lock_guard<std::mutex> lock(pools.mutex);
+  std::unique_ptr<UsmPool> &pool = pools.pools[key];
+  if (!pool) {
+    pool.reset(new UsmPool(std::unique_ptr<UsmBackend>(new ZeUsmBackend(
+        type, driver, device, ordinal, device_flags, host_flags))));
+  }
+  return *pool;
+}
+
+bool usm_pool_free(const void *ptr) {
+  // Pools are never removed, so they can be used outside the lock and frees
+  // from different threads only contend inside the owning pool
+  std::vector<UsmPool *> candidates;
+  {
+    PoolRegistry &pools = registry();
+    std::lock_guard<std::mutex> lock(pools.mutex);
+    for (auto &entry : pools.pools) {
+      candidates.push_back(entry.second.get());
+    }
+  }
+  for (auto pool : candidates) {
+    if (pool->free(const_cast<void *>(ptr)))
+      return true;
+  }
+  return false;
+}
+
+void trim_usm_pools() {
+  PoolRegistry &pools = registry();
+  std::lock_guard<std::mutex> lock(pools.mutex);
+  for (auto &entry : pools.pools) {
+    entry.second->trim();
+  }
+}
+
+} // namespace level_zero_tests
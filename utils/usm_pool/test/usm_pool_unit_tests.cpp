@@ -0,0 +1,233 @@
+/*
+ *
+ * Copyright (C) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "usm_pool/usm_pool.hpp"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace lzt = level_zero_tests;
+
+namespace {
+
+// Shared with the test so it outlives the pool that owns the backend
+struct MockBackendState {
+  std::mutex mutex;
+  std::map<void *, std::vector<char>> allocations;
+  std::vector<std::pair<size_t, size_t>> requests;
+  size_t frees = 0;
+  bool fail = false;
+};
+
+class MockBackend : public lzt::UsmBackend {
+public:
+  explicit MockBackend(std::shared_ptr<MockBackendState> state)
+      : state_(state) {}
+
+  void *allocate(size_t size, size_t alignment) override {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->requests.push_back(std::make_pair(size, alignment));
+    if (state_->fail)
+      return nullptr;
+
+    std::vector<char> storage(size + alignment);
+    uintptr_t address = reinterpret_cast<uintptr_t>(storage.data());
+    address = (address + alignment - 1) / alignment * alignment;
+    void *ptr = reinterpret_cast<void *>(address);
+    state_->allocations[ptr].swap(storage);
+    return ptr;
+  }
+
+  void free(void *ptr) override {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    EXPECT_EQ(1u, state_->allocations.erase(ptr));
+    state_->frees++;
+  }
+
+private:
+  std::shared_ptr<MockBackendState> state_;
+};
+
+class UsmPoolTests : public ::testing::Test {
+protected:
+  void SetUp() override {
+    state = std::make_shared<MockBackendState>();
+    settings.min_block_size = 64;
+    settings.max_block_size = 4096;
+    settings.chunk_size = 16384;
+    settings.thread_cache_blocks = 4;
+    pool.reset(new lzt::UsmPool(
+        std::unique_ptr<lzt::UsmBackend>(new MockBackend(state)), settings));
+  }
+
+  size_t backend_allocations() { return state->requests.size(); }
+
+  std::shared_ptr<MockBackendState> state;
+  lzt::UsmPoolSettings settings;
+  std::unique_ptr<lzt::UsmPool> pool;
+};
+
+TEST_F(UsmPoolTests, SmallAllocationsShareOneChunk) {
+  void *first = pool->allocate(100, 1);
+  void *second = pool->allocate(100, 1);
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, second);
+  EXPECT_NE(first, second);
+
+  ASSERT_EQ(1u, backend_allocations());
+  EXPECT_EQ(settings.chunk_size, state->requests[0].first);
+  EXPECT_EQ(128u, state->requests[0].second);
+
+  const lzt::UsmPoolStatistics statistics = pool->statistics();
+  EXPECT_EQ(1u, statistics.misses);
+  EXPECT_EQ(1u, statistics.hits);
+  EXPECT_EQ(settings.chunk_size, statistics.bytes_reserved);
+  EXPECT_EQ(settings.chunk_size - 2 * 128, statistics.bytes_cached);
+}
+
+TEST_F(UsmPoolTests, FreedBlockIsReused) {
+  void *first = pool->allocate(1000, 1);
+  EXPECT_TRUE(pool->free(first));
+  void *second = pool->allocate(1000, 1);
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(1u, backend_allocations());
+  EXPECT_EQ(0u, state->frees);
+}
+
+TEST_F(UsmPoolTests, AlignmentIsHonored) {
+  for (size_t alignment = 1; alignment <= settings.max_block_size;
+       alignment *= 2) {
+    void *ptr = pool->allocate(1, alignment);
+    ASSERT_NE(nullptr, ptr);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(ptr) % alignment);
+  }
+}
+
+TEST_F(UsmPoolTests, LargeAllocationsBypassThePool) {
+  const size_t size = settings.max_block_size + 1;
+  void *ptr = pool->allocate(size, 8);
+  ASSERT_NE(nullptr, ptr);
+  ASSERT_EQ(1u, backend_allocations());
+  EXPECT_EQ(size, state->requests[0].first);
+  EXPECT_EQ(8u, state->requests[0].second);
+  EXPECT_EQ(size, pool->statistics().bytes_reserved);
+
+  EXPECT_TRUE(pool->free(ptr));
+  EXPECT_EQ(1u, state->frees);
+  EXPECT_EQ(0u, pool->statistics().bytes_reserved);
+  EXPECT_EQ(size, pool->statistics().peak_bytes_reserved);
+}
+
+TEST_F(UsmPoolTests, NonPowerOfTwoAlignmentsBypassThePool) {
+  void *ptr = pool->allocate(64, 48);
+  ASSERT_NE(nullptr, ptr);
+  ASSERT_EQ(1u, backend_allocations());
+  EXPECT_EQ(64u, state->requests[0].first);
+  EXPECT_EQ(48u, state->requests[0].second);
+  EXPECT_TRUE(pool->free(ptr));
+}
+
+TEST_F(UsmPoolTests, UnknownPointersAreNotFreed) {
+  int local = 0;
+  void *ptr = pool->allocate(64, 1);
+
+  EXPECT_FALSE(pool->free(&local));
+  EXPECT_TRUE(pool->owns(ptr));
+  EXPECT_TRUE(pool->free(ptr));
+  EXPECT_FALSE(pool->owns(ptr));
+  EXPECT_FALSE(pool->free(ptr));
+}
+
+TEST_F(UsmPoolTests, BackendFailureReturnsNull) {
+  state->fail = true;
+  EXPECT_EQ(nullptr, pool->allocate(64, 1));
+  EXPECT_EQ(nullptr, pool->allocate(settings.max_block_size * 2, 1));
+  EXPECT_EQ(0u, pool->statistics().bytes_reserved);
+}
+
+TEST_F(UsmPoolTests, TrimReleasesOnlyUnusedChunks) {
+  const size_t blocks_per_chunk = settings.chunk_size / 64;
+  std::vector<void *> ptrs;
+  for (size_t i = 0; i < 2 * blocks_per_chunk; i++) {
+    ptrs.push_back(pool->allocate(64, 1));
+  }
+  ASSERT_EQ(2u, backend_allocations());
+
+  // Keep one block of the first chunk in use
+  for (size_t i = 1; i < ptrs.size(); i++) {
+    EXPECT_TRUE(pool->free(ptrs[i]));
+  }
+  pool->trim();
+  EXPECT_EQ(1u, state->frees);
+  EXPECT_EQ(settings.chunk_size, pool->statistics().bytes_reserved);
+
+  EXPECT_TRUE(pool->free(ptrs[0]));
+  pool->trim();
+  EXPECT_EQ(2u, state->frees);
+
+  const lzt::UsmPoolStatistics statistics = pool->statistics();
+  EXPECT_EQ(0u, statistics.bytes_reserved);
+  EXPECT_EQ(0u, statistics.bytes_cached);
+  EXPECT_EQ(2 * settings.chunk_size, statistics.peak_bytes_reserved);
+}
+
+TEST_F(UsmPoolTests, DestroyingThePoolReleasesEverything) {
+  pool->allocate(64, 1);
+  pool->allocate(settings.max_block_size * 2, 1);
+  pool.reset();
+  EXPECT_TRUE(state->allocations.empty());
+}
+
+TEST_F(UsmPoolTests, ThreadsGetDistinctBlocks) {
+  const int thread_count = 4;
+  const int allocations = 200;
+  std::vector<std::vector<void *>> ptrs(thread_count);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_count; t++) {
+    threads.push_back(std::thread([&, t] {
+      for (int i = 0; i < allocations; i++) {
+        ptrs[t].push_back(pool->allocate(64 << (i % 3), 1));
+        // Free every other allocation to churn the thread caches
+        if (i % 2) {
+          pool->free(ptrs[t].back());
+          ptrs[t].pop_back();
+        }
+      }
+    }));
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::set<void *> unique;
+  for (auto &thread_ptrs : ptrs) {
+    for (auto ptr : thread_ptrs) {
+      ASSERT_NE(nullptr, ptr);
+      EXPECT_TRUE(unique.insert(ptr).second);
+    }
+  }
+
+  for (auto &thread_ptrs : ptrs) {
+    for (auto ptr : thread_ptrs) {
+      EXPECT_TRUE(pool->free(ptr));
+    }
+  }
+  pool->trim();
+  EXPECT_EQ(0u, pool->statistics().bytes_reserved);
+  EXPECT_TRUE(state->allocations.empty());
+}
+
+} // namespace